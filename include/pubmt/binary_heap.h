@@ -10,21 +10,47 @@ typedef void (*pmt_bh_swap_t)(void *element_a, void *element_b);
 /** Is element_a less than element_b? */
 typedef bool (*pmt_bh_less_than_t)(void *element_a, void *element_b);
 
-/** Binary Heap Interface */
+/** Record that the element now lives at 'index' within the heap. */
+typedef void (*pmt_bh_set_index_t)(void *element, const size_t index);
+
+/** 
+ * Binary Heap Interface 
+ *
+ * The optional 'get_arity' callback turns the heap into a d-ary heap.  With 
+ * an arity of 4 or 8, the children of a node are adjacent and often share a 
+ * cache line, and the tree is half or a third as deep.  When the callback is 
+ * NULL, the heap is binary.
+ *
+ * The 'get_swap' callback is optional.  When it is NULL, elements are sifted
+ * by moving parents or children into a hole with a single memcpy each and 
+ * writing the sifted element once, which moves fewer bytes than swapping and
+ * saves an indirect call per level.
+ *
+ * The optional 'get_set_index' callback makes the heap indexed.  Every time an
+ * element is placed, its new index is reported, so that it can later be 
+ * reprioritized with pmt_bh_update or cancelled with pmt_bh_remove_at.
+ */
 typedef struct pmt_bh_iface {
 
         pmt_da_iface_t array_iface;
 
+        /* optional */
         pmt_bh_swap_t (*get_swap)(void *heap);
 
         pmt_bh_less_than_t (*get_less_than)(void *heap);
 
+        /* number of children per node, at least 2 (optional) */
+        size_t (*get_arity)(void *heap);
+
+        /* optional */
+        pmt_bh_set_index_t (*get_set_index)(void *heap);
+
 } pmt_bh_iface_t;
 
 /**
  * Validate the binary heap interface. 
  * 
- * @returns Will return 'false' if any callbacks are NULL.
+ * @returns Will return 'false' if any required callbacks are NULL.
  */
 bool pmt_bh_iface_validate(pmt_bh_iface_t *iface);
 
@@ -52,4 +78,89 @@ bool pmt_bh_pop(pmt_bh_iface_t *iface, void *heap, void *element);
  */
 void *pmt_bh_peek(pmt_bh_iface_t *iface, void *heap);
 
+/**
+ * Restore the heap order after the priority of the element at 'index' was
+ * changed in place, sifting it up or down O(log n).  Without a swap callback,
+ * the heap's buffer must be able to hold one extra element as scratch space,
+ * so the buffer may be resized.
+ *
+ * @returns A pointer to the element's new position is returned.  A value of 
+ * 'NULL' indicates that 'index' was out of bounds or a memory allocation 
+ * failure.
+ */
+void *pmt_bh_update(pmt_bh_iface_t *iface, void *heap, const size_t index);
+
+/**
+ * Remove the element at 'index' from the heap O(log n).  If 'element' is not
+ * 'NULL', then it will receive the contents of the removed element.
+ *
+ * @returns A value of 'false' is returned if 'index' is out of bounds.
+ */
+bool pmt_bh_remove_at(
+        pmt_bh_iface_t *iface,
+        void *heap,
+        const size_t index,
+        void *element);
+
+/**
+ * Restore the heap order over the current contents of the heap's dynamic 
+ * array O(n).  This adopts elements that were placed in the array directly.
+ * Without a swap callback, the buffer may be resized to hold one extra 
+ * element as scratch space.
+ *
+ * @returns A value of 'false' indicates a memory allocation failure.
+ */
+bool pmt_bh_heapify(pmt_bh_iface_t *iface, void *heap);
+
+/**
+ * Replace the contents of the heap with copies of the 'nelems' elements and
+ * heapify them bottom-up O(n).
+ *
+ * @returns A value of 'false' indicates a memory allocation failure.
+ */
+bool pmt_bh_build(
+        pmt_bh_iface_t *iface, 
+        void *heap, 
+        void *elements, 
+        const size_t nelems);
+
+/**
+ * Insert copies of the 'nelems' elements into the heap.  Small batches are 
+ * sifted up one at a time, batches that are large relative to the heap cause
+ * the whole heap to be rebuilt in O(n).  The buffer is resized at most once.
+ *
+ * @returns A value of 'false' indicates a memory allocation failure.
+ */
+bool pmt_bh_insert_many(
+        pmt_bh_iface_t *iface, 
+        void *heap, 
+        void *elements, 
+        const size_t nelems);
+
+/**
+ * Insert 'element' and pop the minimal/maximal element with a single sift 
+ * O(log n).  If 'element' would be the new root, the heap is unchanged.  If
+ * 'out' is not 'NULL', then it will receive the contents of the popped 
+ * element.  The 'element' and 'out' regions must not overlap.
+ */
+void pmt_bh_pushpop(
+        pmt_bh_iface_t *iface, 
+        void *heap, 
+        void *element, 
+        void *out);
+
+/**
+ * Pop the minimal/maximal element and insert 'element' with a single sift
+ * O(log n).  If 'out' is not 'NULL', then it will receive the contents of the
+ * popped element.  The 'element' and 'out' regions must not overlap.
+ *
+ * @returns A value of 'false' is returned if the heap is empty, in which case
+ * 'element' is not inserted.
+ */
+bool pmt_bh_replace_top(
+        pmt_bh_iface_t *iface, 
+        void *heap, 
+        void *element, 
+        void *out);
+
 #endif
\ No newline at end of file
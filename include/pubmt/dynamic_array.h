@@ -44,14 +44,31 @@ typedef struct pmt_da_iface {
         void *(*get_buffer)(void *array);
         void (*set_buffer)(void *array, void *buffer_ptr);
 
+        /* optional inline storage, both may be NULL */
+        void *(*get_inline_buffer)(void *array);
+        size_t (*get_inline_capacity)(void *array);
+
 } pmt_da_iface_t;
 
 /**
  * Validate the dynamic array interface. 
- * @returns Will return 'false' if any callbacks are NULL.
+ * @returns Will return 'false' if any callbacks are NULL.  The inline storage
+ * callbacks are optional, but must be both NULL or both non-NULL.
  */
 bool pmt_da_iface_validate(pmt_da_iface_t *iface);
 
+/**
+ * Does the array have inline storage, i.e. a region embedded within the array
+ * itself that holds the first elements before spilling to the allocator?
+ */
+bool pmt_da_has_inline(pmt_da_iface_t *iface, void *array);
+
+/**
+ * Is the array's buffer currently its inline storage?  The inline region is 
+ * never passed to the realloc or free callbacks.
+ */
+bool pmt_da_is_inline(pmt_da_iface_t *iface, void *array);
+
 /** 
  * Initialize the dynamic array with the given buffer and initial capacity. 
  * 
@@ -65,7 +82,9 @@ void *pmt_da_init(
         const size_t initial_capacity);
 
 /** 
- * Create a new dynamic array with the given initial capacity.
+ * Create a new dynamic array with the given initial capacity.  If the array 
+ * has inline storage large enough for 'initial_capacity' elements, then the 
+ * inline region is used and no memory is allocated.
  * 
  * @returns A pointer to 'array' or NULL if memory allocation failed.
  */
@@ -75,7 +94,8 @@ void *pmt_da_create(
         const size_t initial_capacity);
 
 /** 
- * Destroy the dynamic array, freeing its internal buffer.
+ * Destroy the dynamic array, freeing its internal buffer unless it is the
+ * inline region.
  */    
 void pmt_da_destroy(pmt_da_iface_t *iface, void *array);
 
@@ -113,7 +133,10 @@ bool pmt_da_is_empty(pmt_da_iface_t *iface, void *array);
 void *pmt_da_at(pmt_da_iface_t *iface, void *array, const size_t index);
 
 /** 
- * Resize the array, ensuring it can hold new_capacity elements.
+ * Resize the array, ensuring it can hold new_capacity elements.  Arrays with 
+ * inline storage spill to the allocator when 'new_capacity' exceeds the 
+ * inline capacity, and move back into the inline region when it fits again, 
+ * so the capacity never drops below the inline capacity.
  * 
  * @returns A value of 'false' is returned if there was a memory allocation 
  * error.
@@ -161,6 +184,52 @@ bool pmt_da_scale_capacity(
  */
 void *pmt_da_push_back(pmt_da_iface_t *iface, void *array, void *element);
 
+/**
+ * Push nelems uninitialized elements onto the end of the array, growing the 
+ * internal buffer at most once.  The caller is expected to fill the region.
+ * Pushing zero elements cannot fail and leaves the array unmodified.
+ * 
+ * @returns A pointer to the first pushed element is returned.  A value of 
+ * 'NULL' indicates a memory allocation failure.  For zero elements the end
+ * of the buffer is returned, which is 'NULL' for an array without a buffer,
+ * so callers that may push nothing should test nelems rather than the
+ * pointer.
+ */
+void *pmt_da_push_back_n(
+        pmt_da_iface_t *iface, 
+        void *array, 
+        const size_t nelems);
+
+/**
+ * Append nelems elements onto the end of the array with a single copy, 
+ * growing the internal buffer at most once.  Appending zero elements always
+ * succeeds, 'elements' may then be NULL.
+ * 
+ * @returns A value of 'false' indicates a memory allocation failure, in 
+ * which case the array is left unmodified.
+ */
+bool pmt_da_append_range(
+        pmt_da_iface_t *iface, 
+        void *array, 
+        void *elements, 
+        const size_t nelems);
+
+/**
+ * Push nelems elements onto the end of the array, growing the internal 
+ * buffer at most once, then call 'init' once to construct the pushed region
+ * in place.  For zero elements 'init' is not called.
+ * 
+ * @returns A pointer to the first pushed element is returned.  A value of 
+ * 'NULL' indicates a memory allocation failure, in which case 'init' is not
+ * called.  For zero elements the result is that of pmt_da_push_back_n.
+ */
+void *pmt_da_emplace_back_n(
+        pmt_da_iface_t *iface, 
+        void *array, 
+        const size_t nelems,
+        void (*init)(void *elements, const size_t nelems, void *state),
+        void *state);
+
 /**
  * Remove the last element from the array.  If element is not NULL, then it 
  * will receive a copy of the popped elements contents.
@@ -186,7 +255,8 @@ void *pmt_da_first(pmt_da_iface_t *iface, void *array);
 void *pmt_da_last(pmt_da_iface_t *iface, void *array);
 
 /**
- * Insert nelems elements at the given index. 
+ * Insert nelems elements at the given index.  An index equal to the array's
+ * size appends the elements.
  * 
  * @returns A value of false is returned if the allocator ran out of memory.
  */
@@ -0,0 +1,111 @@
+#ifndef PUBMT_EXTERNAL_SORT_H
+#define PUBMT_EXTERNAL_SORT_H
+
+#include "pubmt/sort.h"
+
+/**
+ * Read up to nelems elements into 'elements', storing the number read in 
+ * 'nread'.  Reading zero elements signals the end of the input.
+ *
+ * @returns A value of 'false' indicates a read error.
+ */
+typedef bool (*pmt_es_read_t)(
+        void *elements, 
+        const size_t nelems, 
+        size_t *nread, 
+        void *state);
+
+/**
+ * Write nelems elements.
+ *
+ * @returns A value of 'false' indicates a write error.
+ */
+typedef bool (*pmt_es_write_t)(
+        void *elements, 
+        const size_t nelems, 
+        void *state);
+
+/** External Sort Configuration */
+typedef struct pmt_es_config {
+
+        pmt_da_less_than_t less_than;
+
+        /* input */
+        pmt_es_read_t read;
+        void *read_state;
+
+        /* output */
+        pmt_es_write_t write;
+        void *write_state;
+
+        /* directory for run files, "/tmp" when NULL */
+        const char *directory;
+
+        /* minimum bytes of read buffer per run, bounds the merge fan in */
+        size_t merge_buffer_size;
+
+} pmt_es_config_t;
+
+/** File Descriptor Reader/Writer State */
+typedef struct pmt_es_fd {
+
+        int fd;
+
+        size_t element_size;
+
+} pmt_es_fd_t;
+
+/** Error Codes */
+enum pmt_es_error {
+        PMT_ES_SUCCESS                  = 0,
+        PMT_ES_ALLOC                    = -1,
+        PMT_ES_IO                       = -2,
+        PMT_ES_READ                     = -3,
+        PMT_ES_WRITE                    = -4
+};
+
+/**
+ * Sort an input of any length in bounded memory.  The array's capacity is 
+ * the memory budget: the array is repeatedly filled to capacity, sorted with
+ * pmt_da_sort and written to an unlinked run file.  The runs are then k-way 
+ * merged with a pmt_bh of run cursors, each run being streamed through its 
+ * own large pread buffer carved out of the array's buffer.  When there are 
+ * more runs than fit in the budget, runs are first merged into longer runs.
+ * An input that fits in the array, even exactly, is sorted without touching
+ * the disk.
+ *
+ * The array must be able to hold at least three elements and its contents 
+ * are clobbered.  Small bookkeeping allocations use the array's allocator.
+ *
+ * @returns 
+ *      PMT_ES_SUCCESS - The sorted output was written.
+ *      PMT_ES_ALLOC - Memory allocation failed or the array was too small.
+ *      PMT_ES_IO - A run file could not be created, written or read.
+ *      PMT_ES_READ - The read callback failed.
+ *      PMT_ES_WRITE - The write callback failed.
+ */
+int pmt_es_sort(
+        pmt_da_iface_t *iface, 
+        void *array, 
+        pmt_es_config_t *config);
+
+/**
+ * Read elements from the file descriptor of a pmt_es_fd_t state.
+ * 
+ * @returns A value of 'false' indicates a read error or a trailing partial 
+ * element.
+ */
+bool pmt_es_fd_read(
+        void *elements, 
+        const size_t nelems, 
+        size_t *nread, 
+        void *state);
+
+/**
+ * Write elements to the file descriptor of a pmt_es_fd_t state.
+ * 
+ * @returns A value of 'false' indicates a write error.
+ */
+bool pmt_es_fd_write(void *elements, const size_t nelems, void *state);
+
+#endif
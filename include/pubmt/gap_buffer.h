@@ -0,0 +1,118 @@
+#ifndef PUBMT_GAP_BUFFER_H
+#define PUBMT_GAP_BUFFER_H
+
+#include "pubmt/dynamic_array.h"
+
+/**
+ * Gap Buffer Interface
+ *
+ * The embedded dynamic array's size is the number of elements and its unused
+ * capacity is the gap.  Elements before the gap are stored at the start of
+ * the buffer and elements after the gap are stored at its end, so inserting
+ * or removing at the gap costs O(1) and moving the gap costs O(distance).
+ */
+typedef struct pmt_gb_iface {
+
+        pmt_da_iface_t array_iface;
+
+        /* index of the gap, which is the edit cursor */
+        size_t (*get_gap)(void *buffer);
+        void (*set_gap)(void *buffer, const size_t gap);
+
+} pmt_gb_iface_t;
+
+/**
+ * Validate the gap buffer interface.
+ *
+ * @returns Will return 'false' if any callbacks are NULL.
+ */
+bool pmt_gb_iface_validate(pmt_gb_iface_t *iface);
+
+/**
+ * Create a new gap buffer with the given initial capacity.
+ *
+ * @returns A pointer to 'buffer' or NULL if memory allocation failed.
+ */
+void *pmt_gb_create(
+        pmt_gb_iface_t *iface,
+        void *buffer,
+        const size_t initial_capacity);
+
+/**
+ * Destroy the gap buffer, freeing its internal buffer.
+ */
+void pmt_gb_destroy(pmt_gb_iface_t *iface, void *buffer);
+
+/**
+ * Get the number of elements, excluding the gap O(1).
+ */
+size_t pmt_gb_size(pmt_gb_iface_t *iface, void *buffer);
+
+/**
+ * Get the element at the given index, skipping over the gap O(1).
+ *
+ * @returns A pointer to the element is returned.  If the 'index' is out of
+ * bounds, then NULL is returned instead.
+ */
+void *pmt_gb_at(pmt_gb_iface_t *iface, void *buffer, const size_t index);
+
+/**
+ * Move the gap so that it sits immediately before the element at 'index'
+ * O(distance).
+ *
+ * @returns A value of 'false' is returned if 'index' is out of bounds.
+ */
+bool pmt_gb_move_gap(pmt_gb_iface_t *iface, void *buffer, const size_t index);
+
+/**
+ * Ensure the gap can hold at least nelems elements.  Growing the buffer 
+ * moves the elements after the gap to the end of the new buffer.
+ *
+ * @returns A value of 'false' is returned if there was a memory allocation
+ * error.
+ */
+bool pmt_gb_reserve(pmt_gb_iface_t *iface, void *buffer, const size_t nelems);
+
+/**
+ * Insert nelems elements at the given index, moving the gap there first.
+ * Repeated inserts at or near the same index are O(1) amortized per element.
+ * If 'elements' is NULL, the inserted region is left uninitialized.
+ *
+ * @returns A pointer to the inserted region, or NULL if 'index' is out of
+ * bounds or there was a memory allocation error.
+ */
+void *pmt_gb_insert(
+        pmt_gb_iface_t *iface,
+        void *buffer,
+        const size_t index,
+        void *elements,
+        const size_t nelems);
+
+/**
+ * Remove nelems elements starting at the given index, moving the gap there
+ * first.  The removed elements are absorbed by the gap.
+ *
+ * @returns A value of false is returned if the operation would have otherwise
+ * gone out of bounds, indicating no modifications were made to the buffer.
+ */
+bool pmt_gb_remove(
+        pmt_gb_iface_t *iface,
+        void *buffer,
+        const size_t index,
+        const size_t nelems);
+
+/**
+ * Make the nelems elements starting at 'index' contiguous, moving the gap
+ * out of the range if necessary, whichever way moves fewer elements.  The
+ * span remains valid until the buffer is modified or its gap is moved.
+ *
+ * @returns A pointer to the first element of the span, or NULL if the range
+ * is out of bounds.
+ */
+void *pmt_gb_span(
+        pmt_gb_iface_t *iface,
+        void *buffer,
+        const size_t index,
+        const size_t nelems);
+
+#endif
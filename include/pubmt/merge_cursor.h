@@ -0,0 +1,166 @@
+#ifndef PUBMT_MERGE_CURSOR_H
+#define PUBMT_MERGE_CURSOR_H
+
+#include "pubmt/binary_heap.h"
+#include "pubmt/sort.h"
+
+/**
+ * Pull up to nelems sorted elements of a run into 'elements', storing the
+ * number pulled in 'nread'.  Pulling zero elements signals the end of the
+ * run.  The merge cursor itself has this signature, see pmt_mc_read.
+ *
+ * @returns A value of 'false' indicates a pull error, 'nread' is then ignored.
+ */
+typedef bool (*pmt_mc_pull_t)(
+        void *elements,
+        const size_t nelems,
+        size_t *nread,
+        void *state);
+
+/** Sorted input of a merge cursor. */
+typedef struct pmt_mc_run {
+
+        pmt_da_less_than_t less_than;
+
+        /* the unconsumed elements of the current batch */
+        uint8_t *current, *end;
+
+        /* batch buffer of a pulled run, NULL for an array run */
+        uint8_t *buffer;
+
+        pmt_mc_pull_t pull;
+        void *pull_state;
+
+        /* order in which the run was added, breaks ties */
+        size_t index;
+
+} pmt_mc_run_t;
+
+struct pmt_mc_cursor;
+
+/** Binary heap of run pointers, ordered by their current elements. */
+typedef struct pmt_mc_heap {
+
+        struct pmt_mc_cursor *cursor;
+
+        void *buffer;
+
+        size_t size, capacity;
+
+} pmt_mc_heap_t;
+
+/**
+ * K-Way Merge Cursor
+ *
+ * Streams the elements of several sorted runs in global order.  A run is
+ * either a sorted dynamic array, which is read in place, or a pull callback,
+ * which is refilled a whole batch at a time into the run's own buffer.  The
+ * runs are kept in a pmt_bh ordered by their current elements.  Taking an
+ * element advances its run in place and sifts the run down from the root,
+ * so the heap is only popped when a run ends.  The merge is stable, equal
+ * elements come out in the order their runs were added.
+ */
+typedef struct pmt_mc_cursor {
+
+        pmt_mc_run_t *runs;
+
+        size_t nruns, max_runs, element_size, batch;
+
+        pmt_da_less_than_t less_than;
+
+        pmt_mc_heap_t heap;
+
+        /* set when a pull callback fails */
+        bool failed;
+
+        pmt_da_alloc_t alloc;
+        pmt_da_realloc_t realloc;
+        pmt_da_free_t free;
+        void *alloc_state;
+
+} pmt_mc_cursor_t;
+
+/**
+ * Create a cursor for up to 'max_runs' runs of elements of 'element_size'
+ * bytes ordered by 'less_than'.  Pulled runs are refilled 'batch' elements
+ * at a time.
+ *
+ * @returns A pointer to the cursor or NULL if memory allocation failed.
+ */
+pmt_mc_cursor_t *pmt_mc_create(
+        pmt_mc_cursor_t *cursor,
+        const size_t max_runs,
+        const size_t element_size,
+        const size_t batch,
+        pmt_da_less_than_t less_than,
+        pmt_da_alloc_t alloc,
+        pmt_da_realloc_t realloc,
+        pmt_da_free_t free,
+        void *alloc_state);
+
+/**
+ * Destroy the cursor, freeing its batch buffers.  Array runs are not touched.
+ */
+void pmt_mc_destroy(pmt_mc_cursor_t *cursor);
+
+/**
+ * Add a sorted dynamic array as a run.  Its elements are read in place, so
+ * the array must not change until the cursor is destroyed.
+ */
+void pmt_mc_add_array(
+        pmt_mc_cursor_t *cursor,
+        pmt_da_iface_t *iface,
+        void *array);
+
+/**
+ * Add a sorted run produced by a pull callback, pulling its first batch.
+ *
+ * @returns A value of 'false' indicates a memory allocation failure or a
+ * pull error.  The run is then not added and the cursor remains usable.
+ */
+bool pmt_mc_add_pull(
+        pmt_mc_cursor_t *cursor,
+        pmt_mc_pull_t pull,
+        void *pull_state);
+
+/**
+ * Get a pointer to the next element without taking it.  The pointer is valid
+ * until the cursor is advanced.
+ *
+ * @returns A value of 'NULL' is returned once every run has ended.
+ */
+void *pmt_mc_peek(pmt_mc_cursor_t *cursor);
+
+/**
+ * Take the next element.  If 'element' is not NULL, then it will receive a
+ * copy of the element.
+ *
+ * @returns A value of 'false' is returned once every run has ended or after
+ * a pull callback failed, see pmt_mc_failed.  An element taken by the call
+ * whose refill fails is still delivered, the failure is reported by the
+ * following call.
+ */
+bool pmt_mc_next(pmt_mc_cursor_t *cursor, void *element);
+
+/**
+ * Take up to nelems elements into 'elements', storing the number taken in
+ * 'nread'.  While a single run remains, its batches are copied whole.  The
+ * signature matches pmt_mc_pull_t with the cursor as the state, so cursors
+ * can be pulled from by other cursors.
+ *
+ * @returns A value of 'false' indicates a pull error.  Elements taken before
+ * a pull fails are delivered with 'true', the failure is reported by the
+ * following call.
+ */
+bool pmt_mc_read(
+        void *elements,
+        const size_t nelems,
+        size_t *nread,
+        void *cursor);
+
+/**
+ * Did a pull callback fail?
+ */
+bool pmt_mc_failed(pmt_mc_cursor_t *cursor);
+
+#endif
@@ -0,0 +1,56 @@
+#ifndef PUBMT_MIN_MAX_HEAP_H
+#define PUBMT_MIN_MAX_HEAP_H
+
+#include "pubmt/binary_heap.h"
+
+/*
+ * Min-Max Heap
+ *
+ * A double-ended priority queue stored in the same array model as the binary
+ * heap and driven by the same interface.  Even levels of the tree are ordered
+ * like a min-heap and odd levels like a max-heap, so the minimal element is
+ * the root and the maximal element is one of its children.  The heap is
+ * always binary, the 'get_arity' and 'get_set_index' callbacks are ignored.
+ * Without a swap callback, elements are swapped bytewise.
+ */
+
+/**
+ * Insert an element into the heap O(log n).  This function may resize the
+ * internal buffer.
+ *
+ * @returns A pointer to the inserted element is returned.  A value of 'NULL'
+ * indicates a memory allocation failure.
+ */
+void *pmt_mmh_insert(pmt_bh_iface_t *iface, void *heap, void *element);
+
+/**
+ * Get a pointer to the minimal element O(1).
+ *
+ * @returns A value of 'NULL' is returned if the heap is empty.
+ */
+void *pmt_mmh_peek_min(pmt_bh_iface_t *iface, void *heap);
+
+/**
+ * Get a pointer to the maximal element O(1).
+ *
+ * @returns A value of 'NULL' is returned if the heap is empty.
+ */
+void *pmt_mmh_peek_max(pmt_bh_iface_t *iface, void *heap);
+
+/**
+ * Pop the minimal element O(log n).  If 'element' is not 'NULL', then it will
+ * receive the contents of the popped element.
+ *
+ * @returns A value of 'false' is returned if the heap is empty.
+ */
+bool pmt_mmh_pop_min(pmt_bh_iface_t *iface, void *heap, void *element);
+
+/**
+ * Pop the maximal element O(log n).  If 'element' is not 'NULL', then it will
+ * receive the contents of the popped element.
+ *
+ * @returns A value of 'false' is returned if the heap is empty.
+ */
+bool pmt_mmh_pop_max(pmt_bh_iface_t *iface, void *heap, void *element);
+
+#endif
@@ -0,0 +1,97 @@
+#ifndef PUBMT_MPMC_QUEUE_H
+#define PUBMT_MPMC_QUEUE_H
+
+#include "pubmt/dynamic_array.h"
+#include <stdatomic.h>
+
+#define PMT_MPMC_CACHE_LINE 64
+
+/**
+ * Bounded Multi-Producer/Multi-Consumer Queue
+ *
+ * Each slot carries a sequence number telling producers and consumers
+ * whether it is free or full for their current lap, so an operation costs a
+ * single compare-and-swap on the enqueue or dequeue position and threads
+ * only contend on the slot they claim.  The blocking operations sleep on a
+ * futex on Linux and yield elsewhere; the non-blocking paths never touch the
+ * futex words unless a thread is waiting.  Instances are cache line aligned,
+ * a heap allocated queue should come from aligned_alloc.
+ */
+typedef struct pmt_mpmc_queue {
+
+        /* slots, each a sequence number followed by an element */
+        void *slots;
+
+        size_t mask, element_size, slot_size;
+
+        pmt_da_free_t free;
+        void *alloc_state;
+
+        _Alignas(PMT_MPMC_CACHE_LINE) atomic_size_t enqueue_pos;
+
+        _Alignas(PMT_MPMC_CACHE_LINE) atomic_size_t dequeue_pos;
+
+        /* blocking wait, bumped when elements or free slots appear */
+        _Alignas(PMT_MPMC_CACHE_LINE) atomic_uint items_event;
+        atomic_uint space_event;
+        atomic_uint items_waiters, space_waiters;
+
+} pmt_mpmc_queue_t;
+
+/**
+ * Create an empty queue of 'capacity' elements of 'element_size' bytes, the
+ * slots being allocated with 'alloc'.  The capacity must be a power of two
+ * and at least two.
+ *
+ * @returns A pointer to the queue or NULL if memory allocation failed.
+ */
+pmt_mpmc_queue_t *pmt_mpmc_create(
+        pmt_mpmc_queue_t *queue,
+        const size_t capacity,
+        const size_t element_size,
+        pmt_da_alloc_t alloc,
+        pmt_da_free_t free,
+        void *alloc_state);
+
+/**
+ * Destroy the queue, freeing its slots.  No thread may be using it.
+ */
+void pmt_mpmc_destroy(pmt_mpmc_queue_t *queue);
+
+/**
+ * Enqueue a copy of the element without blocking.
+ *
+ * @returns A value of 'false' is returned when the queue is full.
+ */
+bool pmt_mpmc_try_enqueue(pmt_mpmc_queue_t *queue, const void *element);
+
+/**
+ * Dequeue an element without blocking.  If element is not NULL, then it
+ * will receive a copy of the element's contents.
+ *
+ * @returns A value of 'false' is returned when the queue is empty.
+ */
+bool pmt_mpmc_try_dequeue(pmt_mpmc_queue_t *queue, void *element);
+
+/**
+ * Enqueue a copy of the element, sleeping while the queue is full.
+ */
+void pmt_mpmc_enqueue(pmt_mpmc_queue_t *queue, const void *element);
+
+/**
+ * Dequeue an element, sleeping while the queue is empty.  If element is not
+ * NULL, then it will receive a copy of the element's contents.
+ */
+void pmt_mpmc_dequeue(pmt_mpmc_queue_t *queue, void *element);
+
+/**
+ * Get the approximate number of queued elements.
+ */
+size_t pmt_mpmc_size(pmt_mpmc_queue_t *queue);
+
+/**
+ * Get the capacity of the queue in elements.
+ */
+size_t pmt_mpmc_capacity(pmt_mpmc_queue_t *queue);
+
+#endif
@@ -0,0 +1,74 @@
+#ifndef PUBMT_MPSC_QUEUE_H
+#define PUBMT_MPSC_QUEUE_H
+
+#include "pubmt/linked_list.h"
+#include <stdatomic.h>
+
+#define PMT_MPSC_CACHE_LINE 64
+
+/**
+ * Intrusive Multi-Producer/Single-Consumer Queue
+ *
+ * Nodes are linked through their own next pointer, as described by a
+ * pmt_ll_node_iface_t, so queueing never allocates.  Producers append with a
+ * single atomic exchange on the head and then link the previous node to the
+ * new one.  The consumer walks from the tail and a user supplied stub node
+ * stands in when the queue is drained.
+ *
+ * Producers and the consumer touch the same next pointers concurrently, so
+ * get_next and set_next must perform single aligned word sized accesses,
+ * ideally relaxed loads and stores of an _Atomic(void*) field.  The queue
+ * orders them with fences.
+ */
+typedef struct pmt_mpsc_queue {
+
+        /* last pushed node, shared by the producers */
+        _Alignas(PMT_MPSC_CACHE_LINE) _Atomic(void*) head;
+
+        /* next node to pop, private to the consumer */
+        _Alignas(PMT_MPSC_CACHE_LINE) void *tail;
+
+        void *stub;
+
+} pmt_mpsc_queue_t;
+
+/**
+ * Initialize an empty queue.  The stub node belongs to the queue until it is
+ * no longer used, and is never returned by pmt_mpsc_pop.
+ *
+ * @returns A pointer to the queue is returned.
+ */
+pmt_mpsc_queue_t *pmt_mpsc_init(
+        pmt_ll_node_iface_t *iface,
+        pmt_mpsc_queue_t *queue,
+        void *stub);
+
+/**
+ * Push an unlinked node onto the queue, safe from any number of threads.
+ * This is one atomic exchange followed by a store to the previous node.
+ */
+void pmt_mpsc_push(
+        pmt_ll_node_iface_t *iface,
+        pmt_mpsc_queue_t *queue,
+        void *node);
+
+/**
+ * Pop the oldest node, consumer only.  It does not wait for a producer
+ * which has exchanged the head but not yet linked its node, that node and
+ * those after it become visible once the producer finishes.
+ *
+ * @returns The popped node, or NULL if the queue is empty or the next node
+ * is still being published.
+ */
+void *pmt_mpsc_pop(pmt_ll_node_iface_t *iface, pmt_mpsc_queue_t *queue);
+
+/**
+ * Does the queue look empty to the consumer?  Unlike a NULL from
+ * pmt_mpsc_pop, a 'false' here means a push is in progress.
+ *
+ * @returns A value of 'true' is returned when no node has been pushed since
+ * the last pop.
+ */
+bool pmt_mpsc_is_empty(pmt_ll_node_iface_t *iface, pmt_mpsc_queue_t *queue);
+
+#endif
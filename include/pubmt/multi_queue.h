@@ -0,0 +1,102 @@
+#ifndef PUBMT_MULTI_QUEUE_H
+#define PUBMT_MULTI_QUEUE_H
+
+#include "pubmt/binary_heap.h"
+#include <stdatomic.h>
+
+#define PMT_MQ_CACHE_LINE 64
+
+/* two-choice pop attempts before every heap is scanned */
+#define PMT_MQ_POP_TRIES 8
+
+struct pmt_mq_queue;
+
+/** One of the queue's heaps and the try-lock guarding it. */
+typedef struct pmt_mq_heap {
+
+        atomic_bool locked;
+
+        struct pmt_mq_queue *queue;
+
+        void *buffer;
+
+        size_t size, capacity;
+
+        /* keep the next heap's lock off this cache line */
+        unsigned char pad[PMT_MQ_CACHE_LINE];
+
+} pmt_mq_heap_t;
+
+/**
+ * Relaxed Concurrent Priority Queue (MultiQueue)
+ *
+ * Elements are spread over independent binary heaps, each behind a try-lock.
+ * An insert goes to a random heap and a pop takes the better top of two
+ * random heaps, skipping any heap whose lock is taken.  A pop is not
+ * guaranteed to return the minimal element, but the expected rank of the
+ * popped element is bounded by the number of heaps.  Use a small multiple
+ * of the number of threads, such as 2 to 4, as the number of heaps.
+ */
+typedef struct pmt_mq_queue {
+
+        pmt_mq_heap_t *heaps;
+
+        size_t nheaps, element_size;
+
+        pmt_bh_less_than_t less_than;
+
+        /* approximate number of elements */
+        atomic_size_t size;
+
+        pmt_da_alloc_t alloc;
+        pmt_da_realloc_t realloc;
+        pmt_da_free_t free;
+        void *alloc_state;
+
+} pmt_mq_queue_t;
+
+/**
+ * Create an empty queue of 'nheaps' heaps, at least two, holding elements of
+ * 'element_size' bytes ordered by 'less_than'.  The heaps are allocated with
+ * the given callbacks, which must be thread safe.
+ *
+ * @returns A pointer to the queue or NULL if memory allocation failed.
+ */
+pmt_mq_queue_t *pmt_mq_create(
+        pmt_mq_queue_t *queue,
+        const size_t nheaps,
+        const size_t element_size,
+        pmt_bh_less_than_t less_than,
+        pmt_da_alloc_t alloc,
+        pmt_da_realloc_t realloc,
+        pmt_da_free_t free,
+        void *alloc_state);
+
+/**
+ * Destroy the queue, freeing its heaps.  No thread may be using it.
+ */
+void pmt_mq_destroy(pmt_mq_queue_t *queue);
+
+/**
+ * Get the number of elements in the queue.  The value is only approximate
+ * while other threads are inserting or popping.
+ */
+size_t pmt_mq_size(pmt_mq_queue_t *queue);
+
+/**
+ * Insert a copy of the element into a random heap, amortized O(log n).
+ *
+ * @returns A value of 'false' indicates a memory allocation failure.
+ */
+bool pmt_mq_insert(pmt_mq_queue_t *queue, void *element);
+
+/**
+ * Pop a small element, the better top of two random heaps, O(log n).  If
+ * 'element' is not NULL, then it will receive the popped element.
+ *
+ * @returns A value of 'false' is returned if the queue's size read zero or
+ * every heap was found empty.
+ */
+bool pmt_mq_pop(pmt_mq_queue_t *queue, void *element);
+
+#endif
@@ -0,0 +1,101 @@
+#ifndef PUBMT_PAIRING_HEAP_H
+#define PUBMT_PAIRING_HEAP_H
+
+#include <stddef.h>
+#include <stdbool.h>
+
+/** Is key_a less than key_b? */
+typedef bool (*pmt_ph_less_than_t)(void *key_a, void *key_b);
+
+/**
+ * Pairing Heap Node Callback Interface
+ *
+ * Every node links to its first child and to its next sibling.  The 'prev'
+ * link of a first child is its parent, otherwise it is the previous sibling.
+ */
+typedef struct pmt_ph_node_iface {
+
+        void *(*get_child)(void *node);
+        void (*set_child)(void *node, void *child);
+
+        void *(*get_next)(void *node);
+        void (*set_next)(void *node, void *next);
+
+        void *(*get_prev)(void *node);
+        void (*set_prev)(void *node, void *prev);
+
+        void *(*get_key)(void *node);
+
+} pmt_ph_node_iface_t;
+
+/** Pairing Heap Callback Interface */
+typedef struct pmt_ph_iface {
+
+        pmt_ph_node_iface_t node_iface;
+
+        pmt_ph_less_than_t (*get_less_than)(void *heap);
+
+        void *(*get_root)(void *heap);
+
+        void (*set_root)(void *heap, void *root);
+
+} pmt_ph_iface_t;
+
+/**
+ * Validate the pairing heap callback interface.
+ *
+ * @returns Will return 'false' if any callbacks are NULL.
+ */
+bool pmt_ph_iface_validate(pmt_ph_iface_t *iface);
+
+/**
+ * Initialize an empty pairing heap.
+ */
+void *pmt_ph_init(pmt_ph_iface_t *iface, void *heap);
+
+/**
+ * Is the heap empty?
+ *
+ * @returns A return value of 'true' indicates that the heap is empty.
+ */
+bool pmt_ph_is_empty(pmt_ph_iface_t *iface, void *heap);
+
+/**
+ * Get the minimum node O(1).
+ *
+ * @returns The minimum node, or NULL if the heap is empty.
+ */
+void *pmt_ph_peek(pmt_ph_iface_t *iface, void *heap);
+
+/**
+ * Insert a node into the heap O(1).  The node's links are overwritten.
+ */
+void pmt_ph_insert(pmt_ph_iface_t *iface, void *heap, void *node);
+
+/**
+ * Move every node of 'other' into 'heap' O(1).  Both heaps must use the same
+ * interface and ordering, 'other' is left empty.
+ */
+void pmt_ph_meld(pmt_ph_iface_t *iface, void *heap, void *other);
+
+/**
+ * Remove the minimum node, amortized O(log n).
+ *
+ * @returns A pointer to the minimum node is returned, or NULL if the heap is
+ * empty.
+ */
+void *pmt_ph_pop(pmt_ph_iface_t *iface, void *heap);
+
+/**
+ * Restore the heap order after the key of 'node' was decreased in place,
+ * amortized O(1).  The node must belong to the heap.
+ */
+void pmt_ph_decrease(pmt_ph_iface_t *iface, void *heap, void *node);
+
+/**
+ * Remove 'node' from the heap, amortized O(log n).  The node must belong to
+ * the heap.
+ */
+void pmt_ph_remove(pmt_ph_iface_t *iface, void *heap, void *node);
+
+#endif
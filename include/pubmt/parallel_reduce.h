@@ -0,0 +1,79 @@
+#ifndef PUBMT_PARALLEL_REDUCE_H
+#define PUBMT_PARALLEL_REDUCE_H
+
+#include "pubmt/hash_map.h"
+#include "pubmt/thread_pool.h"
+
+/** Chunks per worker, so uneven chunks still balance. */
+#define PMT_PR_CHUNKS_PER_WORKER 8
+
+/** Minimum buckets or elements per chunk. */
+#define PMT_PR_MIN_CHUNK 4096
+
+/** Initialize a chunk's accumulator. */
+typedef void (*pmt_pr_init_t)(void *accumulator, void *state);
+
+/** Combine the accumulator 'from' into 'into'. */
+typedef void (*pmt_pr_combine_t)(void *into, void *from, void *state);
+
+/** Visit a node of the hash map, folding it into the accumulator. */
+typedef void (*pmt_hm_visit_t)(void *node, void *accumulator, void *state);
+
+/** Fold nelems contiguous elements into the accumulator. */
+typedef void (*pmt_da_fold_t)(
+        void *elements,
+        const size_t nelems,
+        void *accumulator,
+        void *state);
+
+/**
+ * Visit every node of the map on the pool.  The buckets are split into
+ * chunks which are visited in parallel, each with its own accumulator of
+ * accumulator_size bytes set up by init.  Once every chunk is done, their
+ * accumulators are combined into 'accumulator' in bucket order, which the
+ * caller initializes.  With an accumulator_size of zero the visits get a
+ * NULL accumulator and init and combine may be NULL.
+ *
+ * The chunks' accumulators are allocated with the map's allocator.  The map
+ * must not be modified during the scan.  Small maps are scanned on the
+ * calling thread directly into 'accumulator'.
+ *
+ * @returns A value of 'false' is returned if the chunks' accumulators could
+ * not be allocated, in which case no node was visited.
+ */
+bool pmt_hm_parallel_foreach(
+        pmt_hm_iface_t *iface,
+        void *map,
+        pmt_tp_pool_t *pool,
+        pmt_hm_visit_t visit,
+        void *accumulator,
+        const size_t accumulator_size,
+        pmt_pr_init_t init,
+        pmt_pr_combine_t combine,
+        void *state);
+
+/**
+ * Fold the array's elements on the pool.  The elements are split into
+ * chunks of contiguous elements which are folded in parallel, each into its
+ * own accumulator of accumulator_size bytes set up by init.  Once every
+ * chunk is done, their accumulators are combined into 'accumulator' in
+ * index order, which the caller initializes.
+ *
+ * The chunks' accumulators are allocated with the array's allocator.  Small
+ * arrays are folded on the calling thread directly into 'accumulator'.
+ *
+ * @returns A value of 'false' is returned if the chunks' accumulators could
+ * not be allocated, in which case no element was folded.
+ */
+bool pmt_da_parallel_reduce(
+        pmt_da_iface_t *iface,
+        void *array,
+        pmt_tp_pool_t *pool,
+        pmt_da_fold_t fold,
+        void *accumulator,
+        const size_t accumulator_size,
+        pmt_pr_init_t init,
+        pmt_pr_combine_t combine,
+        void *state);
+
+#endif
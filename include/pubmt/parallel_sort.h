@@ -0,0 +1,42 @@
+#ifndef PUBMT_PARALLEL_SORT_H
+#define PUBMT_PARALLEL_SORT_H
+
+#include "pubmt/sort.h"
+#include "pubmt/thread_pool.h"
+
+/**
+ * Sort the array in place with a parallel sample sort on 'nthreads' threads,
+ * the calling thread being one of them.  A sorted sample of the array picks 
+ * one splitter per thread, each thread classifies and scatters its chunk of 
+ * the array into a temporary buffer by splitter, and then each thread sorts 
+ * one bucket with pmt_da_sort and copies it back.  Small arrays are sorted on 
+ * the calling thread alone.  The sort is not stable.
+ *
+ * Temporary buffers of roughly the array's size, plus four bytes per element,
+ * are obtained from the array's allocator.  If a worker thread can not be 
+ * started, its share of the work is done by the calling thread.
+ * 
+ * @returns A value of 'false' is returned if there was a memory allocation
+ * error, in which case the array is left unmodified.
+ */
+bool pmt_da_parallel_sort(
+        pmt_da_iface_t *iface, 
+        void *array, 
+        pmt_da_less_than_t less_than,
+        const size_t nthreads);
+
+/**
+ * Sort the array in place like pmt_da_parallel_sort, with one share of the 
+ * work per worker of the pool.  The shares run as tasks on the pool, so no
+ * threads are created.
+ *
+ * @returns A value of 'false' is returned if there was a memory allocation
+ * error, in which case the array is left unmodified.
+ */
+bool pmt_da_parallel_sort_pool(
+        pmt_da_iface_t *iface, 
+        void *array, 
+        pmt_da_less_than_t less_than,
+        pmt_tp_pool_t *pool);
+
+#endif
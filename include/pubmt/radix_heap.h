@@ -0,0 +1,124 @@
+#ifndef PUBMT_RADIX_HEAP_H
+#define PUBMT_RADIX_HEAP_H
+
+#include "pubmt/dynamic_array.h"
+#include <stdint.h>
+
+/* one bucket for the last popped key and one per differing bit */
+#define PMT_RH_BUCKETS 65
+
+struct pmt_rh_heap;
+
+/** Radix Heap Bucket, a dynamic array of key and element pairs. */
+typedef struct pmt_rh_bucket {
+
+        struct pmt_rh_heap *heap;
+
+        void *buffer;
+
+        size_t size, capacity;
+
+        /* smallest key within the bucket */
+        uint64_t min;
+
+} pmt_rh_bucket_t;
+
+/**
+ * Radix Heap
+ *
+ * A monotone min-heap of 64-bit keys, every pushed key must be at least the
+ * last popped key.  An entry lives in the bucket numbered by the highest bit
+ * in which its key differs from the last popped key, so pushing appends to a
+ * bucket and popping only redistributes the lowest non-empty bucket when the
+ * first one runs dry.  Each entry moves to a lower bucket at most 64 times,
+ * push and pop are amortized O(1) and only touch memory sequentially.
+ */
+typedef struct pmt_rh_heap {
+
+        pmt_rh_bucket_t buckets[PMT_RH_BUCKETS];
+
+        uint64_t last;
+
+        size_t size, element_size, entry_size;
+
+        pmt_da_alloc_t alloc;
+        pmt_da_realloc_t realloc;
+        pmt_da_free_t free;
+        void *alloc_state;
+
+} pmt_rh_heap_t;
+
+/**
+ * Initialize an empty heap of elements of 'element_size' bytes, which may be
+ * zero.  The buckets are allocated lazily with the given callbacks.
+ *
+ * @returns A pointer to 'heap'.
+ */
+pmt_rh_heap_t *pmt_rh_init(
+        pmt_rh_heap_t *heap,
+        const size_t element_size,
+        pmt_da_alloc_t alloc,
+        pmt_da_realloc_t realloc,
+        pmt_da_free_t free,
+        void *alloc_state);
+
+/**
+ * Destroy the heap, freeing its buckets.
+ */
+void pmt_rh_destroy(pmt_rh_heap_t *heap);
+
+/**
+ * Remove every entry and reset the last popped key to zero.  The buckets keep
+ * their memory.
+ */
+void pmt_rh_clear(pmt_rh_heap_t *heap);
+
+/**
+ * Get the number of entries in the heap O(1).
+ */
+size_t pmt_rh_size(pmt_rh_heap_t *heap);
+
+/**
+ * Is the heap empty O(1)?
+ *
+ * @returns A true value indicates the heap was empty, otherwise false.
+ */
+bool pmt_rh_is_empty(pmt_rh_heap_t *heap);
+
+/**
+ * Get the last popped key, the lower bound for pushed keys.
+ */
+uint64_t pmt_rh_last_key(pmt_rh_heap_t *heap);
+
+/**
+ * Push a copy of 'element' with the given key, amortized O(1).  The key must
+ * not be less than the last popped key.  If 'element' is NULL, the element's
+ * contents are left uninitialized.
+ *
+ * @returns A pointer to the pushed element is returned, it stays valid until
+ * the next push or pop.  A value of 'NULL' indicates a memory allocation
+ * failure.
+ */
+void *pmt_rh_push(pmt_rh_heap_t *heap, const uint64_t key, void *element);
+
+/**
+ * Get the entry with the smallest key, amortized O(1).  This may redistribute
+ * a bucket, which can fail to allocate memory.  If 'key' is not NULL, it will
+ * receive the entry's key.
+ *
+ * @returns A pointer to the element is returned, it stays valid until the
+ * next push or pop.  NULL is returned if the heap is empty or memory
+ * allocation failed.
+ */
+void *pmt_rh_peek(pmt_rh_heap_t *heap, uint64_t *key);
+
+/**
+ * Pop the entry with the smallest key, amortized O(1).  If 'key' or 'element'
+ * are not NULL, they will receive the entry's key and contents.
+ *
+ * @returns A value of 'false' is returned if the heap is empty or memory
+ * allocation failed while redistributing a bucket.
+ */
+bool pmt_rh_pop(pmt_rh_heap_t *heap, uint64_t *key, void *element);
+
+#endif
@@ -0,0 +1,295 @@
+#ifndef PUBMT_RECLAMATION_H
+#define PUBMT_RECLAMATION_H
+
+#include "pubmt/dynamic_array.h"
+#include <stdatomic.h>
+
+/** Retired nodes between epoch reclamation scans. */
+#define PMT_EBR_SCAN_INTERVAL 64
+
+/** Hazard pointer slots per thread. */
+#ifndef PMT_HP_SLOTS
+#define PMT_HP_SLOTS 4
+#endif
+
+/** Retired nodes between hazard pointer scans, beyond the hazard count. */
+#define PMT_HP_SCAN_INTERVAL 64
+
+/** Free a retired node. */
+typedef void (*pmt_rc_free_t)(void *node, void *free_state);
+
+/** Node waiting to be freed. */
+typedef struct pmt_rc_retired {
+
+        void *node;
+
+        pmt_rc_free_t free;
+        void *free_state;
+
+        /* global epoch when retired, unused by hazard pointers */
+        size_t epoch;
+
+} pmt_rc_retired_t;
+
+/** Per-thread list of retired nodes. */
+typedef struct pmt_rc_list {
+
+        pmt_rc_retired_t *retired;
+
+        size_t length, capacity;
+
+        /* length at which the next scan is due */
+        size_t scan_at;
+
+} pmt_rc_list_t;
+
+/*
+ * Epoch-Based Reclamation
+ *
+ * Readers bracket their accesses to shared nodes with pmt_ebr_enter and
+ * pmt_ebr_exit.  A node unlinked from a shared structure is retired rather
+ * than freed, and is freed once the global epoch has advanced twice past
+ * its retirement, at which point every reader that could have seen it has
+ * left its critical section.  A reader stalled inside a critical section
+ * holds back every retired node.
+ */
+
+typedef struct pmt_ebr_domain pmt_ebr_domain_t;
+
+/** Registered thread, owned by the domain. */
+typedef struct pmt_ebr_thread {
+
+        /* (epoch << 1) | 1 inside a critical section, otherwise zero */
+        atomic_size_t local_epoch;
+
+        atomic_bool in_use;
+
+        /* registry, records are never unlinked */
+        struct pmt_ebr_thread *next;
+
+        pmt_ebr_domain_t *domain;
+
+        size_t nesting;
+
+        pmt_rc_list_t list;
+
+} pmt_ebr_thread_t;
+
+/** Epoch Reclamation Domain */
+struct pmt_ebr_domain {
+
+        atomic_size_t epoch;
+
+        _Atomic(pmt_ebr_thread_t*) threads;
+
+        pmt_da_alloc_t alloc;
+        pmt_da_realloc_t realloc;
+        pmt_da_free_t free;
+        void *alloc_state;
+
+};
+
+/**
+ * Initialize an epoch domain whose thread records and retire lists are
+ * allocated with the given callbacks.
+ *
+ * @returns A pointer to the domain is returned.
+ */
+pmt_ebr_domain_t *pmt_ebr_init(
+        pmt_ebr_domain_t *domain,
+        pmt_da_alloc_t alloc,
+        pmt_da_realloc_t realloc,
+        pmt_da_free_t free,
+        void *alloc_state);
+
+/**
+ * Destroy the domain, freeing every retired node and thread record.  No
+ * thread may be using it.
+ */
+void pmt_ebr_destroy(pmt_ebr_domain_t *domain);
+
+/**
+ * Register the calling thread, reusing a released record when one exists.
+ * The record must only be used by one thread at a time.
+ *
+ * @returns The thread's record, or NULL if memory allocation failed.
+ */
+pmt_ebr_thread_t *pmt_ebr_register(pmt_ebr_domain_t *domain);
+
+/**
+ * Release the thread's record, reclaiming what it can.  Nodes which are not
+ * yet safe to free stay with the record until it is reused or the domain is
+ * destroyed.  The thread must be outside any critical section.
+ */
+void pmt_ebr_unregister(pmt_ebr_thread_t *thread);
+
+/**
+ * Enter a critical section, within which shared nodes may be read.
+ * Critical sections may be nested.
+ */
+void pmt_ebr_enter(pmt_ebr_thread_t *thread);
+
+/**
+ * Leave a critical section.
+ */
+void pmt_ebr_exit(pmt_ebr_thread_t *thread);
+
+/**
+ * Retire a node which has been unlinked from every shared structure, it
+ * will be passed to 'free' once no reader can hold it.  Every
+ * PMT_EBR_SCAN_INTERVAL retirements the thread tries to advance the epoch
+ * and free its safe nodes.
+ *
+ * @returns A value of 'false' is returned if there was a memory allocation
+ * error, in which case the node was not retired.
+ */
+bool pmt_ebr_retire(
+        pmt_ebr_thread_t *thread,
+        void *node,
+        pmt_rc_free_t free,
+        void *free_state);
+
+/**
+ * Try to advance the epoch and free the thread's safe nodes now.
+ *
+ * @returns The number of nodes freed.
+ */
+size_t pmt_ebr_reclaim(pmt_ebr_thread_t *thread);
+
+/*
+ * Hazard Pointers
+ *
+ * A reader publishes each shared node it is about to use in one of its
+ * hazard slots, and retired nodes are only freed when no slot holds them.
+ * A stalled reader holds back at most PMT_HP_SLOTS nodes, so the garbage per
+ * thread stays bounded by roughly twice the total number of slots.
+ */
+
+typedef struct pmt_hp_domain pmt_hp_domain_t;
+
+/** Registered thread, owned by the domain. */
+typedef struct pmt_hp_thread {
+
+        _Atomic(void*) hazards[PMT_HP_SLOTS];
+
+        atomic_bool in_use;
+
+        /* registry, records are never unlinked */
+        struct pmt_hp_thread *next;
+
+        pmt_hp_domain_t *domain;
+
+        pmt_rc_list_t list;
+
+        /* hazards gathered during a scan */
+        void **scratch;
+        size_t scratch_capacity;
+
+} pmt_hp_thread_t;
+
+/** Hazard Pointer Domain */
+struct pmt_hp_domain {
+
+        _Atomic(pmt_hp_thread_t*) threads;
+
+        atomic_size_t nthreads;
+
+        pmt_da_alloc_t alloc;
+        pmt_da_realloc_t realloc;
+        pmt_da_free_t free;
+        void *alloc_state;
+
+};
+
+/**
+ * Initialize a hazard pointer domain whose thread records and retire lists
+ * are allocated with the given callbacks.
+ *
+ * @returns A pointer to the domain is returned.
+ */
+pmt_hp_domain_t *pmt_hp_init(
+        pmt_hp_domain_t *domain,
+        pmt_da_alloc_t alloc,
+        pmt_da_realloc_t realloc,
+        pmt_da_free_t free,
+        void *alloc_state);
+
+/**
+ * Destroy the domain, freeing every retired node and thread record.  No
+ * thread may be using it.
+ */
+void pmt_hp_destroy(pmt_hp_domain_t *domain);
+
+/**
+ * Register the calling thread, reusing a released record when one exists.
+ * The record must only be used by one thread at a time.
+ *
+ * @returns The thread's record, or NULL if memory allocation failed.
+ */
+pmt_hp_thread_t *pmt_hp_register(pmt_hp_domain_t *domain);
+
+/**
+ * Clear the thread's hazards and release its record, reclaiming what it
+ * can.  Nodes which are still hazardous stay with the record until it is
+ * reused or the domain is destroyed.
+ */
+void pmt_hp_unregister(pmt_hp_thread_t *thread);
+
+/**
+ * Protect the pointer stored at 'source', re-reading it until the published
+ * hazard is known to match.
+ *
+ * @returns The protected pointer, which may be NULL.
+ */
+void *pmt_hp_protect(
+        pmt_hp_thread_t *thread,
+        const size_t slot,
+        _Atomic(void*) *source);
+
+/**
+ * Protect the pointer returned by get(object), such as a node interface's
+ * get_next, re-reading it until the published hazard is known to match.
+ * The object itself must already be protected or otherwise safe to read.
+ *
+ * @returns The protected pointer, which may be NULL.
+ */
+void *pmt_hp_protect_with(
+        pmt_hp_thread_t *thread,
+        const size_t slot,
+        void *(*get)(void *object),
+        void *object);
+
+/**
+ * Publish a hazard directly.  The caller must check that the pointer is
+ * still reachable afterwards before using it.
+ */
+void pmt_hp_set(pmt_hp_thread_t *thread, const size_t slot, void *pointer);
+
+/**
+ * Clear a hazard slot.
+ */
+void pmt_hp_clear(pmt_hp_thread_t *thread, const size_t slot);
+
+/**
+ * Retire a node which has been unlinked from every shared structure, it
+ * will be passed to 'free' once no hazard slot holds it.  The thread scans
+ * the hazards whenever its retire list grows by PMT_HP_SCAN_INTERVAL plus
+ * the total number of slots.
+ *
+ * @returns A value of 'false' is returned if there was a memory allocation
+ * error, in which case the node was not retired.
+ */
+bool pmt_hp_retire(
+        pmt_hp_thread_t *thread,
+        void *node,
+        pmt_rc_free_t free,
+        void *free_state);
+
+/**
+ * Scan the hazards and free the thread's unprotected nodes now.
+ *
+ * @returns The number of nodes freed.
+ */
+size_t pmt_hp_reclaim(pmt_hp_thread_t *thread);
+
+#endif
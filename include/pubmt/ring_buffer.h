@@ -0,0 +1,148 @@
+#ifndef PUBMT_RING_BUFFER_H
+#define PUBMT_RING_BUFFER_H
+
+#include "pubmt/dynamic_array.h"
+
+/**
+ * Ring Buffer Interface
+ *
+ * The embedded dynamic array's size is the number of elements and its
+ * capacity, always a power of two, is the length of the ring.  Element
+ * positions wrap around the end of the buffer by masking.  The capacity of
+ * optional inline storage must also be a power of two, since the dynamic
+ * array adopts it whenever a requested capacity fits.
+ */
+typedef struct pmt_rb_iface {
+
+        pmt_da_iface_t array_iface;
+
+        /* position of the first element within the buffer */
+        size_t (*get_head)(void *ring);
+        void (*set_head)(void *ring, const size_t head);
+
+} pmt_rb_iface_t;
+
+/** Contiguous region of a ring, laid out like struct iovec. */
+typedef struct pmt_rb_span {
+
+        void *base;
+
+        /* length in bytes */
+        size_t length;
+
+} pmt_rb_span_t;
+
+/**
+ * Validate the ring buffer interface.
+ *
+ * @returns Will return 'false' if any callbacks are NULL.
+ */
+bool pmt_rb_iface_validate(pmt_rb_iface_t *iface);
+
+/**
+ * Create a new ring buffer whose capacity is 'initial_capacity' rounded up
+ * to a power of two, or the inline capacity when that is larger.
+ *
+ * @returns A pointer to 'ring' or NULL if memory allocation failed or the
+ * inline capacity is not a power of two.
+ */
+void *pmt_rb_create(
+        pmt_rb_iface_t *iface,
+        void *ring,
+        const size_t initial_capacity);
+
+/**
+ * Destroy the ring buffer, freeing its internal buffer.
+ */
+void pmt_rb_destroy(pmt_rb_iface_t *iface, void *ring);
+
+/**
+ * Clear the ring buffer, removing all its elements.
+ */
+void pmt_rb_clear(pmt_rb_iface_t *iface, void *ring);
+
+/**
+ * Get the number of elements in the ring O(1).
+ */
+size_t pmt_rb_size(pmt_rb_iface_t *iface, void *ring);
+
+/**
+ * Is the ring empty O(1)?
+ *
+ * @returns A true value indicates the ring was empty, otherwise false.
+ */
+bool pmt_rb_is_empty(pmt_rb_iface_t *iface, void *ring);
+
+/**
+ * Get the element at the given index from the front O(1).
+ *
+ * @returns A pointer to the element is returned.  If the 'index' is out of
+ * bounds, then NULL is returned instead.
+ */
+void *pmt_rb_at(pmt_rb_iface_t *iface, void *ring, const size_t index);
+
+/**
+ * Ensure the ring can hold nelems more elements.  Growth doubles the
+ * capacity and moves the wrapped part of the contents once, so the elements
+ * are contiguous again in the grown buffer.
+ *
+ * @returns A value of 'false' is returned if there was a memory allocation
+ * error.
+ */
+bool pmt_rb_reserve(pmt_rb_iface_t *iface, void *ring, const size_t nelems);
+
+/**
+ * Push an element onto the back of the ring, amortized O(1).  If 'element'
+ * is non-NULL, its contents are copied into the pushed region.
+ *
+ * @returns A pointer to the pushed element is returned.  A value of 'NULL'
+ * indicates a memory allocation failure.
+ */
+void *pmt_rb_push_back(pmt_rb_iface_t *iface, void *ring, void *element);
+
+/**
+ * Push an element onto the front of the ring, amortized O(1).  If 'element'
+ * is non-NULL, its contents are copied into the pushed region.
+ *
+ * @returns A pointer to the pushed element is returned.  A value of 'NULL'
+ * indicates a memory allocation failure.
+ */
+void *pmt_rb_push_front(pmt_rb_iface_t *iface, void *ring, void *element);
+
+/**
+ * Remove the last element from the ring O(1).  If element is not NULL, then
+ * it will receive a copy of the popped element's contents.
+ *
+ * @returns If false is returned, the ring was empty.
+ */
+bool pmt_rb_pop_back(pmt_rb_iface_t *iface, void *ring, void *element);
+
+/**
+ * Remove the first element from the ring O(1).  If element is not NULL, then
+ * it will receive a copy of the popped element's contents.
+ *
+ * @returns If false is returned, the ring was empty.
+ */
+bool pmt_rb_pop_front(pmt_rb_iface_t *iface, void *ring, void *element);
+
+/**
+ * Remove nelems elements from the front of the ring O(1), e.g. after they
+ * were consumed through pmt_rb_peek_spans.
+ *
+ * @returns A value of false is returned if the ring holds fewer than nelems
+ * elements, in which case it is left unmodified.
+ */
+bool pmt_rb_drop_front(pmt_rb_iface_t *iface, void *ring, const size_t nelems);
+
+/**
+ * Get the ring's contents, front to back, as at most two contiguous spans
+ * without copying.  The spans remain valid until the ring is modified.
+ *
+ * @returns The number of spans filled in, which is zero for an empty ring.
+ */
+size_t pmt_rb_peek_spans(
+        pmt_rb_iface_t *iface,
+        void *ring,
+        pmt_rb_span_t spans[2]);
+
+#endif
@@ -0,0 +1,133 @@
+#ifndef PUBMT_SEGMENTED_DEQUE_H
+#define PUBMT_SEGMENTED_DEQUE_H
+
+#include "pubmt/dynamic_array.h"
+
+/**
+ * Segmented Deque Interface
+ *
+ * Elements are stored in fixed-size blocks which are never moved or
+ * reallocated, so pointers to elements remain valid until the element is
+ * popped.  The embedded dynamic array is the block directory, its elements
+ * are block pointers (its element size must be sizeof(void*)) and its size
+ * tracks the number of allocated blocks.
+ */
+typedef struct pmt_sd_iface {
+
+        pmt_da_iface_t array_iface;
+
+        /* metrics */
+        size_t (*get_element_size)(void *deque);
+        size_t (*get_block_length)(void *deque);
+
+        /* position of the first element, counted from the first block slot */
+        size_t (*get_offset)(void *deque);
+        void (*set_offset)(void *deque, const size_t offset);
+
+        /* number of elements */
+        size_t (*get_length)(void *deque);
+        void (*set_length)(void *deque, const size_t length);
+
+} pmt_sd_iface_t;
+
+/**
+ * Validate the segmented deque interface.
+ *
+ * @returns Will return 'false' if any callbacks are NULL.
+ */
+bool pmt_sd_iface_validate(pmt_sd_iface_t *iface);
+
+/**
+ * Create a new deque whose block directory initially holds 'initial_blocks'
+ * block pointers.  No blocks are allocated until elements are pushed.
+ *
+ * @returns A pointer to 'deque' or NULL if memory allocation failed.
+ */
+void *pmt_sd_create(
+        pmt_sd_iface_t *iface,
+        void *deque,
+        const size_t initial_blocks);
+
+/**
+ * Destroy the deque, freeing every block and the block directory.
+ */
+void pmt_sd_destroy(pmt_sd_iface_t *iface, void *deque);
+
+/**
+ * Clear the deque, removing all its elements and freeing its blocks.
+ */
+void pmt_sd_clear(pmt_sd_iface_t *iface, void *deque);
+
+/**
+ * Get the number of elements in the deque O(1).
+ */
+size_t pmt_sd_size(pmt_sd_iface_t *iface, void *deque);
+
+/**
+ * Is the deque empty O(1)?
+ *
+ * @returns A true value indicates the deque was empty, otherwise false.
+ */
+bool pmt_sd_is_empty(pmt_sd_iface_t *iface, void *deque);
+
+/**
+ * Get the element at the given index O(1).
+ *
+ * @returns A pointer to the element is returned.  If the 'index' is out of
+ * bounds, then NULL is returned instead.
+ */
+void *pmt_sd_at(pmt_sd_iface_t *iface, void *deque, const size_t index);
+
+/**
+ * Get a pointer to the first element.
+ *
+ * @returns A pointer to the first element is returned, or NULL if the deque
+ * is empty.
+ */
+void *pmt_sd_first(pmt_sd_iface_t *iface, void *deque);
+
+/**
+ * Get a pointer to the last element.
+ *
+ * @returns A pointer to the last element is returned, or NULL if the deque
+ * is empty.
+ */
+void *pmt_sd_last(pmt_sd_iface_t *iface, void *deque);
+
+/**
+ * Push an element onto the back of the deque, amortized O(1).  Existing
+ * elements are never moved.  If 'element' is non-NULL, its contents are
+ * copied into the pushed region.
+ *
+ * @returns A pointer to the pushed element is returned.  A value of 'NULL'
+ * indicates a memory allocation failure.
+ */
+void *pmt_sd_push_back(pmt_sd_iface_t *iface, void *deque, void *element);
+
+/**
+ * Push an element onto the front of the deque, amortized O(1).  Existing
+ * elements are never moved.  If 'element' is non-NULL, its contents are
+ * copied into the pushed region.
+ *
+ * @returns A pointer to the pushed element is returned.  A value of 'NULL'
+ * indicates a memory allocation failure.
+ */
+void *pmt_sd_push_front(pmt_sd_iface_t *iface, void *deque, void *element);
+
+/**
+ * Remove the last element from the deque O(1).  If element is not NULL, then
+ * it will receive a copy of the popped element's contents.
+ *
+ * @returns If false is returned, the deque was empty.
+ */
+bool pmt_sd_pop_back(pmt_sd_iface_t *iface, void *deque, void *element);
+
+/**
+ * Remove the first element from the deque O(1).  If element is not NULL, then
+ * it will receive a copy of the popped element's contents.
+ *
+ * @returns If false is returned, the deque was empty.
+ */
+bool pmt_sd_pop_front(pmt_sd_iface_t *iface, void *deque, void *element);
+
+#endif
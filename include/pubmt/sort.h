@@ -0,0 +1,89 @@
+#ifndef PUBMT_SORT_H
+#define PUBMT_SORT_H
+
+#include "pubmt/dynamic_array.h"
+#include <stdint.h>
+
+/** Is element_a less than element_b? */
+typedef bool (*pmt_da_less_than_t)(void *element_a, void *element_b);
+
+/** Extract an unsigned key from the element, used for radix sorting. */
+typedef uint64_t (*pmt_da_radix_key_t)(void *element);
+
+/**
+ * Sort the array in place with introsort O(n log n).  Partitions smaller 
+ * than a small threshold are finished with insertion sort, and heapsort is 
+ * used if the partitioning degenerates.  The sort is not stable.
+ */
+void pmt_da_sort(
+        pmt_da_iface_t *iface, 
+        void *array, 
+        pmt_da_less_than_t less_than);
+
+/**
+ * Sort the array with a bottom-up merge sort O(n log n), preserving the 
+ * relative order of equal elements.  A temporary buffer of the array's size 
+ * is obtained from the array's allocator.
+ * 
+ * @returns A value of 'false' is returned if there was a memory allocation
+ * error, in which case the array is left unmodified.
+ */
+bool pmt_da_stable_sort(
+        pmt_da_iface_t *iface, 
+        void *array, 
+        pmt_da_less_than_t less_than);
+
+/**
+ * Sort the array by the unsigned keys extracted with 'key' using an LSD 
+ * radix sort O(n), one byte per pass.  Each key is extracted once and passes 
+ * over bytes that are equal for every key are skipped, so narrow keys cost 
+ * fewer passes.  The sort is stable.  Temporary buffers for the elements and
+ * keys are obtained from the array's allocator.
+ * 
+ * @returns A value of 'false' is returned if there was a memory allocation
+ * error, in which case the array is left unmodified.
+ */
+bool pmt_da_radix_sort(
+        pmt_da_iface_t *iface, 
+        void *array, 
+        pmt_da_radix_key_t key);
+
+/**
+ * Map a signed integer to a radix key with the same ordering.
+ */
+uint64_t pmt_da_radix_i64(const int64_t value);
+
+/**
+ * Map a double to a radix key with the same ordering, negative zero sorts 
+ * before positive zero.  Floats may be widened to double first.
+ */
+uint64_t pmt_da_radix_f64(const double value);
+
+/**
+ * Find the first element of a sorted array that is not less than 'key' 
+ * O(log n).  The search is branchless, so its loop has no data dependent 
+ * branches to mispredict.
+ * 
+ * @returns The index of the element, or the array's size if every element 
+ * is less than 'key'.
+ */
+size_t pmt_da_lower_bound(
+        pmt_da_iface_t *iface, 
+        void *array, 
+        void *key,
+        pmt_da_less_than_t less_than);
+
+/**
+ * Find the first element of a sorted array that is greater than 'key' 
+ * O(log n).  The search is branchless.
+ * 
+ * @returns The index of the element, or the array's size if no element is
+ * greater than 'key'.
+ */
+size_t pmt_da_upper_bound(
+        pmt_da_iface_t *iface, 
+        void *array, 
+        void *key,
+        pmt_da_less_than_t less_than);
+
+#endif
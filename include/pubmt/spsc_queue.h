@@ -0,0 +1,99 @@
+#ifndef PUBMT_SPSC_QUEUE_H
+#define PUBMT_SPSC_QUEUE_H
+
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+
+#define PMT_SPSC_CACHE_LINE 64
+
+/**
+ * Wait-Free Single-Producer/Single-Consumer Ring Queue
+ *
+ * Exactly one thread may enqueue and exactly one thread may dequeue.  The
+ * head and tail are free running counters on separate cache lines, and each
+ * side keeps a private copy of the other side's counter which is only
+ * reloaded when the queue looks full (or empty), so the shared lines are
+ * rarely touched.  Instances are cache line aligned, a heap allocated queue
+ * should come from aligned_alloc.
+ */
+typedef struct pmt_spsc_queue {
+
+        void *buffer;
+
+        /* capacity - 1, the capacity being a power of two */
+        size_t mask, element_size;
+
+        /* written by the producer */
+        _Alignas(PMT_SPSC_CACHE_LINE) atomic_size_t tail;
+        size_t cached_head;
+
+        /* written by the consumer */
+        _Alignas(PMT_SPSC_CACHE_LINE) atomic_size_t head;
+        size_t cached_tail;
+
+} pmt_spsc_queue_t;
+
+/**
+ * Initialize an empty queue over the given buffer, which must hold
+ * 'capacity' elements of 'element_size' bytes.  The capacity must be a
+ * power of two.
+ *
+ * @returns A pointer to the queue is returned.
+ */
+pmt_spsc_queue_t *pmt_spsc_init(
+        pmt_spsc_queue_t *queue,
+        void *buffer,
+        const size_t capacity,
+        const size_t element_size);
+
+/**
+ * Enqueue up to nelems contiguous elements, producer only.  The elements
+ * are published with a single release store.
+ *
+ * @returns The number of elements enqueued, which is less than nelems when
+ * the queue is full.
+ */
+size_t pmt_spsc_enqueue(
+        pmt_spsc_queue_t *queue,
+        const void *elements,
+        const size_t nelems);
+
+/**
+ * Dequeue up to nelems elements into 'elements', consumer only.
+ *
+ * @returns The number of elements dequeued, which is less than nelems when
+ * the queue runs empty.
+ */
+size_t pmt_spsc_dequeue(
+        pmt_spsc_queue_t *queue,
+        void *elements,
+        const size_t nelems);
+
+/**
+ * Enqueue a single element, producer only.
+ *
+ * @returns A value of 'false' is returned when the queue is full.
+ */
+bool pmt_spsc_push(pmt_spsc_queue_t *queue, const void *element);
+
+/**
+ * Dequeue a single element, consumer only.  If element is not NULL, then it
+ * will receive a copy of the element's contents.
+ *
+ * @returns A value of 'false' is returned when the queue is empty.
+ */
+bool pmt_spsc_pop(pmt_spsc_queue_t *queue, void *element);
+
+/**
+ * Get the number of queued elements.  The value may be stale by the time it
+ * is returned when the other side is active.
+ */
+size_t pmt_spsc_size(pmt_spsc_queue_t *queue);
+
+/**
+ * Get the capacity of the queue in elements.
+ */
+size_t pmt_spsc_capacity(pmt_spsc_queue_t *queue);
+
+#endif
@@ -0,0 +1,181 @@
+#ifndef PUBMT_THREAD_POOL_H
+#define PUBMT_THREAD_POOL_H
+
+#include "pubmt/mpmc_queue.h"
+#include <pthread.h>
+
+/** Tasks each worker's deque holds, a power of two. */
+#define PMT_TP_DEQUE_CAPACITY 1024
+
+/** Tasks the pool's injection queue holds, a power of two. */
+#define PMT_TP_INJECT_CAPACITY 1024
+
+/** Fruitless searches for work before an idle worker sleeps. */
+#define PMT_TP_IDLE_ROUNDS 64
+
+/** Workers are laid out in whole cache lines of this many bytes. */
+#define PMT_TP_CACHE_LINE 64
+
+/** Run a task. */
+typedef void (*pmt_tp_run_t)(void *arg);
+
+/** Run the loop body over [begin, end). */
+typedef void (*pmt_tp_body_t)(
+        const size_t begin,
+        const size_t end,
+        void *state);
+
+/** Tasks which can be waited for together. */
+typedef struct pmt_tp_group {
+
+        atomic_size_t pending;
+
+} pmt_tp_group_t;
+
+/** Task, owned by the caller until its group has been waited for. */
+typedef struct pmt_tp_task {
+
+        pmt_tp_run_t run;
+
+        void *arg;
+
+        pmt_tp_group_t *group;
+
+} pmt_tp_task_t;
+
+typedef struct pmt_tp_pool pmt_tp_pool_t;
+
+/**
+ * Worker Thread
+ *
+ * Each worker owns a Chase-Lev deque, pushing and taking spawned tasks at
+ * the bottom while idle threads steal from the top.  The thieves' index and
+ * the owner's fields each fill a cache line, and the pool's worker array is
+ * cache line aligned, so no two of these lines are shared.
+ */
+typedef struct pmt_tp_worker {
+
+        union {
+                atomic_llong top;
+                unsigned char top_line[PMT_TP_CACHE_LINE];
+        };
+
+        union {
+                struct {
+                        atomic_llong bottom;
+
+                        _Atomic(pmt_tp_task_t*) *tasks;
+
+                        pmt_tp_pool_t *pool;
+
+                        /* victim selection */
+                        unsigned long long seed;
+
+                        pthread_t thread;
+                };
+                unsigned char owner_line[PMT_TP_CACHE_LINE];
+        };
+
+} pmt_tp_worker_t;
+
+/**
+ * Work-Stealing Thread Pool
+ *
+ * Tasks spawned from a worker go onto its own deque, tasks spawned from
+ * other threads go through a shared injection queue.  A worker waiting for
+ * a group runs queued tasks until the group completes, other threads sleep.
+ * Idle workers sleep on a condition variable after PMT_TP_IDLE_ROUNDS
+ * fruitless searches.
+ */
+struct pmt_tp_pool {
+
+        pmt_mpmc_queue_t inject;
+
+        /* cache line aligned within 'worker_memory' */
+        pmt_tp_worker_t *workers;
+
+        void *worker_memory;
+
+        size_t nworkers;
+
+        pthread_mutex_t lock;
+        pthread_cond_t wake, done;
+
+        /* bumped under the lock whenever sleepers should look for work */
+        atomic_uint epoch;
+
+        atomic_size_t sleepers;
+
+        /* threads outside the pool waiting for a group */
+        atomic_size_t waiters;
+
+        atomic_bool stop;
+
+        pmt_da_free_t free;
+        void *alloc_state;
+
+};
+
+/**
+ * Create a pool of nworkers threads, its deques and queues being allocated
+ * with 'alloc'.
+ *
+ * @returns A pointer to the pool, or NULL if memory allocation or thread
+ * creation failed.
+ */
+pmt_tp_pool_t *pmt_tp_create(
+        pmt_tp_pool_t *pool,
+        const size_t nworkers,
+        pmt_da_alloc_t alloc,
+        pmt_da_free_t free,
+        void *alloc_state);
+
+/**
+ * Stop and join the workers, then free the pool's memory.  Every group must
+ * have been waited for.
+ */
+void pmt_tp_destroy(pmt_tp_pool_t *pool);
+
+/**
+ * Get the number of worker threads.
+ */
+size_t pmt_tp_size(pmt_tp_pool_t *pool);
+
+/**
+ * Initialize an empty task group.
+ *
+ * @returns A pointer to the group is returned.
+ */
+pmt_tp_group_t *pmt_tp_group_init(pmt_tp_group_t *group);
+
+/**
+ * Spawn run(arg) as part of the group.  The task is run immediately on the
+ * calling thread if the queue it would go onto is full.
+ */
+void pmt_tp_spawn(
+        pmt_tp_pool_t *pool,
+        pmt_tp_group_t *group,
+        pmt_tp_task_t *task,
+        pmt_tp_run_t run,
+        void *arg);
+
+/**
+ * Wait for every task in the group.  Workers of the pool run queued tasks
+ * meanwhile.
+ */
+void pmt_tp_wait(pmt_tp_pool_t *pool, pmt_tp_group_t *group);
+
+/**
+ * Run body over [begin, end), split in halves down to ranges of at most
+ * 'grain' indices which are spread over the pool by work stealing.  The
+ * calling thread takes part and returns once every range is done.
+ */
+void pmt_tp_parallel_for(
+        pmt_tp_pool_t *pool,
+        const size_t begin,
+        const size_t end,
+        const size_t grain,
+        pmt_tp_body_t body,
+        void *state);
+
+#endif
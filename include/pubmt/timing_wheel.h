@@ -0,0 +1,154 @@
+#ifndef PUBMT_TIMING_WHEEL_H
+#define PUBMT_TIMING_WHEEL_H
+
+#include "pubmt/linked_list.h"
+#include <stdint.h>
+
+/* each level resolves 6 bits of the expiry tick */
+#define PMT_TW_BITS 6
+#define PMT_TW_SLOTS 64
+#define PMT_TW_LEVELS 11
+
+/* slot of a timer that is not scheduled */
+#define PMT_TW_NONE SIZE_MAX
+
+/** Called for every expired timer, which is no longer scheduled. */
+typedef void (*pmt_tw_expire_t)(void *timer, void *state);
+
+/**
+ * Timer Node Callback Interface
+ *
+ * Slots are doubly linked lists, the 'next' link comes from the linked list
+ * node interface and the 'prev' link of the first timer in a slot is NULL.
+ * The wheel records the slot of every timer so it can be cancelled in O(1).
+ */
+typedef struct pmt_tw_node_iface {
+
+        pmt_ll_node_iface_t list_iface;
+
+        void *(*get_prev)(void *timer);
+        void (*set_prev)(void *timer, void *prev);
+
+        uint64_t (*get_expiry)(void *timer);
+        void (*set_expiry)(void *timer, const uint64_t expiry);
+
+        size_t (*get_slot)(void *timer);
+        void (*set_slot)(void *timer, const size_t slot);
+
+} pmt_tw_node_iface_t;
+
+/**
+ * Hierarchical Timing Wheel
+ *
+ * A timer lives on the level of the highest 6-bit group in which its expiry
+ * differs from the current tick, in the slot numbered by that group of its
+ * expiry.  When the current tick reaches a slot of an upper level, the slot
+ * is cascaded and its timers move down to a lower level, so every timer is
+ * moved at most once per level.  Scheduling and cancelling are O(1), and
+ * advancing skips empty slots with a per level occupancy mask.  Timers whose
+ * expiry is not after the current tick are due, they expire on the next
+ * advance.
+ */
+typedef struct pmt_tw_wheel {
+
+        void *slots[PMT_TW_LEVELS * PMT_TW_SLOTS];
+
+        /* bit 's' is set if slot 's' of the level is non-empty */
+        uint64_t occupied[PMT_TW_LEVELS];
+
+        /* timers due on the next advance, and those expiring right now */
+        void *due, *firing;
+
+        uint64_t now;
+
+        size_t size;
+
+} pmt_tw_wheel_t;
+
+/**
+ * Validate the timer node interface.
+ *
+ * @returns Will return 'false' if any callbacks are NULL.
+ */
+bool pmt_tw_node_iface_validate(pmt_tw_node_iface_t *iface);
+
+/**
+ * Initialize an empty wheel whose current tick is 'now'.
+ *
+ * @returns A pointer to 'wheel'.
+ */
+pmt_tw_wheel_t *pmt_tw_init(
+        pmt_tw_node_iface_t *iface,
+        pmt_tw_wheel_t *wheel,
+        const uint64_t now);
+
+/**
+ * Mark a timer as not scheduled.  Every timer must be initialized before it
+ * is first scheduled.
+ */
+void pmt_tw_timer_init(pmt_tw_node_iface_t *iface, void *timer);
+
+/**
+ * Is the timer scheduled on a wheel?
+ */
+bool pmt_tw_is_scheduled(pmt_tw_node_iface_t *iface, void *timer);
+
+/**
+ * Get the number of scheduled timers O(1).
+ */
+size_t pmt_tw_size(pmt_tw_node_iface_t *iface, pmt_tw_wheel_t *wheel);
+
+/**
+ * Get the current tick of the wheel.
+ */
+uint64_t pmt_tw_now(pmt_tw_node_iface_t *iface, pmt_tw_wheel_t *wheel);
+
+/**
+ * Schedule the timer to expire at the 'expiry' tick O(1).  A timer which is
+ * already scheduled on the wheel is rescheduled.
+ */
+void pmt_tw_schedule(
+        pmt_tw_node_iface_t *iface,
+        pmt_tw_wheel_t *wheel,
+        void *timer,
+        const uint64_t expiry);
+
+/**
+ * Cancel the timer O(1).
+ *
+ * @returns A value of 'false' is returned if the timer was not scheduled.
+ */
+bool pmt_tw_cancel(
+        pmt_tw_node_iface_t *iface,
+        pmt_tw_wheel_t *wheel,
+        void *timer);
+
+/**
+ * Get the earliest tick at which an advance may expire timers.  This is a
+ * lower bound, timers on upper levels are only known to the granularity of
+ * their slot.
+ *
+ * @returns A value of 'false' is returned if the wheel is empty.
+ */
+bool pmt_tw_next_tick(
+        pmt_tw_node_iface_t *iface,
+        pmt_tw_wheel_t *wheel,
+        uint64_t *tick);
+
+/**
+ * Advance the current tick to 'now', cascading slots and calling 'expire'
+ * for every timer whose expiry is at most 'now'.  Due timers expire first,
+ * the others in order of expiry.  Timers are unscheduled before the callback,
+ * which may schedule, cancel or free any timer.  Timers it schedules at or 
+ * before the current tick expire on the next advance.
+ *
+ * @returns The number of expired timers.
+ */
+size_t pmt_tw_advance(
+        pmt_tw_node_iface_t *iface,
+        pmt_tw_wheel_t *wheel,
+        const uint64_t now,
+        pmt_tw_expire_t expire,
+        void *state);
+
+#endif
@@ -0,0 +1,82 @@
+#ifndef PUBMT_TREIBER_STACK_H
+#define PUBMT_TREIBER_STACK_H
+
+#include "pubmt/linked_list.h"
+#include <stdint.h>
+#include <stdatomic.h>
+
+#define PMT_TS_CACHE_LINE 64
+
+/** Top of the stack, the tag changes with every update. */
+typedef struct pmt_ts_top {
+
+        void *node;
+
+        uintptr_t tag;
+
+} pmt_ts_top_t;
+
+/**
+ * Lock-Free Intrusive Stack
+ *
+ * Nodes are linked through their own next pointer, as described by a
+ * pmt_ll_node_iface_t.  The top is a pointer and tag pair updated with a
+ * double width compare-and-swap, so a pop racing with a pop and re-push of
+ * the same node fails rather than installing a stale next pointer (the ABA
+ * problem).  Linking may require -latomic.
+ *
+ * A popping thread may read the next pointer of a node that another thread
+ * has just popped, so popped nodes must stay readable, e.g. by being
+ * recycled through the stack rather than returned to the system, and
+ * get_next and set_next must perform single aligned word sized accesses.
+ */
+typedef struct pmt_ts_stack {
+
+        _Alignas(PMT_TS_CACHE_LINE) _Atomic(pmt_ts_top_t) top;
+
+} pmt_ts_stack_t;
+
+/**
+ * Initialize an empty stack.
+ *
+ * @returns A pointer to the stack is returned.
+ */
+pmt_ts_stack_t *pmt_ts_init(pmt_ts_stack_t *stack);
+
+/**
+ * Push an unlinked node onto the stack.
+ */
+void pmt_ts_push(pmt_ll_node_iface_t *iface, pmt_ts_stack_t *stack, void *node);
+
+/**
+ * Push a linked list of nodes, from 'first' through 'last', onto the stack
+ * with a single update.  The first node ends up on top.
+ */
+void pmt_ts_push_list(
+        pmt_ll_node_iface_t *iface,
+        pmt_ts_stack_t *stack,
+        void *first,
+        void *last);
+
+/**
+ * Pop the top node from the stack.
+ *
+ * @returns The popped node, which is unlinked, or NULL if the stack was
+ * empty.
+ */
+void *pmt_ts_pop(pmt_ll_node_iface_t *iface, pmt_ts_stack_t *stack);
+
+/**
+ * Take every node from the stack at once O(1).
+ *
+ * @returns The former top of the stack, a NULL terminated list in pop
+ * order, or NULL if the stack was empty.
+ */
+void *pmt_ts_pop_all(pmt_ts_stack_t *stack);
+
+/**
+ * Is the stack empty?  The answer may be stale by the time it is returned.
+ */
+bool pmt_ts_is_empty(pmt_ts_stack_t *stack);
+
+#endif
@@ -6,31 +6,66 @@
 
 bool pmt_bh_iface_validate(pmt_bh_iface_t *iface)
 {
-        return 
-                iface && 
-                iface->get_less_than && 
-                iface->get_swap &&
+        return
+                iface &&
+                iface->get_less_than &&
                 pmt_da_iface_validate(&iface->array_iface);
 }
 
-static void *pmt_bh_heapify_up(
-        pmt_bh_less_than_t cmp,
-        pmt_bh_swap_t swap,
-        void *buffer,
-        const size_t elem_size,
-        size_t index) 
+/* The callbacks and metrics used while sifting. */
+typedef struct pmt_bh_sift {
+
+        pmt_bh_less_than_t cmp;
+        pmt_bh_swap_t swap;
+        pmt_bh_set_index_t set_index;
+
+        uint8_t *buffer;
+        size_t elem_size, arity;
+
+} pmt_bh_sift_t;
+
+static void pmt_bh_sift_init(
+        pmt_bh_iface_t *iface,
+        void *heap,
+        pmt_bh_sift_t *sift)
+{
+        pmt_da_iface_t *a_iface = &iface->array_iface;
+
+        sift->cmp = iface->get_less_than(heap);
+        sift->swap = iface->get_swap ? iface->get_swap(heap) : NULL;
+        sift->set_index =
+                iface->get_set_index ? iface->get_set_index(heap) : NULL;
+        sift->buffer = a_iface->get_buffer(heap);
+        sift->elem_size = a_iface->get_element_size(heap);
+        sift->arity = iface->get_arity ? iface->get_arity(heap) : 2;
+
+        assert(sift->arity >= 2);
+}
+
+static void pmt_bh_moved(pmt_bh_sift_t *sift, void *pointer, size_t index)
+{
+        if(sift->set_index) {
+                sift->set_index(pointer, index);
+        }
+}
+
+static void *pmt_bh_heapify_up(pmt_bh_sift_t *sift, size_t index)
 {
-        uint8_t *b = buffer;
+        const pmt_bh_less_than_t cmp = sift->cmp;
+        const size_t elem_size = sift->elem_size;
+
+        uint8_t *b = sift->buffer;
 
         void *index_ptr = b + index * elem_size;
 
         while(index > 0) {
 
-                const size_t parent = (index - 1) / 2;
+                const size_t parent = (index - 1) / sift->arity;
                 void *parent_ptr = b + parent * elem_size;
 
                 if(cmp(index_ptr, parent_ptr)) {
-                        swap(index_ptr, parent_ptr);
+                        sift->swap(index_ptr, parent_ptr);
+                        pmt_bh_moved(sift, index_ptr, index);
                         index = parent;
                         index_ptr = parent_ptr;
                 } else {
@@ -38,26 +73,28 @@ static void *pmt_bh_heapify_up(
                 }
         }
 
+        pmt_bh_moved(sift, index_ptr, index);
+
         return index_ptr;
 }
 
-static void pmt_bh_heapify_down(
-        pmt_bh_less_than_t cmp,
-        pmt_bh_swap_t swap,
-        void *buffer,
-        const size_t elem_size,
+static void *pmt_bh_heapify_down(
+        pmt_bh_sift_t *sift,
         const size_t heap_size,
-        size_t index) 
+        size_t index)
 {
-        uint8_t *b = buffer;
+        const pmt_bh_less_than_t cmp = sift->cmp;
+        const size_t elem_size = sift->elem_size;
 
-        void    
+        uint8_t *b = sift->buffer;
+
+        void
                 *index_ptr = b + index * elem_size,
                 *min_ptr = index_ptr;
 
         for(;;) {
 
-                size_t  
+                size_t
                         left = 2 * index + 1,
                         right = 2 * index + 2,
                         min = index;
@@ -69,7 +106,7 @@ static void pmt_bh_heapify_down(
                                 min_ptr = left_ptr;
                                 goto BRANCH_A;
                         }
-                } 
+                }
 
                 if(right < heap_size) {
                         void *right_ptr = b + right * elem_size;
@@ -77,9 +114,9 @@ static void pmt_bh_heapify_down(
                                 min = right;
                                 min_ptr = right_ptr;
                                 goto BRANCH_B;
-                        } 
+                        }
                 }
-                
+
                 break;
 
                 BRANCH_A:
@@ -94,11 +131,204 @@ static void pmt_bh_heapify_down(
 
                 BRANCH_B:
 
-                swap(index_ptr, min_ptr);
+                sift->swap(index_ptr, min_ptr);
+                pmt_bh_moved(sift, index_ptr, index);
 
                 index = min;
                 index_ptr = min_ptr;
         }
+
+        pmt_bh_moved(sift, index_ptr, index);
+
+        return index_ptr;
+}
+
+static void *pmt_bh_heapify_down_dary(
+        pmt_bh_sift_t *sift,
+        const size_t heap_size,
+        size_t index)
+{
+        const pmt_bh_less_than_t cmp = sift->cmp;
+        const size_t
+                elem_size = sift->elem_size,
+                arity = sift->arity;
+
+        uint8_t *b = sift->buffer;
+
+        void *index_ptr = b + index * elem_size;
+
+        /* stop before 'arity * index + 1' can overflow */
+        const size_t last_parent = (heap_size - 2) / arity;
+
+        while(heap_size > 1 && index <= last_parent) {
+
+                const size_t
+                        first = arity * index + 1,
+                        end = heap_size - first < arity ?
+                                heap_size : first + arity;
+
+                size_t min = first;
+                void *min_ptr = b + first * elem_size;
+
+                for(size_t child = first + 1; child < end; ++child) {
+                        void *child_ptr = b + child * elem_size;
+                        if(cmp(child_ptr, min_ptr)) {
+                                min = child;
+                                min_ptr = child_ptr;
+                        }
+                }
+
+                if(!cmp(min_ptr, index_ptr)) {
+                        break;
+                }
+
+                sift->swap(index_ptr, min_ptr);
+                pmt_bh_moved(sift, index_ptr, index);
+
+                index = min;
+                index_ptr = min_ptr;
+        }
+
+        pmt_bh_moved(sift, index_ptr, index);
+
+        return index_ptr;
+}
+
+/*
+ * Hole-based sifting is used when the interface has no swap callback.  The
+ * moving element 'value' lives outside of the sifted path, each step moves a
+ * single parent or child into the hole and 'value' is written once at the end.
+ */
+
+static void *pmt_bh_sift_up_hole(
+        pmt_bh_sift_t *sift,
+        size_t index,
+        void *value)
+{
+        const pmt_bh_less_than_t cmp = sift->cmp;
+        const size_t elem_size = sift->elem_size;
+
+        uint8_t *b = sift->buffer;
+
+        void *index_ptr = b + index * elem_size;
+
+        while(index > 0) {
+
+                const size_t parent = (index - 1) / sift->arity;
+                void *parent_ptr = b + parent * elem_size;
+
+                if(!cmp(value, parent_ptr)) {
+                        break;
+                }
+
+                (void)memcpy(index_ptr, parent_ptr, elem_size);
+                pmt_bh_moved(sift, index_ptr, index);
+
+                index = parent;
+                index_ptr = parent_ptr;
+        }
+
+        (void)memcpy(index_ptr, value, elem_size);
+        pmt_bh_moved(sift, index_ptr, index);
+
+        return index_ptr;
+}
+
+static void *pmt_bh_sift_down_hole(
+        pmt_bh_sift_t *sift,
+        const size_t heap_size,
+        size_t index,
+        void *value)
+{
+        const pmt_bh_less_than_t cmp = sift->cmp;
+        const size_t
+                elem_size = sift->elem_size,
+                arity = sift->arity;
+
+        uint8_t *b = sift->buffer;
+
+        void *index_ptr = b + index * elem_size;
+
+        /* stop before 'arity * index + 1' can overflow */
+        const size_t last_parent = (heap_size - 2) / arity;
+
+        while(heap_size > 1 && index <= last_parent) {
+
+                const size_t
+                        first = arity * index + 1,
+                        end = heap_size - first < arity ?
+                                heap_size : first + arity;
+
+                size_t min = first;
+                void *min_ptr = b + first * elem_size;
+
+                for(size_t child = first + 1; child < end; ++child) {
+                        void *child_ptr = b + child * elem_size;
+                        if(cmp(child_ptr, min_ptr)) {
+                                min = child;
+                                min_ptr = child_ptr;
+                        }
+                }
+
+                if(!cmp(min_ptr, value)) {
+                        break;
+                }
+
+                (void)memcpy(index_ptr, min_ptr, elem_size);
+                pmt_bh_moved(sift, index_ptr, index);
+
+                index = min;
+                index_ptr = min_ptr;
+        }
+
+        (void)memcpy(index_ptr, value, elem_size);
+        pmt_bh_moved(sift, index_ptr, index);
+
+        return index_ptr;
+}
+
+static void *pmt_bh_sift_down(
+        pmt_bh_sift_t *sift,
+        const size_t heap_size,
+        const size_t index)
+{
+        if(sift->arity == 2) {
+                return pmt_bh_heapify_down(sift, heap_size, index);
+        } else {
+                return pmt_bh_heapify_down_dary(sift, heap_size, index);
+        }
+}
+
+/*
+ * Restore the heap property for the element at 'index', sifting it up or
+ * down.  In hole mode, 'value' is written into the hole at 'index' and must
+ * lie outside of the first 'heap_size' elements.
+ */
+static void *pmt_bh_sift(
+        pmt_bh_sift_t *sift,
+        const size_t heap_size,
+        const size_t index,
+        void *value)
+{
+        uint8_t *b = sift->buffer;
+
+        void *pointer = sift->swap ? b + index * sift->elem_size : value;
+
+        const bool up =
+                index > 0 &&
+                sift->cmp(
+                        pointer,
+                        b + ((index - 1) / sift->arity) * sift->elem_size);
+
+        if(sift->swap) {
+                return up ?
+                        pmt_bh_heapify_up(sift, index) :
+                        pmt_bh_sift_down(sift, heap_size, index);
+        } else {
+                return up ?
+                        pmt_bh_sift_up_hole(sift, index, value) :
+                        pmt_bh_sift_down_hole(sift, heap_size, index, value);
+        }
 }
 
 void *pmt_bh_insert(pmt_bh_iface_t *iface, void *heap, void *elem)
@@ -106,62 +336,322 @@ void *pmt_bh_insert(pmt_bh_iface_t *iface, void *heap, void *elem)
         assert(heap && elem && pmt_bh_iface_validate(iface));
 
         pmt_da_iface_t *a_iface = &iface->array_iface;
-        
+
         const size_t index = a_iface->get_size(heap);
 
-        if(!pmt_da_push_back(a_iface, heap, elem)) {
+        if(!pmt_da_push_back(a_iface, heap, iface->get_swap ? elem : NULL)) {
                 return NULL;
         }
-       
-        return pmt_bh_heapify_up( 
-                iface->get_less_than(heap),
-                iface->get_swap(heap),
-                a_iface->get_buffer(heap),
-                a_iface->get_element_size(heap),
-                index);
+
+        pmt_bh_sift_t sift;
+        pmt_bh_sift_init(iface, heap, &sift);
+
+        if(!sift.swap) {
+                return pmt_bh_sift_up_hole(&sift, index, elem);
+        }
+
+        return pmt_bh_heapify_up(&sift, index);
 }
 
 bool pmt_bh_pop(pmt_bh_iface_t *iface, void *heap, void *elem)
+{
+        return pmt_bh_remove_at(iface, heap, 0, elem);
+}
+
+void *pmt_bh_peek(pmt_bh_iface_t *iface, void *heap)
+{
+        assert(heap);
+        assert(iface);
+        return pmt_da_first(&iface->array_iface, heap);
+}
+
+void *pmt_bh_update(pmt_bh_iface_t *iface, void *heap, const size_t index)
 {
         assert(heap && pmt_bh_iface_validate(iface));
 
         pmt_da_iface_t *a_iface = &iface->array_iface;
 
-        const size_t elem_size = a_iface->get_element_size(heap);
+        const size_t size = a_iface->get_size(heap);
+
+        if(index >= size) {
+                return NULL;
+        }
 
-        void    
-                *first = pmt_da_first(a_iface, heap),
-                *last = pmt_da_last(a_iface, heap);
+        pmt_bh_sift_t sift;
 
-        if(!first) {
+        if(iface->get_swap) {
+                pmt_bh_sift_init(iface, heap, &sift);
+                return pmt_bh_sift(&sift, size, index, NULL);
+        }
+
+        /* lift the element into a scratch slot past the end of the heap */
+
+        uint8_t *scratch = pmt_da_push_back(a_iface, heap, NULL);
+        if(!scratch) {
+                return NULL;
+        }
+
+        pmt_bh_sift_init(iface, heap, &sift);
+
+        (void)memcpy(
+                scratch,
+                sift.buffer + index * sift.elem_size,
+                sift.elem_size);
+
+        void *pointer = pmt_bh_sift(&sift, size, index, scratch);
+
+        (void)pmt_da_pop_back(a_iface, heap, NULL);
+
+        return pointer;
+}
+
+bool pmt_bh_remove_at(
+        pmt_bh_iface_t *iface,
+        void *heap,
+        const size_t index,
+        void *elem)
+{
+        assert(heap && pmt_bh_iface_validate(iface));
+
+        pmt_da_iface_t *a_iface = &iface->array_iface;
+
+        const size_t size = a_iface->get_size(heap);
+
+        if(index >= size) {
                 return false;
         }
 
+        pmt_bh_sift_t sift;
+        pmt_bh_sift_init(iface, heap, &sift);
+
+        uint8_t
+                *pointer = sift.buffer + index * sift.elem_size,
+                *last = sift.buffer + (size - 1) * sift.elem_size;
+
         if(elem) {
-                (void)memcpy(elem, first, elem_size);
+                (void)memcpy(elem, pointer, sift.elem_size);
         }
 
-        if(first == last) {
-                pmt_da_clear(a_iface, heap);
+        if(pointer == last) {
+                (void)pmt_da_pop_back(a_iface, heap, NULL);
                 return true;
         }
 
-        (void)pmt_da_pop_back(a_iface, heap, first);
-        
-        pmt_bh_heapify_down( 
-                iface->get_less_than(heap),
-                iface->get_swap(heap),
-                a_iface->get_buffer(heap),
-                a_iface->get_element_size(heap),
-                a_iface->get_size(heap),
-                0);
+        if(!sift.swap) {
+
+                /* the last element stays in place until it is sifted */
+
+                (void)pmt_bh_sift(&sift, size - 1, index, last);
+                (void)pmt_da_pop_back(a_iface, heap, NULL);
+
+                return true;
+        }
+
+        (void)pmt_da_pop_back(a_iface, heap, pointer);
+
+        (void)pmt_bh_sift(&sift, size - 1, index, NULL);
 
         return true;
 }
 
-void *pmt_bh_peek(pmt_bh_iface_t *iface, void *heap)
+/*
+ * Sift down every parent, from the last one to the root, in O(n).  Leaves
+ * never move, so only their indexes are reported up front.
+ */
+static bool pmt_bh_heapify_all(pmt_bh_iface_t *iface, void *heap)
 {
-        assert(heap);
-        assert(iface);
-        return pmt_da_first(&iface->array_iface, heap);
+        pmt_da_iface_t *a_iface = &iface->array_iface;
+
+        const size_t size = a_iface->get_size(heap);
+
+        uint8_t *scratch = NULL;
+
+        if(size > 1 && !iface->get_swap) {
+                scratch = pmt_da_push_back(a_iface, heap, NULL);
+                if(!scratch) {
+                        return false;
+                }
+        }
+
+        pmt_bh_sift_t sift;
+        pmt_bh_sift_init(iface, heap, &sift);
+
+        const size_t first_leaf = size > 1 ? (size - 2) / sift.arity + 1 : 0;
+
+        for(size_t x = first_leaf; x < size; ++x) {
+                pmt_bh_moved(&sift, sift.buffer + x * sift.elem_size, x);
+        }
+
+        for(size_t x = first_leaf; x-- > 0;) {
+                if(scratch) {
+                        (void)memcpy(
+                                scratch,
+                                sift.buffer + x * sift.elem_size,
+                                sift.elem_size);
+                        (void)pmt_bh_sift_down_hole(&sift, size, x, scratch);
+                } else {
+                        (void)pmt_bh_sift_down(&sift, size, x);
+                }
+        }
+
+        if(scratch) {
+                (void)pmt_da_pop_back(a_iface, heap, NULL);
+        }
+
+        return true;
+}
+
+bool pmt_bh_heapify(pmt_bh_iface_t *iface, void *heap)
+{
+        assert(heap && pmt_bh_iface_validate(iface));
+
+        return pmt_bh_heapify_all(iface, heap);
+}
+
+bool pmt_bh_build(
+        pmt_bh_iface_t *iface,
+        void *heap,
+        void *elems,
+        const size_t nelems)
+{
+        assert(heap && (elems || !nelems) && pmt_bh_iface_validate(iface));
+
+        pmt_da_iface_t *a_iface = &iface->array_iface;
+
+        pmt_da_clear(a_iface, heap);
+
+        if(!pmt_da_append_range(a_iface, heap, elems, nelems)) {
+                return false;
+        }
+
+        return pmt_bh_heapify_all(iface, heap);
+}
+
+bool pmt_bh_insert_many(
+        pmt_bh_iface_t *iface,
+        void *heap,
+        void *elems,
+        const size_t nelems)
+{
+        assert(heap && (elems || !nelems) && pmt_bh_iface_validate(iface));
+
+        if(!nelems) {
+                return true;
+        }
+
+        pmt_da_iface_t *a_iface = &iface->array_iface;
+
+        const size_t size = a_iface->get_size(heap);
+
+        /* without a swap callback, leave room for a scratch slot */
+
+        const size_t extra = iface->get_swap || nelems == SIZE_MAX ? 0 : 1;
+
+        uint8_t *pointer = pmt_da_push_back_n(a_iface, heap, nelems + extra);
+        if(!pointer) {
+                return false;
+        }
+
+        a_iface->set_size(heap, size + nelems);
+
+        pmt_bh_sift_t sift;
+        pmt_bh_sift_init(iface, heap, &sift);
+
+        const size_t total = size + nelems;
+
+        /*
+         * Sifting up costs at most one comparison per level for each new
+         * element, rebuilding costs a small constant per element of the heap.
+         */
+
+        size_t depth = 0;
+
+        for(size_t n = total; n > 1; n /= sift.arity) {
+                ++depth;
+        }
+
+        if(nelems * depth >= total) {
+                if(nelems) {
+                        (void)memcpy(pointer, elems, nelems * sift.elem_size);
+                }
+                return pmt_bh_heapify_all(iface, heap);
+        }
+
+        uint8_t *e = elems;
+
+        for(size_t x = 0; x < nelems; ++x) {
+                if(sift.swap) {
+                        (void)memcpy(
+                                pointer + x * sift.elem_size,
+                                e + x * sift.elem_size,
+                                sift.elem_size);
+                        (void)pmt_bh_heapify_up(&sift, size + x);
+                } else {
+                        (void)pmt_bh_sift_up_hole(
+                                &sift,
+                                size + x,
+                                e + x * sift.elem_size);
+                }
+        }
+
+        return true;
+}
+
+static void pmt_bh_replace_root(
+        pmt_bh_iface_t *iface,
+        void *heap,
+        void *elem,
+        void *out)
+{
+        pmt_bh_sift_t sift;
+        pmt_bh_sift_init(iface, heap, &sift);
+
+        const size_t size = iface->array_iface.get_size(heap);
+
+        if(out) {
+                (void)memcpy(out, sift.buffer, sift.elem_size);
+        }
+
+        if(sift.swap) {
+                (void)memcpy(sift.buffer, elem, sift.elem_size);
+                (void)pmt_bh_sift_down(&sift, size, 0);
+        } else {
+                (void)pmt_bh_sift_down_hole(&sift, size, 0, elem);
+        }
+}
+
+void pmt_bh_pushpop(pmt_bh_iface_t *iface, void *heap, void *elem, void *out)
+{
+        assert(heap && elem && elem != out && pmt_bh_iface_validate(iface));
+
+        void *first = pmt_da_first(&iface->array_iface, heap);
+
+        if(!first || !iface->get_less_than(heap)(first, elem)) {
+                if(out) {
+                        (void)memcpy(
+                                out,
+                                elem,
+                                iface->array_iface.get_element_size(heap));
+                }
+                return;
+        }
+
+        pmt_bh_replace_root(iface, heap, elem, out);
+}
+
+bool pmt_bh_replace_top(
+        pmt_bh_iface_t *iface,
+        void *heap,
+        void *elem,
+        void *out)
+{
+        assert(heap && elem && elem != out && pmt_bh_iface_validate(iface));
+
+        if(pmt_da_is_empty(&iface->array_iface, heap)) {
+                return false;
+        }
+
+        pmt_bh_replace_root(iface, heap, elem, out);
+
+        return true;
 }
@@ -19,7 +19,24 @@ bool pmt_da_iface_validate(pmt_da_iface_t *iface)
                 iface->set_capacity &&
                 iface->get_size &&
                 iface->set_size &&
-                iface->get_element_size;
+                iface->get_element_size &&
+                !iface->get_inline_buffer == !iface->get_inline_capacity;
+}
+
+bool pmt_da_has_inline(pmt_da_iface_t *iface, void *array)
+{
+        assert(array && pmt_da_iface_validate(iface));
+
+        return iface->get_inline_buffer != NULL;
+}
+
+bool pmt_da_is_inline(pmt_da_iface_t *iface, void *array)
+{
+        assert(array && pmt_da_iface_validate(iface));
+
+        return 
+                iface->get_inline_buffer && 
+                iface->get_buffer(array) == iface->get_inline_buffer(array);
 }
 
 void *pmt_da_init(
@@ -44,6 +61,18 @@ void *pmt_da_create(
         const size_t initial_capacity)
 {
         assert(array && pmt_da_iface_validate(iface));
+
+        if(pmt_da_has_inline(iface, array)) {
+                const size_t inline_cap = iface->get_inline_capacity(array);
+                if(initial_capacity <= inline_cap) {
+                        return pmt_da_init(
+                                iface, 
+                                array, 
+                                iface->get_inline_buffer(array), 
+                                0, 
+                                inline_cap);
+                }
+        }
    
         pmt_da_alloc_t alloc = iface->get_alloc(array);
         void *alloc_state = iface->get_alloc_state(array);
@@ -61,6 +90,10 @@ void pmt_da_destroy(pmt_da_iface_t *iface, void *array)
 {
         assert(array && pmt_da_iface_validate(iface));
 
+        if(pmt_da_is_inline(iface, array)) {
+                return;
+        }
+
         pmt_da_free_t free = iface->get_free(array);
         void *alloc_state = iface->get_alloc_state(array);
 
@@ -118,6 +151,65 @@ void *pmt_da_at(pmt_da_iface_t *iface, void *array, const size_t index)
         return bytes + index * element_size;
 }
 
+static bool pmt_da_resize_inline(
+        pmt_da_iface_t *iface, 
+        void *array, 
+        const size_t new_cap)
+{
+        const size_t 
+                elem_size = iface->get_element_size(array),
+                capacity = iface->get_capacity(array),
+                inline_cap = iface->get_inline_capacity(array);
+
+        void    
+                *st = iface->get_alloc_state(array),
+                *buffer = iface->get_buffer(array),
+                *inline_buf = iface->get_inline_buffer(array);
+
+        if(new_cap <= inline_cap) {
+                
+                /* Move back into the inline region, preserving contents as
+                   realloc would. */
+
+                if(buffer != inline_buf) {
+                        const size_t n = capacity < inline_cap ? 
+                                capacity : inline_cap;
+                        (void)memcpy(inline_buf, buffer, n * elem_size);
+                        iface->get_free(array)(buffer, st);
+                        iface->set_buffer(array, inline_buf);
+                }
+
+                iface->set_capacity(array, inline_cap);
+
+                return true;
+        }
+
+        void *new_buf = NULL;
+
+        if(buffer == inline_buf) {
+                new_buf = iface->get_alloc(array)(new_cap * elem_size, st);
+                if(!new_buf) {
+                        return false;
+                }
+                const size_t n = capacity < inline_cap ? 
+                        capacity : inline_cap;
+                (void)memcpy(new_buf, inline_buf, n * elem_size);
+        } else {
+                new_buf = iface->get_realloc(array)(
+                        buffer, 
+                        new_cap * elem_size, 
+                        st);
+                if(!new_buf) {
+                        return false;
+                }
+        }
+
+        iface->set_buffer(array, new_buf);
+        iface->set_capacity(array, new_cap);
+
+        return true;
+}
+
 bool pmt_da_resize(
         pmt_da_iface_t *iface, 
         void *array, 
@@ -129,6 +221,10 @@ bool pmt_da_resize(
                 return false;
         }
 
+        if(pmt_da_has_inline(iface, array)) {
+                return pmt_da_resize_inline(iface, array, new_cap);
+        }
+
         const size_t elem_size = iface->get_element_size(array);
         pmt_da_realloc_t realloc = iface->get_realloc(array);
         void *st = iface->get_alloc_state(array);
@@ -227,6 +323,23 @@ bool pmt_da_scale_capacity(
         return pmt_da_resize(iface, array, new_cap);
 }
 
+/* Grow the array once so it can hold want_cap elements. */
+static bool pmt_da_grow(
+        pmt_da_iface_t *iface, 
+        void *array, 
+        const size_t want_cap)
+{
+        const size_t capacity = iface->get_capacity(array);
+
+        if(want_cap <= capacity) {
+                return true;
+        } else if(!capacity) {
+                return pmt_da_resize(iface, array, want_cap);
+        }
+
+        return pmt_da_scale_capacity(iface, array, want_cap);
+}
+
 void *pmt_da_push_back(pmt_da_iface_t *iface, void *array, void *elem)
 {
         assert(array && pmt_da_iface_validate(iface));
@@ -239,7 +352,7 @@ void *pmt_da_push_back(pmt_da_iface_t *iface, void *array, void *elem)
         assert(size <= capacity);
 
         if(size >= capacity) {
-                if(!pmt_da_scale_capacity(iface, array, size + 1)) {
+                if(!pmt_da_grow(iface, array, size + 1)) {
                         return NULL;
                 }
         }
@@ -257,6 +370,78 @@ void *pmt_da_push_back(pmt_da_iface_t *iface, void *array, void *elem)
        return pointer;
 }
 
+void *pmt_da_push_back_n(
+        pmt_da_iface_t *iface, 
+        void *array, 
+        const size_t nelems)
+{
+        assert(array && pmt_da_iface_validate(iface));
+
+        const size_t    
+                size = iface->get_size(array),
+                new_size = size + nelems,
+                elem_size = iface->get_element_size(array);
+
+        if(!nelems) {
+                /* never offset an array without a buffer, NULL + 0 is UB */
+                uint8_t *buffer = iface->get_buffer(array);
+                return buffer ? buffer + size * elem_size : NULL;
+        } else if(new_size < size) {
+                return NULL;
+        } else if(new_size > iface->get_capacity(array)) {
+                if(!pmt_da_grow(iface, array, new_size)) {
+                        return NULL;
+                }
+        }
+
+        uint8_t *buffer = iface->get_buffer(array);
+
+        iface->set_size(array, new_size);
+
+        return buffer + size * elem_size;
+}
+
+bool pmt_da_append_range(
+        pmt_da_iface_t *iface, 
+        void *array, 
+        void *elems, 
+        const size_t nelems)
+{
+        assert(array && (elems || !nelems) && pmt_da_iface_validate(iface));
+
+        if(!nelems) {
+                return true;
+        }
+
+        void *pointer = pmt_da_push_back_n(iface, array, nelems);
+        if(!pointer) {
+                return false;
+        }
+
+        (void)memcpy(pointer, elems, nelems * iface->get_element_size(array));
+
+        return true;
+}
+
+void *pmt_da_emplace_back_n(
+        pmt_da_iface_t *iface, 
+        void *array, 
+        const size_t nelems,
+        void (*init)(void *elements, const size_t nelems, void *state),
+        void *state)
+{
+        assert(array && init && pmt_da_iface_validate(iface));
+
+        void *pointer = pmt_da_push_back_n(iface, array, nelems);
+        if(!pointer || !nelems) {
+                return pointer;
+        }
+
+        init(pointer, nelems, state);
+
+        return pointer;
+}
+
 bool pmt_da_pop_back(pmt_da_iface_t *iface, void *array, void *elem)
 {
         assert(array && pmt_da_iface_validate(iface));
@@ -324,10 +509,12 @@ bool pmt_da_insert_range(
                 cap = iface->get_capacity(array),
                 new_size = size + nelems;
         
-        assert(index < size);
+        assert(index <= size);
 
-        if(new_size > cap) {
-                if(!pmt_da_scale_capacity(iface, array, new_size)) {
+        if(new_size < size) {
+                return false;
+        } else if(new_size > cap) {
+                if(!pmt_da_grow(iface, array, new_size)) {
                         return false;
                 }
         }
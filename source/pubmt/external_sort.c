@@ -0,0 +1,647 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "pubmt/external_sort.h"
+#include "pubmt/binary_heap.h"
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <assert.h>
+#include <errno.h>
+#include <unistd.h>
+
+/** Default minimum bytes of read buffer per run. */
+#define PMT_ES_MERGE_BUFFER (256 * 1024)
+
+/** Sorted run, stored in an unlinked temporary file. */
+typedef struct pmt_es_run {
+
+        int fd;
+
+        size_t length;
+
+} pmt_es_run_t;
+
+/** Streaming cursor over a run. */
+typedef struct pmt_es_cursor {
+
+        pmt_da_less_than_t less_than;
+
+        uint8_t *buffer, *current, *end;
+
+        size_t capacity, element_size, remaining;
+
+        off_t offset;
+
+        int fd;
+
+} pmt_es_cursor_t;
+
+/** Binary heap of cursor pointers, allocated through the sorted array. */
+typedef struct pmt_es_heap {
+
+        size_t capacity, size;
+
+        void *buffer;
+
+        pmt_da_iface_t *iface;
+
+        void *array;
+
+} pmt_es_heap_t;
+
+static pmt_da_alloc_t pmt_es_get_alloc(void *heap)
+{
+        pmt_es_heap_t *h = heap;
+        return h->iface->get_alloc(h->array);
+}
+
+static pmt_da_realloc_t pmt_es_get_realloc(void *heap)
+{
+        pmt_es_heap_t *h = heap;
+        return h->iface->get_realloc(h->array);
+}
+
+static pmt_da_free_t pmt_es_get_free(void *heap)
+{
+        pmt_es_heap_t *h = heap;
+        return h->iface->get_free(h->array);
+}
+
+static void *pmt_es_get_alloc_state(void *heap)
+{
+        pmt_es_heap_t *h = heap;
+        return h->iface->get_alloc_state(h->array);
+}
+
+static size_t pmt_es_get_element_size(void *heap)
+{
+        return sizeof(pmt_es_cursor_t*);
+}
+
+static size_t pmt_es_get_capacity(void *heap)
+{
+        return ((pmt_es_heap_t*)heap)->capacity;
+}
+
+static void pmt_es_set_capacity(void *heap, const size_t capacity)
+{
+        ((pmt_es_heap_t*)heap)->capacity = capacity;
+}
+
+static size_t pmt_es_get_size(void *heap)
+{
+        return ((pmt_es_heap_t*)heap)->size;
+}
+
+static void pmt_es_set_size(void *heap, const size_t size)
+{
+        ((pmt_es_heap_t*)heap)->size = size;
+}
+
+static void *pmt_es_get_buffer(void *heap)
+{
+        return ((pmt_es_heap_t*)heap)->buffer;
+}
+
+static void pmt_es_set_buffer(void *heap, void *buffer)
+{
+        ((pmt_es_heap_t*)heap)->buffer = buffer;
+}
+
+static void pmt_es_swap(void *a, void *b)
+{
+        pmt_es_cursor_t
+                **x = a,
+                **y = b,
+                *tmp = *x;
+        *x = *y;
+        *y = tmp;
+}
+
+static pmt_bh_swap_t pmt_es_get_swap(void *heap)
+{
+        return pmt_es_swap;
+}
+
+static bool pmt_es_less_than(void *a, void *b)
+{
+        pmt_es_cursor_t
+                *x = *(pmt_es_cursor_t**)a,
+                *y = *(pmt_es_cursor_t**)b;
+        return x->less_than(x->current, y->current);
+}
+
+static pmt_bh_less_than_t pmt_es_get_less_than(void *heap)
+{
+        return pmt_es_less_than;
+}
+
+static pmt_bh_iface_t pmt_es_heap_iface = {
+        .get_swap = pmt_es_get_swap,
+        .get_less_than = pmt_es_get_less_than,
+        .array_iface = {
+                .get_alloc = pmt_es_get_alloc,
+                .get_realloc = pmt_es_get_realloc,
+                .get_free = pmt_es_get_free,
+                .get_alloc_state = pmt_es_get_alloc_state,
+                .get_element_size = pmt_es_get_element_size,
+                .get_capacity = pmt_es_get_capacity,
+                .set_capacity = pmt_es_set_capacity,
+                .get_size = pmt_es_get_size,
+                .set_size = pmt_es_set_size,
+                .get_buffer = pmt_es_get_buffer,
+                .set_buffer = pmt_es_set_buffer
+        }
+};
+
+static bool pmt_es_write_all(int fd, void *data, size_t nbytes)
+{
+        uint8_t *bytes = data;
+
+        while(nbytes > 0) {
+                const ssize_t n = write(fd, bytes, nbytes);
+                if(n < 0) {
+                        if(errno == EINTR) {
+                                continue;
+                        }
+                        return false;
+                }
+                bytes += n;
+                nbytes -= (size_t)n;
+        }
+
+        return true;
+}
+
+/* Read nbytes unless the end of file comes first, returning the bytes read or
+   -1 on error. */
+static ssize_t pmt_es_read_all(int fd, void *data, size_t nbytes, off_t *offset)
+{
+        uint8_t *bytes = data;
+        size_t total = 0;
+
+        while(total < nbytes) {
+                const ssize_t n = offset ? 
+                        pread(fd, bytes + total, nbytes - total, *offset) :
+                        read(fd, bytes + total, nbytes - total);
+                if(n < 0) {
+                        if(errno == EINTR) {
+                                continue;
+                        }
+                        return -1;
+                } else if(n == 0) {
+                        break;
+                }
+                total += (size_t)n;
+                if(offset) {
+                        *offset += n;
+                }
+        }
+
+        return (ssize_t)total;
+}
+
+bool pmt_es_fd_read(
+        void *elements, 
+        const size_t nelems, 
+        size_t *nread, 
+        void *state)
+{
+        pmt_es_fd_t *fd = state;
+
+        const ssize_t n = pmt_es_read_all(
+                fd->fd, 
+                elements, 
+                nelems * fd->element_size, 
+                NULL);
+
+        if(n < 0 || (size_t)n % fd->element_size) {
+                return false;
+        }
+
+        *nread = (size_t)n / fd->element_size;
+
+        return true;
+}
+
+bool pmt_es_fd_write(void *elements, const size_t nelems, void *state)
+{
+        pmt_es_fd_t *fd = state;
+
+        return pmt_es_write_all(fd->fd, elements, nelems * fd->element_size);
+}
+
+/** Writer state for merging into a new run. */
+typedef struct pmt_es_run_writer {
+
+        pmt_es_run_t *run;
+
+        size_t element_size;
+
+} pmt_es_run_writer_t;
+
+static bool pmt_es_run_write(void *elements, const size_t nelems, void *state)
+{
+        pmt_es_run_writer_t *writer = state;
+
+        if(!pmt_es_write_all(
+                writer->run->fd, 
+                elements, 
+                nelems * writer->element_size))
+        {
+                return false;
+        }
+
+        writer->run->length += nelems;
+
+        return true;
+}
+
+static int pmt_es_open_run(pmt_es_config_t *config, pmt_es_run_t *run)
+{
+        const char *directory = config->directory ? config->directory : "/tmp";
+
+        char path[4096];
+
+        const int len = snprintf(
+                path, 
+                sizeof(path), 
+                "%s/pubmt-run-XXXXXX", 
+                directory);
+
+        if(len < 0 || (size_t)len >= sizeof(path)) {
+                return PMT_ES_IO;
+        }
+
+        run->fd = mkstemp(path);
+        run->length = 0;
+
+        if(run->fd < 0) {
+                return PMT_ES_IO;
+        }
+
+        /* Unlinked runs are reclaimed as soon as they are closed. */
+
+        (void)unlink(path);
+
+        return PMT_ES_SUCCESS;
+}
+
+static bool pmt_es_refill(pmt_es_cursor_t *cursor)
+{
+        const size_t n = cursor->remaining < cursor->capacity ? 
+                cursor->remaining : cursor->capacity;
+
+        const size_t nbytes = n * cursor->element_size;
+
+        if(pmt_es_read_all(
+                cursor->fd, 
+                cursor->buffer, 
+                nbytes, 
+                &cursor->offset) != (ssize_t)nbytes) 
+        {
+                return false;
+        }
+
+        cursor->remaining -= n;
+        cursor->current = cursor->buffer;
+        cursor->end = cursor->buffer + nbytes;
+
+        return true;
+}
+
+/* Merge the runs through a heap of cursors.  The memory is split into one 
+   read buffer per run and one output buffer. */
+static int pmt_es_merge(
+        pmt_da_iface_t *iface,
+        void *array,
+        pmt_da_less_than_t less_than,
+        pmt_es_run_t *runs,
+        const size_t nruns,
+        pmt_es_write_t write,
+        void *write_state)
+{
+        pmt_da_alloc_t alloc = iface->get_alloc(array);
+        pmt_da_free_t free = iface->get_free(array);
+        void *alloc_state = iface->get_alloc_state(array);
+
+        const size_t 
+                elem_size = iface->get_element_size(array),
+                share = iface->get_capacity(array) / (nruns + 1);
+
+        assert(share > 0);
+
+        uint8_t *memory = iface->get_buffer(array);
+
+        pmt_es_cursor_t *cursors = alloc(
+                nruns * sizeof(pmt_es_cursor_t), 
+                alloc_state);
+
+        if(!cursors) {
+                return PMT_ES_ALLOC;
+        }
+
+        pmt_es_heap_t heap = { .iface = iface, .array = array };
+
+        if(!pmt_da_create(&pmt_es_heap_iface.array_iface, &heap, nruns)) {
+                free(cursors, alloc_state);
+                return PMT_ES_ALLOC;
+        }
+
+        int result = PMT_ES_SUCCESS;
+
+        for(size_t r = 0; r < nruns; ++r) {
+                pmt_es_cursor_t *cursor = cursors + r;
+                cursor->less_than = less_than;
+                cursor->buffer = memory + r * share * elem_size;
+                cursor->capacity = share;
+                cursor->element_size = elem_size;
+                cursor->remaining = runs[r].length;
+                cursor->offset = 0;
+                cursor->fd = runs[r].fd;
+                if(!cursor->remaining) {
+                        continue;
+                } else if(!pmt_es_refill(cursor)) {
+                        result = PMT_ES_IO;
+                        goto CLEANUP;
+                }
+                (void)pmt_bh_insert(&pmt_es_heap_iface, &heap, &cursor);
+        }
+
+        uint8_t 
+                *out = memory + nruns * share * elem_size,
+                *out_ptr = out,
+                *out_end = out + share * elem_size;
+
+        pmt_es_cursor_t **top = NULL;
+
+        while((top = pmt_bh_peek(&pmt_es_heap_iface, &heap))) {
+
+                pmt_es_cursor_t *cursor = *top;
+
+                (void)memcpy(out_ptr, cursor->current, elem_size);
+                out_ptr += elem_size;
+
+                if(out_ptr == out_end) {
+                        if(!write(out, share, write_state)) {
+                                result = PMT_ES_WRITE;
+                                goto CLEANUP;
+                        }
+                        out_ptr = out;
+                }
+
+                cursor->current += elem_size;
+
+                if(cursor->current == cursor->end) {
+                        if(!cursor->remaining) {
+                                (void)pmt_bh_pop(&pmt_es_heap_iface, &heap, NULL);
+                                continue;
+                        } else if(!pmt_es_refill(cursor)) {
+                                result = PMT_ES_IO;
+                                goto CLEANUP;
+                        }
+                }
+
+                /* the cursor advanced in place, sift it down from the root */
+
+                (void)pmt_bh_update(&pmt_es_heap_iface, &heap, 0);
+        }
+
+        if(out_ptr != out) {
+                if(!write(out, (size_t)(out_ptr - out) / elem_size, write_state)) {
+                        result = PMT_ES_WRITE;
+                }
+        }
+
+        CLEANUP:
+
+        pmt_da_destroy(&pmt_es_heap_iface.array_iface, &heap);
+        free(cursors, alloc_state);
+
+        return result;
+}
+
+static void pmt_es_close_runs(pmt_es_run_t *runs, const size_t nruns)
+{
+        for(size_t r = 0; r < nruns; ++r) {
+                (void)close(runs[r].fd);
+        }
+}
+
+int pmt_es_sort(
+        pmt_da_iface_t *iface, 
+        void *array, 
+        pmt_es_config_t *config)
+{
+        assert(
+                array && 
+                config && 
+                config->less_than && 
+                config->read && 
+                config->write && 
+                pmt_da_iface_validate(iface));
+
+        const size_t 
+                elem_size = iface->get_element_size(array),
+                capacity = iface->get_capacity(array),
+                merge_bytes = config->merge_buffer_size ? 
+                        config->merge_buffer_size : PMT_ES_MERGE_BUFFER,
+                merge_elems = merge_bytes > elem_size ? 
+                        merge_bytes / elem_size : 1;
+
+        if(capacity < 3) {
+                return PMT_ES_ALLOC;
+        }
+
+        /* Each merge needs a read buffer per run plus an output buffer. */
+
+        size_t fan_in = capacity / merge_elems;
+        fan_in = fan_in > 3 ? fan_in - 1 : 2;
+
+        pmt_da_alloc_t alloc = iface->get_alloc(array);
+        pmt_da_realloc_t realloc = iface->get_realloc(array);
+        pmt_da_free_t free = iface->get_free(array);
+        void *alloc_state = iface->get_alloc_state(array);
+
+        pmt_es_run_t *runs = NULL;
+        size_t nruns = 0, runs_cap = 0;
+        int result = PMT_ES_SUCCESS;
+        bool done = false, carried = false;
+
+        /* one element read past a full array, carried into the next fill */
+        uint8_t *probe = NULL;
+
+        while(!done) {
+
+                /* Fill the array to capacity, sort it and spill it. */
+
+                pmt_da_clear(iface, array);
+
+                size_t size = 0;
+
+                if(carried) {
+                        (void)memcpy(
+                                iface->get_buffer(array), 
+                                probe, 
+                                elem_size);
+                        size = 1;
+                        carried = false;
+                }
+
+                while(size < capacity) {
+                        size_t nread = 0;
+                        uint8_t *buffer = iface->get_buffer(array);
+                        if(!config->read(
+                                buffer + size * elem_size, 
+                                capacity - size, 
+                                &nread, 
+                                config->read_state)) 
+                        {
+                                result = PMT_ES_READ;
+                                goto CLEANUP;
+                        } else if(!nread) {
+                                done = true;
+                                break;
+                        }
+                        size += nread;
+                }
+
+                /* An input of exactly 'capacity' elements still fits, so 
+                   look for one more before spilling the first run. */
+
+                if(!done && !nruns) {
+                        size_t nread = 0;
+                        probe = alloc(elem_size, alloc_state);
+                        if(!probe) {
+                                result = PMT_ES_ALLOC;
+                                goto CLEANUP;
+                        } else if(!config->read(
+                                probe, 
+                                1, 
+                                &nread, 
+                                config->read_state)) 
+                        {
+                                result = PMT_ES_READ;
+                                goto CLEANUP;
+                        }
+                        done = !nread;
+                        carried = !done;
+                }
+
+                iface->set_size(array, size);
+
+                pmt_da_sort(iface, array, config->less_than);
+
+                if(done && !nruns) {
+                        if(size && !config->write(
+                                iface->get_buffer(array), 
+                                size, 
+                                config->write_state)) 
+                        {
+                                result = PMT_ES_WRITE;
+                        }
+                        goto CLEANUP;
+                } else if(!size) {
+                        break;
+                }
+
+                if(nruns == runs_cap) {
+                        const size_t new_cap = runs_cap ? runs_cap * 2 : 16;
+                        pmt_es_run_t *new_runs = runs ? 
+                                realloc(
+                                        runs, 
+                                        new_cap * sizeof(pmt_es_run_t), 
+                                        alloc_state) :
+                                alloc(
+                                        new_cap * sizeof(pmt_es_run_t), 
+                                        alloc_state);
+                        if(!new_runs) {
+                                result = PMT_ES_ALLOC;
+                                goto CLEANUP;
+                        }
+                        runs = new_runs;
+                        runs_cap = new_cap;
+                }
+
+                if((result = pmt_es_open_run(config, runs + nruns))) {
+                        goto CLEANUP;
+                }
+
+                runs[nruns].length = size;
+
+                if(!pmt_es_write_all(
+                        runs[nruns++].fd, 
+                        iface->get_buffer(array), 
+                        size * elem_size)) 
+                {
+                        result = PMT_ES_IO;
+                        goto CLEANUP;
+                }
+        }
+
+        iface->set_size(array, 0);
+
+        /* Merge the oldest runs into a longer one until they all fit, the
+           array's buffer now serving as the merge memory. */
+
+        while(nruns > fan_in) {
+
+                pmt_es_run_t run;
+
+                if((result = pmt_es_open_run(config, &run))) {
+                        goto CLEANUP;
+                }
+
+                pmt_es_run_writer_t writer = { 
+                        .run = &run, 
+                        .element_size = elem_size };
+
+                result = pmt_es_merge(
+                        iface, 
+                        array, 
+                        config->less_than, 
+                        runs, 
+                        fan_in, 
+                        pmt_es_run_write, 
+                        &writer);
+
+                pmt_es_close_runs(runs, fan_in);
+
+                (void)memmove(
+                        runs, 
+                        runs + fan_in, 
+                        (nruns - fan_in) * sizeof(pmt_es_run_t));
+
+                nruns -= fan_in;
+                runs[nruns++] = run;
+
+                if(result) {
+                        goto CLEANUP;
+                }
+        }
+
+        result = pmt_es_merge(
+                iface, 
+                array, 
+                config->less_than, 
+                runs, 
+                nruns, 
+                config->write, 
+                config->write_state);
+
+        CLEANUP:
+
+        pmt_es_close_runs(runs, nruns);
+
+        if(runs) {
+                free(runs, alloc_state);
+        }
+
+        if(probe) {
+                free(probe, alloc_state);
+        }
+
+        pmt_da_clear(iface, array);
+
+        return result;
+}
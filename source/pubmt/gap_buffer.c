@@ -0,0 +1,250 @@
+#include "pubmt/gap_buffer.h"
+#include <string.h>
+#include <stdint.h>
+#include <assert.h>
+
+bool pmt_gb_iface_validate(pmt_gb_iface_t *iface)
+{
+        return
+                iface &&
+                iface->get_gap &&
+                iface->set_gap &&
+                pmt_da_iface_validate(&iface->array_iface);
+}
+
+void *pmt_gb_create(
+        pmt_gb_iface_t *iface,
+        void *buffer,
+        const size_t init_cap)
+{
+        assert(buffer && pmt_gb_iface_validate(iface));
+
+        if(!pmt_da_create(&iface->array_iface, buffer, init_cap)) {
+                return NULL;
+        }
+
+        iface->set_gap(buffer, 0);
+
+        return buffer;
+}
+
+void pmt_gb_destroy(pmt_gb_iface_t *iface, void *buffer)
+{
+        assert(buffer && pmt_gb_iface_validate(iface));
+
+        pmt_da_destroy(&iface->array_iface, buffer);
+}
+
+size_t pmt_gb_size(pmt_gb_iface_t *iface, void *buffer)
+{
+        assert(buffer && pmt_gb_iface_validate(iface));
+
+        return iface->array_iface.get_size(buffer);
+}
+
+void *pmt_gb_at(pmt_gb_iface_t *iface, void *buffer, const size_t index)
+{
+        assert(buffer && pmt_gb_iface_validate(iface));
+
+        pmt_da_iface_t *a_iface = &iface->array_iface;
+
+        const size_t
+                size = a_iface->get_size(buffer),
+                gap = iface->get_gap(buffer);
+
+        if(index >= size) {
+                return NULL;
+        }
+
+        const size_t 
+                elem_size = a_iface->get_element_size(buffer),
+                gap_len = a_iface->get_capacity(buffer) - size,
+                pos = index < gap ? index : index + gap_len;
+
+        return (uint8_t*)a_iface->get_buffer(buffer) + pos * elem_size;
+}
+
+bool pmt_gb_move_gap(pmt_gb_iface_t *iface, void *buffer, const size_t index)
+{
+        assert(buffer && pmt_gb_iface_validate(iface));
+
+        pmt_da_iface_t *a_iface = &iface->array_iface;
+
+        const size_t
+                size = a_iface->get_size(buffer),
+                gap = iface->get_gap(buffer);
+
+        if(index > size) {
+                return false;
+        } else if(index == gap) {
+                return true;
+        }
+
+        const size_t
+                elem_size = a_iface->get_element_size(buffer),
+                gap_len = a_iface->get_capacity(buffer) - size;
+
+        uint8_t *buf = a_iface->get_buffer(buffer);
+
+        if(index < gap) {
+                (void)memmove(
+                        buf + (index + gap_len) * elem_size,
+                        buf + index * elem_size,
+                        (gap - index) * elem_size);
+        } else {
+                (void)memmove(
+                        buf + gap * elem_size,
+                        buf + (gap + gap_len) * elem_size,
+                        (index - gap) * elem_size);
+        }
+
+        iface->set_gap(buffer, index);
+
+        return true;
+}
+
+bool pmt_gb_reserve(pmt_gb_iface_t *iface, void *buffer, const size_t nelems)
+{
+        assert(buffer && pmt_gb_iface_validate(iface));
+
+        pmt_da_iface_t *a_iface = &iface->array_iface;
+
+        const size_t
+                size = a_iface->get_size(buffer),
+                capacity = a_iface->get_capacity(buffer),
+                gap = iface->get_gap(buffer),
+                want_cap = size + nelems;
+
+        if(want_cap < size) {
+                return false;
+        } else if(want_cap <= capacity) {
+                return true;
+        }
+
+        size_t new_cap = capacity ? capacity : 1;
+
+        while(new_cap < want_cap) {
+                const size_t next_cap = new_cap * 2;
+                if(next_cap <= new_cap) {
+                        return false;
+                }
+                new_cap = next_cap;
+        }
+
+        if(!pmt_da_resize(a_iface, buffer, new_cap)) {
+                return false;
+        }
+
+        /* The tail is still where the old capacity ended, move it back to 
+           the end of the grown buffer. */
+
+        new_cap = a_iface->get_capacity(buffer);
+
+        const size_t
+                elem_size = a_iface->get_element_size(buffer),
+                tail = size - gap;
+
+        uint8_t *buf = a_iface->get_buffer(buffer);
+
+        (void)memmove(
+                buf + (new_cap - tail) * elem_size,
+                buf + (capacity - tail) * elem_size,
+                tail * elem_size);
+
+        return true;
+}
+
+void *pmt_gb_insert(
+        pmt_gb_iface_t *iface,
+        void *buffer,
+        const size_t index,
+        void *elems,
+        const size_t nelems)
+{
+        assert(buffer && pmt_gb_iface_validate(iface));
+
+        pmt_da_iface_t *a_iface = &iface->array_iface;
+
+        if(!pmt_gb_move_gap(iface, buffer, index)) {
+                return NULL;
+        } 
+        
+        if(!pmt_gb_reserve(iface, buffer, nelems)) {
+                return NULL;
+        }
+
+        const size_t elem_size = a_iface->get_element_size(buffer);
+
+        uint8_t 
+                *buf = a_iface->get_buffer(buffer),
+                *pointer = buf + index * elem_size;
+
+        if(elems) {
+                (void)memcpy(pointer, elems, nelems * elem_size);
+        }
+
+        iface->set_gap(buffer, index + nelems);
+        a_iface->set_size(buffer, a_iface->get_size(buffer) + nelems);
+
+        return pointer;
+}
+
+bool pmt_gb_remove(
+        pmt_gb_iface_t *iface,
+        void *buffer,
+        const size_t index,
+        const size_t nelems)
+{
+        assert(buffer && pmt_gb_iface_validate(iface));
+
+        pmt_da_iface_t *a_iface = &iface->array_iface;
+
+        const size_t 
+                size = a_iface->get_size(buffer),
+                offset = index + nelems;
+
+        if(offset > size || offset < index) {
+                return false;
+        }
+
+        (void)pmt_gb_move_gap(iface, buffer, index);
+
+        a_iface->set_size(buffer, size - nelems);
+
+        return true;
+}
+
+void *pmt_gb_span(
+        pmt_gb_iface_t *iface,
+        void *buffer,
+        const size_t index,
+        const size_t nelems)
+{
+        assert(buffer && pmt_gb_iface_validate(iface));
+
+        pmt_da_iface_t *a_iface = &iface->array_iface;
+
+        const size_t
+                size = a_iface->get_size(buffer),
+                gap = iface->get_gap(buffer),
+                offset = index + nelems;
+
+        if(offset > size || offset < index) {
+                return NULL;
+        }
+
+        if(index < gap && gap < offset) {
+                if(gap - index <= offset - gap) {
+                        (void)pmt_gb_move_gap(iface, buffer, index);
+                } else {
+                        (void)pmt_gb_move_gap(iface, buffer, offset);
+                }
+        }
+
+        const size_t
+                elem_size = a_iface->get_element_size(buffer),
+                gap_len = a_iface->get_capacity(buffer) - size,
+                pos = index < iface->get_gap(buffer) ? index : index + gap_len;
+
+        return (uint8_t*)a_iface->get_buffer(buffer) + pos * elem_size;
+}
@@ -26,7 +26,13 @@ void *pmt_hm_create(
                 return NULL;
         }
 
-        (void)pmt_da_zero_buffer(&iface->array_iface, map, 0, init_cap);
+        /* inline storage may leave the capacity above 'init_cap' */
+
+        (void)pmt_da_zero_buffer(
+                &iface->array_iface,
+                map,
+                0,
+                iface->array_iface.get_capacity(map));
 
         return map;
 }
@@ -73,7 +79,9 @@ bool pmt_hm_resize(pmt_hm_iface_t *iface, void *map, const size_t new_cap)
                 *bucket = pmt_ll_node_push_front(node_iface, *bucket, node);
         }
 
-        free(array_iface->get_buffer(map), alloc_state);
+        if(!pmt_da_is_inline(array_iface, map)) {
+                free(array_iface->get_buffer(map), alloc_state);
+        }
 
         array_iface->set_capacity(map, new_cap);
         array_iface->set_buffer(map, new_buf);
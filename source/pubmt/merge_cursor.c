@@ -0,0 +1,399 @@
+#include "pubmt/merge_cursor.h"
+#include <string.h>
+#include <assert.h>
+
+static pmt_da_alloc_t pmt_mc_get_alloc(void *heap)
+{
+        return ((pmt_mc_heap_t*)heap)->cursor->alloc;
+}
+
+static pmt_da_realloc_t pmt_mc_get_realloc(void *heap)
+{
+        return ((pmt_mc_heap_t*)heap)->cursor->realloc;
+}
+
+static pmt_da_free_t pmt_mc_get_free(void *heap)
+{
+        return ((pmt_mc_heap_t*)heap)->cursor->free;
+}
+
+static void *pmt_mc_get_alloc_state(void *heap)
+{
+        return ((pmt_mc_heap_t*)heap)->cursor->alloc_state;
+}
+
+static size_t pmt_mc_get_element_size(void *heap)
+{
+        return sizeof(pmt_mc_run_t*);
+}
+
+static size_t pmt_mc_get_capacity(void *heap)
+{
+        return ((pmt_mc_heap_t*)heap)->capacity;
+}
+
+static void pmt_mc_set_capacity(void *heap, const size_t capacity)
+{
+        ((pmt_mc_heap_t*)heap)->capacity = capacity;
+}
+
+static size_t pmt_mc_get_size(void *heap)
+{
+        return ((pmt_mc_heap_t*)heap)->size;
+}
+
+static void pmt_mc_set_size(void *heap, const size_t size)
+{
+        ((pmt_mc_heap_t*)heap)->size = size;
+}
+
+static void *pmt_mc_get_buffer(void *heap)
+{
+        return ((pmt_mc_heap_t*)heap)->buffer;
+}
+
+static void pmt_mc_set_buffer(void *heap, void *buffer)
+{
+        ((pmt_mc_heap_t*)heap)->buffer = buffer;
+}
+
+/* Swapping run pointers keeps pmt_bh_update from needing scratch space. */
+static void pmt_mc_swap(void *a, void *b)
+{
+        pmt_mc_run_t
+                **x = a,
+                **y = b,
+                *tmp = *x;
+        *x = *y;
+        *y = tmp;
+}
+
+static pmt_bh_swap_t pmt_mc_get_swap(void *heap)
+{
+        return pmt_mc_swap;
+}
+
+/* Order runs by their current elements, then by the order they were added. */
+static bool pmt_mc_less_than(void *a, void *b)
+{
+        pmt_mc_run_t
+                *x = *(pmt_mc_run_t**)a,
+                *y = *(pmt_mc_run_t**)b;
+
+        if(x->less_than(x->current, y->current)) {
+                return true;
+        } else if(x->less_than(y->current, x->current)) {
+                return false;
+        }
+
+        return x->index < y->index;
+}
+
+static pmt_bh_less_than_t pmt_mc_get_less_than(void *heap)
+{
+        return pmt_mc_less_than;
+}
+
+static pmt_bh_iface_t pmt_mc_heap_iface = {
+        .get_swap = pmt_mc_get_swap,
+        .get_less_than = pmt_mc_get_less_than,
+        .array_iface = {
+                .get_alloc = pmt_mc_get_alloc,
+                .get_realloc = pmt_mc_get_realloc,
+                .get_free = pmt_mc_get_free,
+                .get_alloc_state = pmt_mc_get_alloc_state,
+                .get_element_size = pmt_mc_get_element_size,
+                .get_capacity = pmt_mc_get_capacity,
+                .set_capacity = pmt_mc_set_capacity,
+                .get_size = pmt_mc_get_size,
+                .set_size = pmt_mc_set_size,
+                .get_buffer = pmt_mc_get_buffer,
+                .set_buffer = pmt_mc_set_buffer
+        }
+};
+
+/* Pull the next batch of a run into its buffer. */
+static bool pmt_mc_refill(pmt_mc_cursor_t *cursor, pmt_mc_run_t *run)
+{
+        size_t n = 0;
+
+        if(!run->pull(run->buffer, cursor->batch, &n, run->pull_state)) {
+                return false;
+        }
+
+        assert(n <= cursor->batch);
+
+        run->current = run->buffer;
+        run->end = run->buffer + n * cursor->element_size;
+
+        return true;
+}
+
+/* Get the run at the root of the heap, NULL once every run has ended. */
+static pmt_mc_run_t *pmt_mc_top(pmt_mc_cursor_t *cursor)
+{
+        pmt_mc_run_t **top = pmt_bh_peek(&pmt_mc_heap_iface, &cursor->heap);
+
+        return top ? *top : NULL;
+}
+
+/* 
+ * The root run's current batch was advanced, restore the heap order.  A pull
+ * failure is only recorded, the element already taken is still delivered.
+ */
+static void pmt_mc_restore(pmt_mc_cursor_t *cursor, pmt_mc_run_t *run)
+{
+        if(run->current == run->end) {
+
+                if(run->pull && !pmt_mc_refill(cursor, run)) {
+                        cursor->failed = true;
+                }
+
+                if(!run->pull || cursor->failed || run->current == run->end) {
+                        /* the run ended, or failed and is dropped */
+                        (void)pmt_bh_pop(
+                                &pmt_mc_heap_iface,
+                                &cursor->heap,
+                                NULL);
+                        return;
+                }
+        }
+
+        (void)pmt_bh_update(&pmt_mc_heap_iface, &cursor->heap, 0);
+}
+
+pmt_mc_cursor_t *pmt_mc_create(
+        pmt_mc_cursor_t *cursor,
+        const size_t max_runs,
+        const size_t element_size,
+        const size_t batch,
+        pmt_da_less_than_t less_than,
+        pmt_da_alloc_t alloc,
+        pmt_da_realloc_t realloc,
+        pmt_da_free_t free,
+        void *alloc_state)
+{
+        assert(cursor && max_runs && element_size && batch && less_than);
+        assert(alloc && realloc && free);
+
+        if(max_runs > SIZE_MAX / sizeof(pmt_mc_run_t)) {
+                return NULL;
+        }
+
+        cursor->runs = alloc(max_runs * sizeof(pmt_mc_run_t), alloc_state);
+        if(!cursor->runs) {
+                return NULL;
+        }
+
+        cursor->nruns = 0;
+        cursor->max_runs = max_runs;
+        cursor->element_size = element_size;
+        cursor->batch = batch;
+        cursor->less_than = less_than;
+        cursor->failed = false;
+        cursor->alloc = alloc;
+        cursor->realloc = realloc;
+        cursor->free = free;
+        cursor->alloc_state = alloc_state;
+
+        cursor->heap.cursor = cursor;
+
+        /* room for every run, so the heap never grows while merging */
+
+        if(!pmt_da_create(
+                &pmt_mc_heap_iface.array_iface,
+                &cursor->heap,
+                max_runs))
+        {
+                free(cursor->runs, alloc_state);
+                return NULL;
+        }
+
+        return cursor;
+}
+
+void pmt_mc_destroy(pmt_mc_cursor_t *cursor)
+{
+        assert(cursor);
+
+        for(size_t r = 0; r < cursor->nruns; ++r) {
+                if(cursor->runs[r].buffer) {
+                        cursor->free(
+                                cursor->runs[r].buffer,
+                                cursor->alloc_state);
+                }
+        }
+
+        pmt_da_destroy(&pmt_mc_heap_iface.array_iface, &cursor->heap);
+
+        cursor->free(cursor->runs, cursor->alloc_state);
+}
+
+static pmt_mc_run_t *pmt_mc_new_run(pmt_mc_cursor_t *cursor)
+{
+        assert(cursor->nruns < cursor->max_runs);
+
+        pmt_mc_run_t *run = cursor->runs + cursor->nruns;
+
+        run->less_than = cursor->less_than;
+        run->current = NULL;
+        run->end = NULL;
+        run->buffer = NULL;
+        run->pull = NULL;
+        run->pull_state = NULL;
+        run->index = cursor->nruns++;
+
+        return run;
+}
+
+void pmt_mc_add_array(
+        pmt_mc_cursor_t *cursor,
+        pmt_da_iface_t *iface,
+        void *array)
+{
+        assert(cursor && array && pmt_da_iface_validate(iface));
+        assert(iface->get_element_size(array) == cursor->element_size);
+
+        pmt_mc_run_t *run = pmt_mc_new_run(cursor);
+
+        run->current = iface->get_buffer(array);
+        run->end = run->current + iface->get_size(array) * cursor->element_size;
+
+        if(run->current != run->end) {
+                (void)pmt_bh_insert(&pmt_mc_heap_iface, &cursor->heap, &run);
+        }
+}
+
+bool pmt_mc_add_pull(
+        pmt_mc_cursor_t *cursor,
+        pmt_mc_pull_t pull,
+        void *pull_state)
+{
+        assert(cursor && pull);
+
+        if(cursor->batch > SIZE_MAX / cursor->element_size) {
+                return false;
+        }
+
+        uint8_t *buffer = cursor->alloc(
+                cursor->batch * cursor->element_size,
+                cursor->alloc_state);
+
+        if(!buffer) {
+                return false;
+        }
+
+        pmt_mc_run_t *run = pmt_mc_new_run(cursor);
+
+        run->buffer = buffer;
+        run->pull = pull;
+        run->pull_state = pull_state;
+
+        /* a run whose first pull fails is dropped, the cursor stays usable */
+
+        if(!pmt_mc_refill(cursor, run)) {
+                cursor->free(buffer, cursor->alloc_state);
+                --cursor->nruns;
+                return false;
+        }
+
+        if(run->current != run->end) {
+                (void)pmt_bh_insert(&pmt_mc_heap_iface, &cursor->heap, &run);
+        }
+
+        return true;
+}
+
+void *pmt_mc_peek(pmt_mc_cursor_t *cursor)
+{
+        assert(cursor);
+
+        pmt_mc_run_t *run = pmt_mc_top(cursor);
+
+        return run ? run->current : NULL;
+}
+
+bool pmt_mc_next(pmt_mc_cursor_t *cursor, void *element)
+{
+        assert(cursor);
+
+        pmt_mc_run_t *run = pmt_mc_top(cursor);
+
+        if(!run || cursor->failed) {
+                return false;
+        }
+
+        /* copy out before a refill can overwrite the batch */
+
+        if(element) {
+                (void)memcpy(element, run->current, cursor->element_size);
+        }
+
+        run->current += cursor->element_size;
+
+        pmt_mc_restore(cursor, run);
+
+        return true;
+}
+
+bool pmt_mc_read(
+        void *elements,
+        const size_t nelems,
+        size_t *nread,
+        void *state)
+{
+        pmt_mc_cursor_t *cursor = state;
+
+        assert(cursor && nread && (elements || !nelems));
+
+        const size_t elem_size = cursor->element_size;
+
+        uint8_t *out = elements;
+
+        size_t taken = 0;
+
+        *nread = 0;
+
+        while(taken < nelems && !cursor->failed) {
+
+                pmt_mc_run_t *run = pmt_mc_top(cursor);
+
+                if(!run) {
+                        break;
+                }
+
+                size_t n = 1;
+
+                /* a lone run needs no comparisons, copy its batch whole */
+
+                if(cursor->heap.size == 1) {
+                        n = (size_t)(run->end - run->current) / elem_size;
+                        if(n > nelems - taken) {
+                                n = nelems - taken;
+                        }
+                }
+
+                (void)memcpy(out, run->current, n * elem_size);
+
+                out += n * elem_size;
+                taken += n;
+
+                run->current += n * elem_size;
+
+                pmt_mc_restore(cursor, run);
+        }
+
+        *nread = taken;
+
+        /* elements taken before a failure are delivered, it is reported by 
+           the next call */
+
+        return taken || !cursor->failed;
+}
+
+bool pmt_mc_failed(pmt_mc_cursor_t *cursor)
+{
+        assert(cursor);
+
+        return cursor->failed;
+}
@@ -0,0 +1,273 @@
+#include "pubmt/min_max_heap.h"
+#include <stdint.h>
+#include <string.h>
+#include <assert.h>
+
+/* The callbacks and buffer used while sifting. */
+typedef struct pmt_mmh_sift {
+
+        pmt_bh_less_than_t cmp;
+        pmt_bh_swap_t swap;
+
+        uint8_t *buffer;
+        size_t elem_size, size;
+
+} pmt_mmh_sift_t;
+
+static void pmt_mmh_sift_init(
+        pmt_bh_iface_t *iface,
+        void *heap,
+        pmt_mmh_sift_t *sift)
+{
+        pmt_da_iface_t *a_iface = &iface->array_iface;
+
+        sift->cmp = iface->get_less_than(heap);
+        sift->swap = iface->get_swap ? iface->get_swap(heap) : NULL;
+        sift->buffer = a_iface->get_buffer(heap);
+        sift->elem_size = a_iface->get_element_size(heap);
+        sift->size = a_iface->get_size(heap);
+}
+
+static void *pmt_mmh_at(pmt_mmh_sift_t *sift, const size_t index)
+{
+        return sift->buffer + index * sift->elem_size;
+}
+
+/* Is the element at 'a' less than the one at 'b' on this kind of level? */
+static bool pmt_mmh_before(
+        pmt_mmh_sift_t *sift,
+        const bool min_level,
+        const size_t a,
+        const size_t b)
+{
+        return min_level ?
+                sift->cmp(pmt_mmh_at(sift, a), pmt_mmh_at(sift, b)) :
+                sift->cmp(pmt_mmh_at(sift, b), pmt_mmh_at(sift, a));
+}
+
+static void pmt_mmh_swap(pmt_mmh_sift_t *sift, const size_t a, const size_t b)
+{
+        uint8_t
+                *x = pmt_mmh_at(sift, a),
+                *y = pmt_mmh_at(sift, b);
+
+        if(sift->swap) {
+                sift->swap(x, y);
+                return;
+        }
+
+        for(size_t n = 0; n < sift->elem_size; ++n) {
+                const uint8_t tmp = x[n];
+                x[n] = y[n];
+                y[n] = tmp;
+        }
+}
+
+/* The root is on a min level, levels alternate from there. */
+static bool pmt_mmh_is_min_level(const size_t index)
+{
+        bool min_level = true;
+
+        for(size_t n = index + 1; n > 1; n >>= 1) {
+                min_level = !min_level;
+        }
+
+        return min_level;
+}
+
+/* Move the element up through grandparents on levels of the same kind. */
+static size_t pmt_mmh_bubble_up(
+        pmt_mmh_sift_t *sift,
+        const bool min_level,
+        size_t index)
+{
+        while(index > 2) {
+
+                const size_t grandparent = ((index - 1) / 2 - 1) / 2;
+
+                if(!pmt_mmh_before(sift, min_level, index, grandparent)) {
+                        break;
+                }
+
+                pmt_mmh_swap(sift, index, grandparent);
+
+                index = grandparent;
+        }
+
+        return index;
+}
+
+static size_t pmt_mmh_push_up(pmt_mmh_sift_t *sift, const size_t index)
+{
+        if(index == 0) {
+                return 0;
+        }
+
+        const size_t parent = (index - 1) / 2;
+        const bool min_level = pmt_mmh_is_min_level(index);
+
+        /* an element out of order with its parent belongs to the other kind */
+
+        if(pmt_mmh_before(sift, !min_level, index, parent)) {
+                pmt_mmh_swap(sift, index, parent);
+                return pmt_mmh_bubble_up(sift, !min_level, parent);
+        }
+
+        return pmt_mmh_bubble_up(sift, min_level, index);
+}
+
+static void pmt_mmh_push_down(pmt_mmh_sift_t *sift, size_t index)
+{
+        const bool min_level = pmt_mmh_is_min_level(index);
+        const size_t size = sift->size;
+
+        for(;;) {
+
+                const size_t child = 2 * index + 1;
+
+                if(child >= size) {
+                        return;
+                }
+
+                /* the best of the children and grandchildren */
+
+                size_t best = child;
+
+                if(child + 1 < size &&
+                        pmt_mmh_before(sift, min_level, child + 1, best))
+                {
+                        best = child + 1;
+                }
+
+                const size_t
+                        grandchild = 2 * child + 1,
+                        end = grandchild + 4 < size ? grandchild + 4 : size;
+
+                for(size_t g = grandchild; g < end; ++g) {
+                        if(pmt_mmh_before(sift, min_level, g, best)) {
+                                best = g;
+                        }
+                }
+
+                if(!pmt_mmh_before(sift, min_level, best, index)) {
+                        return;
+                }
+
+                pmt_mmh_swap(sift, best, index);
+
+                if(best <= child + 1) {
+                        return;
+                }
+
+                const size_t parent = (best - 1) / 2;
+
+                if(pmt_mmh_before(sift, !min_level, best, parent)) {
+                        pmt_mmh_swap(sift, best, parent);
+                }
+
+                index = best;
+        }
+}
+
+void *pmt_mmh_insert(pmt_bh_iface_t *iface, void *heap, void *elem)
+{
+        assert(heap && elem && pmt_bh_iface_validate(iface));
+
+        if(!pmt_da_push_back(&iface->array_iface, heap, elem)) {
+                return NULL;
+        }
+
+        pmt_mmh_sift_t sift;
+        pmt_mmh_sift_init(iface, heap, &sift);
+
+        return pmt_mmh_at(&sift, pmt_mmh_push_up(&sift, sift.size - 1));
+}
+
+void *pmt_mmh_peek_min(pmt_bh_iface_t *iface, void *heap)
+{
+        assert(heap && pmt_bh_iface_validate(iface));
+
+        return pmt_da_first(&iface->array_iface, heap);
+}
+
+void *pmt_mmh_peek_max(pmt_bh_iface_t *iface, void *heap)
+{
+        assert(heap && pmt_bh_iface_validate(iface));
+
+        pmt_mmh_sift_t sift;
+        pmt_mmh_sift_init(iface, heap, &sift);
+
+        if(!sift.size) {
+                return NULL;
+        } else if(sift.size < 3) {
+                return pmt_mmh_at(&sift, sift.size - 1);
+        }
+
+        /* the maximal element is the greater child of the root */
+
+        return pmt_mmh_before(&sift, true, 1, 2) ?
+                pmt_mmh_at(&sift, 2) :
+                pmt_mmh_at(&sift, 1);
+}
+
+/* Remove the element at 'index', refilling the hole with the last element. */
+static bool pmt_mmh_pop_at(
+        pmt_bh_iface_t *iface,
+        void *heap,
+        void *elem,
+        pmt_mmh_sift_t *sift,
+        const size_t index)
+{
+        pmt_da_iface_t *a_iface = &iface->array_iface;
+
+        void *pointer = pmt_mmh_at(sift, index);
+
+        if(elem) {
+                (void)memcpy(elem, pointer, sift->elem_size);
+        }
+
+        if(index == sift->size - 1) {
+                (void)pmt_da_pop_back(a_iface, heap, NULL);
+                return true;
+        }
+
+        (void)pmt_da_pop_back(a_iface, heap, pointer);
+
+        --sift->size;
+
+        pmt_mmh_push_down(sift, index);
+
+        return true;
+}
+
+bool pmt_mmh_pop_min(pmt_bh_iface_t *iface, void *heap, void *elem)
+{
+        assert(heap && pmt_bh_iface_validate(iface));
+
+        pmt_mmh_sift_t sift;
+        pmt_mmh_sift_init(iface, heap, &sift);
+
+        if(!sift.size) {
+                return false;
+        }
+
+        return pmt_mmh_pop_at(iface, heap, elem, &sift, 0);
+}
+
+bool pmt_mmh_pop_max(pmt_bh_iface_t *iface, void *heap, void *elem)
+{
+        assert(heap && pmt_bh_iface_validate(iface));
+
+        uint8_t *max = pmt_mmh_peek_max(iface, heap);
+
+        if(!max) {
+                return false;
+        }
+
+        pmt_mmh_sift_t sift;
+        pmt_mmh_sift_init(iface, heap, &sift);
+
+        const size_t index = (size_t)(max - sift.buffer) / sift.elem_size;
+
+        return pmt_mmh_pop_at(iface, heap, elem, &sift, index);
+}
@@ -0,0 +1,332 @@
+#if defined(__linux__)
+#define _DEFAULT_SOURCE
+#else
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+#include "pubmt/mpmc_queue.h"
+#include <string.h>
+#include <stdint.h>
+#include <limits.h>
+#include <assert.h>
+
+#if defined(__linux__)
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#else
+#include <sched.h>
+#endif
+
+/** Slot header, the element follows it. */
+typedef struct pmt_mpmc_slot {
+
+        atomic_size_t sequence;
+
+} pmt_mpmc_slot_t;
+
+static pmt_mpmc_slot_t *pmt_mpmc_slot(
+        pmt_mpmc_queue_t *queue,
+        const size_t pos)
+{
+        return (pmt_mpmc_slot_t*)(
+                (uint8_t*)queue->slots + (pos & queue->mask) * queue->slot_size);
+}
+
+static void *pmt_mpmc_slot_element(pmt_mpmc_slot_t *slot)
+{
+        return (uint8_t*)slot + sizeof(pmt_mpmc_slot_t);
+}
+
+/** Sleep until *word no longer holds 'expected' (or spuriously). */
+static void pmt_mpmc_wait(atomic_uint *word, const unsigned int expected)
+{
+#if defined(__linux__)
+        (void)syscall(
+                SYS_futex,
+                (unsigned int*)word,
+                FUTEX_WAIT_PRIVATE,
+                expected,
+                NULL,
+                NULL,
+                0);
+#else
+        if(atomic_load_explicit(word, memory_order_relaxed) == expected) {
+                (void)sched_yield();
+        }
+#endif
+}
+
+/** Wake a thread sleeping in pmt_mpmc_wait. */
+static void pmt_mpmc_wake(atomic_uint *word)
+{
+#if defined(__linux__)
+        (void)syscall(
+                SYS_futex,
+                (unsigned int*)word,
+                FUTEX_WAKE_PRIVATE,
+                1,
+                NULL,
+                NULL,
+                0);
+#else
+        (void)word;
+#endif
+}
+
+/*
+ * The fence orders the slot's publication before the waiter count is read,
+ * pairing with the fence after the waiter's increment, so either the
+ * waiter sees the slot or the notifier sees the waiter.
+ */
+static void pmt_mpmc_notify(atomic_uint *event, atomic_uint *waiters)
+{
+        atomic_thread_fence(memory_order_seq_cst);
+
+        if(atomic_load_explicit(waiters, memory_order_relaxed)) {
+                (void)atomic_fetch_add_explicit(
+                        event,
+                        1,
+                        memory_order_release);
+                pmt_mpmc_wake(event);
+        }
+}
+
+pmt_mpmc_queue_t *pmt_mpmc_create(
+        pmt_mpmc_queue_t *queue,
+        const size_t capacity,
+        const size_t elem_size,
+        pmt_da_alloc_t alloc,
+        pmt_da_free_t free,
+        void *alloc_state)
+{
+        assert(queue && alloc && free && elem_size);
+        assert(capacity >= 2 && !(capacity & (capacity - 1)));
+
+        const size_t
+                align = _Alignof(pmt_mpmc_slot_t),
+                slot_size =
+                        (sizeof(pmt_mpmc_slot_t) + elem_size + align - 1) /
+                        align * align;
+
+        if(slot_size < elem_size || SIZE_MAX / slot_size < capacity) {
+                return NULL;
+        }
+
+        queue->slots = alloc(capacity * slot_size, alloc_state);
+        if(!queue->slots) {
+                return NULL;
+        }
+
+        queue->mask = capacity - 1;
+        queue->element_size = elem_size;
+        queue->slot_size = slot_size;
+        queue->free = free;
+        queue->alloc_state = alloc_state;
+
+        for(size_t x = 0; x < capacity; ++x) {
+                atomic_init(&pmt_mpmc_slot(queue, x)->sequence, x);
+        }
+
+        atomic_init(&queue->enqueue_pos, 0);
+        atomic_init(&queue->dequeue_pos, 0);
+        atomic_init(&queue->items_event, 0);
+        atomic_init(&queue->space_event, 0);
+        atomic_init(&queue->items_waiters, 0);
+        atomic_init(&queue->space_waiters, 0);
+
+        return queue;
+}
+
+void pmt_mpmc_destroy(pmt_mpmc_queue_t *queue)
+{
+        assert(queue);
+
+        queue->free(queue->slots, queue->alloc_state);
+        queue->slots = NULL;
+}
+
+bool pmt_mpmc_try_enqueue(pmt_mpmc_queue_t *queue, const void *elem)
+{
+        assert(queue && elem);
+
+        size_t pos = atomic_load_explicit(
+                &queue->enqueue_pos,
+                memory_order_relaxed);
+
+        for(;;) {
+                pmt_mpmc_slot_t *slot = pmt_mpmc_slot(queue, pos);
+
+                const size_t seq = atomic_load_explicit(
+                        &slot->sequence,
+                        memory_order_acquire);
+
+                const intptr_t diff = (intptr_t)(seq - pos);
+
+                if(diff == 0) {
+                        if(atomic_compare_exchange_weak_explicit(
+                                &queue->enqueue_pos,
+                                &pos,
+                                pos + 1,
+                                memory_order_relaxed,
+                                memory_order_relaxed))
+                        {
+                                (void)memcpy(
+                                        pmt_mpmc_slot_element(slot),
+                                        elem,
+                                        queue->element_size);
+                                atomic_store_explicit(
+                                        &slot->sequence,
+                                        pos + 1,
+                                        memory_order_release);
+                                pmt_mpmc_notify(
+                                        &queue->items_event,
+                                        &queue->items_waiters);
+                                return true;
+                        }
+                } else if(diff < 0) {
+                        /* the slot still holds last lap's element */
+                        return false;
+                } else {
+                        pos = atomic_load_explicit(
+                                &queue->enqueue_pos,
+                                memory_order_relaxed);
+                }
+        }
+}
+
+bool pmt_mpmc_try_dequeue(pmt_mpmc_queue_t *queue, void *elem)
+{
+        assert(queue);
+
+        size_t pos = atomic_load_explicit(
+                &queue->dequeue_pos,
+                memory_order_relaxed);
+
+        for(;;) {
+                pmt_mpmc_slot_t *slot = pmt_mpmc_slot(queue, pos);
+
+                const size_t seq = atomic_load_explicit(
+                        &slot->sequence,
+                        memory_order_acquire);
+
+                const intptr_t diff = (intptr_t)(seq - (pos + 1));
+
+                if(diff == 0) {
+                        if(atomic_compare_exchange_weak_explicit(
+                                &queue->dequeue_pos,
+                                &pos,
+                                pos + 1,
+                                memory_order_relaxed,
+                                memory_order_relaxed))
+                        {
+                                if(elem) {
+                                        (void)memcpy(
+                                                elem,
+                                                pmt_mpmc_slot_element(slot),
+                                                queue->element_size);
+                                }
+                                atomic_store_explicit(
+                                        &slot->sequence,
+                                        pos + queue->mask + 1,
+                                        memory_order_release);
+                                pmt_mpmc_notify(
+                                        &queue->space_event,
+                                        &queue->space_waiters);
+                                return true;
+                        }
+                } else if(diff < 0) {
+                        /* the slot has not been filled for this lap */
+                        return false;
+                } else {
+                        pos = atomic_load_explicit(
+                                &queue->dequeue_pos,
+                                memory_order_relaxed);
+                }
+        }
+}
+
+void pmt_mpmc_enqueue(pmt_mpmc_queue_t *queue, const void *elem)
+{
+        assert(queue && elem);
+
+        while(!pmt_mpmc_try_enqueue(queue, elem)) {
+                const unsigned int event = atomic_load_explicit(
+                        &queue->space_event,
+                        memory_order_acquire);
+                (void)atomic_fetch_add_explicit(
+                        &queue->space_waiters,
+                        1,
+                        memory_order_seq_cst);
+                atomic_thread_fence(memory_order_seq_cst);
+                if(pmt_mpmc_try_enqueue(queue, elem)) {
+                        (void)atomic_fetch_sub_explicit(
+                                &queue->space_waiters,
+                                1,
+                                memory_order_relaxed);
+                        return;
+                }
+                pmt_mpmc_wait(&queue->space_event, event);
+                (void)atomic_fetch_sub_explicit(
+                        &queue->space_waiters,
+                        1,
+                        memory_order_relaxed);
+        }
+}
+
+void pmt_mpmc_dequeue(pmt_mpmc_queue_t *queue, void *elem)
+{
+        assert(queue);
+
+        while(!pmt_mpmc_try_dequeue(queue, elem)) {
+                const unsigned int event = atomic_load_explicit(
+                        &queue->items_event,
+                        memory_order_acquire);
+                (void)atomic_fetch_add_explicit(
+                        &queue->items_waiters,
+                        1,
+                        memory_order_seq_cst);
+                atomic_thread_fence(memory_order_seq_cst);
+                if(pmt_mpmc_try_dequeue(queue, elem)) {
+                        (void)atomic_fetch_sub_explicit(
+                                &queue->items_waiters,
+                                1,
+                                memory_order_relaxed);
+                        return;
+                }
+                pmt_mpmc_wait(&queue->items_event, event);
+                (void)atomic_fetch_sub_explicit(
+                        &queue->items_waiters,
+                        1,
+                        memory_order_relaxed);
+        }
+}
+
+size_t pmt_mpmc_size(pmt_mpmc_queue_t *queue)
+{
+        assert(queue);
+
+        const size_t
+                head = atomic_load_explicit(
+                        &queue->dequeue_pos,
+                        memory_order_relaxed),
+                tail = atomic_load_explicit(
+                        &queue->enqueue_pos,
+                        memory_order_relaxed),
+                size = tail - head;
+
+        /* the positions are read separately and may cross */
+
+        if((intptr_t)size < 0) {
+                return 0;
+        }
+
+        return size > queue->mask ? queue->mask + 1 : size;
+}
+
+size_t pmt_mpmc_capacity(pmt_mpmc_queue_t *queue)
+{
+        assert(queue);
+
+        return queue->mask + 1;
+}
@@ -0,0 +1,107 @@
+#include "pubmt/mpsc_queue.h"
+#include <assert.h>
+
+pmt_mpsc_queue_t *pmt_mpsc_init(
+        pmt_ll_node_iface_t *iface,
+        pmt_mpsc_queue_t *queue,
+        void *stub)
+{
+        assert(queue && stub && pmt_ll_node_iface_validate(iface));
+
+        iface->set_next(stub, NULL);
+
+        queue->stub = stub;
+        queue->tail = stub;
+
+        atomic_init(&queue->head, stub);
+
+        return queue;
+}
+
+void pmt_mpsc_push(
+        pmt_ll_node_iface_t *iface,
+        pmt_mpsc_queue_t *queue,
+        void *node)
+{
+        assert(queue && node && pmt_ll_node_iface_validate(iface));
+
+        iface->set_next(node, NULL);
+
+        void *prev = atomic_exchange_explicit(
+                &queue->head,
+                node,
+                memory_order_acq_rel);
+
+        /* Until this store lands the consumer sees the list end at prev. */
+
+        atomic_thread_fence(memory_order_release);
+
+        iface->set_next(prev, node);
+}
+
+/** Read the next pointer, ordering the node's contents after it. */
+static void *pmt_mpsc_next(pmt_ll_node_iface_t *iface, void *node)
+{
+        void *next = iface->get_next(node);
+
+        atomic_thread_fence(memory_order_acquire);
+
+        return next;
+}
+
+void *pmt_mpsc_pop(pmt_ll_node_iface_t *iface, pmt_mpsc_queue_t *queue)
+{
+        assert(queue && pmt_ll_node_iface_validate(iface));
+
+        void
+                *tail = queue->tail,
+                *next = pmt_mpsc_next(iface, tail);
+
+        if(tail == queue->stub) {
+                if(!next) {
+                        return NULL;
+                }
+                queue->tail = next;
+                tail = next;
+                next = pmt_mpsc_next(iface, next);
+        }
+
+        if(next) {
+                queue->tail = next;
+                return tail;
+        }
+
+        void *head = atomic_load_explicit(&queue->head, memory_order_acquire);
+
+        if(tail != head) {
+                /* a producer is between its exchange and its link */
+                return NULL;
+        }
+
+        /* The tail is the last node, push the stub behind it so the tail can
+           be handed out while the queue stays non-empty. */
+
+        pmt_mpsc_push(iface, queue, queue->stub);
+
+        next = pmt_mpsc_next(iface, tail);
+
+        if(next) {
+                queue->tail = next;
+                return tail;
+        }
+
+        return NULL;
+}
+
+bool pmt_mpsc_is_empty(pmt_ll_node_iface_t *iface, pmt_mpsc_queue_t *queue)
+{
+        assert(queue && pmt_ll_node_iface_validate(iface));
+
+        void *tail = queue->tail;
+
+        if(tail != queue->stub) {
+                return false;
+        }
+
+        return atomic_load_explicit(&queue->head, memory_order_acquire) == tail;
+}
@@ -0,0 +1,323 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "pubmt/multi_queue.h"
+#include <stdint.h>
+#include <sched.h>
+#include <assert.h>
+
+static pmt_da_alloc_t pmt_mq_get_alloc(void *heap)
+{
+        return ((pmt_mq_heap_t*)heap)->queue->alloc;
+}
+
+static pmt_da_realloc_t pmt_mq_get_realloc(void *heap)
+{
+        return ((pmt_mq_heap_t*)heap)->queue->realloc;
+}
+
+static pmt_da_free_t pmt_mq_get_free(void *heap)
+{
+        return ((pmt_mq_heap_t*)heap)->queue->free;
+}
+
+static void *pmt_mq_get_alloc_state(void *heap)
+{
+        return ((pmt_mq_heap_t*)heap)->queue->alloc_state;
+}
+
+static size_t pmt_mq_get_element_size(void *heap)
+{
+        return ((pmt_mq_heap_t*)heap)->queue->element_size;
+}
+
+static size_t pmt_mq_get_capacity(void *heap)
+{
+        return ((pmt_mq_heap_t*)heap)->capacity;
+}
+
+static void pmt_mq_set_capacity(void *heap, const size_t capacity)
+{
+        ((pmt_mq_heap_t*)heap)->capacity = capacity;
+}
+
+static size_t pmt_mq_get_size(void *heap)
+{
+        return ((pmt_mq_heap_t*)heap)->size;
+}
+
+static void pmt_mq_set_size(void *heap, const size_t size)
+{
+        ((pmt_mq_heap_t*)heap)->size = size;
+}
+
+static void *pmt_mq_get_buffer(void *heap)
+{
+        return ((pmt_mq_heap_t*)heap)->buffer;
+}
+
+static void pmt_mq_set_buffer(void *heap, void *buffer)
+{
+        ((pmt_mq_heap_t*)heap)->buffer = buffer;
+}
+
+static pmt_bh_less_than_t pmt_mq_get_less_than(void *heap)
+{
+        return ((pmt_mq_heap_t*)heap)->queue->less_than;
+}
+
+/* Without a swap callback the heaps sift through a hole. */
+static pmt_bh_iface_t pmt_mq_heap_iface = {
+        .get_less_than = pmt_mq_get_less_than,
+        .array_iface = {
+                .get_alloc = pmt_mq_get_alloc,
+                .get_realloc = pmt_mq_get_realloc,
+                .get_free = pmt_mq_get_free,
+                .get_alloc_state = pmt_mq_get_alloc_state,
+                .get_element_size = pmt_mq_get_element_size,
+                .get_capacity = pmt_mq_get_capacity,
+                .set_capacity = pmt_mq_set_capacity,
+                .get_size = pmt_mq_get_size,
+                .set_size = pmt_mq_set_size,
+                .get_buffer = pmt_mq_get_buffer,
+                .set_buffer = pmt_mq_set_buffer
+        }
+};
+
+/* Per thread random heap selection. */
+static _Thread_local unsigned long long pmt_mq_seed = 0;
+
+static atomic_ullong pmt_mq_seeds = 0;
+
+static size_t pmt_mq_random(const size_t bound)
+{
+        unsigned long long x = pmt_mq_seed;
+
+        if(!x) {
+                /* distinct odd seeds from a Weyl sequence */
+                x = atomic_fetch_add_explicit(
+                        &pmt_mq_seeds,
+                        0x9E3779B97F4A7C15ULL,
+                        memory_order_relaxed);
+                x = (x ^ (uintptr_t)&pmt_mq_seed) | 1;
+        }
+
+        /* xorshift64 */
+
+        x ^= x << 13;
+        x ^= x >> 7;
+        x ^= x << 17;
+
+        pmt_mq_seed = x;
+
+        return (size_t)(x % bound);
+}
+
+static bool pmt_mq_try_lock(pmt_mq_heap_t *heap)
+{
+        return
+                !atomic_load_explicit(&heap->locked, memory_order_relaxed) &&
+                !atomic_exchange_explicit(
+                        &heap->locked,
+                        true,
+                        memory_order_acquire);
+}
+
+static void pmt_mq_lock(pmt_mq_heap_t *heap)
+{
+        while(!pmt_mq_try_lock(heap)) {
+                sched_yield();
+        }
+}
+
+static void pmt_mq_unlock(pmt_mq_heap_t *heap)
+{
+        atomic_store_explicit(&heap->locked, false, memory_order_release);
+}
+
+/* Pop from a locked heap and unlock it. */
+static bool pmt_mq_take(
+        pmt_mq_queue_t *queue,
+        pmt_mq_heap_t *heap,
+        void *elem)
+{
+        const bool popped = pmt_bh_pop(&pmt_mq_heap_iface, heap, elem);
+
+        /* count under the lock, the element was counted under it too */
+
+        if(popped) {
+                atomic_fetch_sub_explicit(
+                        &queue->size,
+                        1,
+                        memory_order_relaxed);
+        }
+
+        pmt_mq_unlock(heap);
+
+        return popped;
+}
+
+pmt_mq_queue_t *pmt_mq_create(
+        pmt_mq_queue_t *queue,
+        const size_t nheaps,
+        const size_t element_size,
+        pmt_bh_less_than_t less_than,
+        pmt_da_alloc_t alloc,
+        pmt_da_realloc_t realloc,
+        pmt_da_free_t free,
+        void *alloc_state)
+{
+        assert(queue && nheaps >= 2 && element_size && less_than);
+        assert(alloc && realloc && free);
+
+        if(nheaps > SIZE_MAX / sizeof(pmt_mq_heap_t)) {
+                return NULL;
+        }
+
+        queue->heaps = alloc(nheaps * sizeof(pmt_mq_heap_t), alloc_state);
+        if(!queue->heaps) {
+                return NULL;
+        }
+
+        queue->nheaps = nheaps;
+        queue->element_size = element_size;
+        queue->less_than = less_than;
+        queue->alloc = alloc;
+        queue->realloc = realloc;
+        queue->free = free;
+        queue->alloc_state = alloc_state;
+
+        atomic_init(&queue->size, 0);
+
+        for(size_t x = 0; x < nheaps; ++x) {
+                pmt_mq_heap_t *heap = queue->heaps + x;
+                atomic_init(&heap->locked, false);
+                heap->queue = queue;
+                (void)pmt_da_init(
+                        &pmt_mq_heap_iface.array_iface,
+                        heap,
+                        NULL,
+                        0,
+                        0);
+        }
+
+        return queue;
+}
+
+void pmt_mq_destroy(pmt_mq_queue_t *queue)
+{
+        assert(queue);
+
+        for(size_t x = 0; x < queue->nheaps; ++x) {
+                pmt_mq_heap_t *heap = queue->heaps + x;
+                if(heap->buffer) {
+                        pmt_da_destroy(&pmt_mq_heap_iface.array_iface, heap);
+                }
+        }
+
+        queue->free(queue->heaps, queue->alloc_state);
+}
+
+size_t pmt_mq_size(pmt_mq_queue_t *queue)
+{
+        assert(queue);
+
+        return atomic_load_explicit(&queue->size, memory_order_relaxed);
+}
+
+bool pmt_mq_insert(pmt_mq_queue_t *queue, void *elem)
+{
+        assert(queue && elem);
+
+        pmt_mq_heap_t *heap = NULL;
+
+        do {
+                heap = queue->heaps + pmt_mq_random(queue->nheaps);
+        } while(!pmt_mq_try_lock(heap));
+
+        void *inserted = pmt_bh_insert(&pmt_mq_heap_iface, heap, elem);
+
+        /* count before unlocking, so a pop never decrements first */
+
+        if(inserted) {
+                atomic_fetch_add_explicit(
+                        &queue->size,
+                        1,
+                        memory_order_relaxed);
+        }
+
+        pmt_mq_unlock(heap);
+
+        return inserted != NULL;
+}
+
+bool pmt_mq_pop(pmt_mq_queue_t *queue, void *elem)
+{
+        assert(queue);
+
+        const size_t nheaps = queue->nheaps;
+
+        for(size_t tries = 0; tries < PMT_MQ_POP_TRIES; ++tries) {
+
+                if(!atomic_load_explicit(&queue->size, memory_order_relaxed)) {
+                        break;
+                }
+
+                const size_t
+                        first = pmt_mq_random(nheaps),
+                        second = (first + 1 + pmt_mq_random(nheaps - 1)) %
+                                nheaps;
+
+                pmt_mq_heap_t
+                        *a = queue->heaps + first,
+                        *b = queue->heaps + second;
+
+                if(!pmt_mq_try_lock(a)) {
+                        continue;
+                }
+
+                /* with both heaps locked, keep the one with the better top */
+
+                if(pmt_mq_try_lock(b)) {
+
+                        void
+                                *top_a = pmt_bh_peek(&pmt_mq_heap_iface, a),
+                                *top_b = pmt_bh_peek(&pmt_mq_heap_iface, b);
+
+                        if(!top_a ||
+                                (top_b && queue->less_than(top_b, top_a))) {
+                                pmt_mq_heap_t *tmp = a;
+                                a = b;
+                                b = tmp;
+                        }
+
+                        pmt_mq_unlock(b);
+                }
+
+                if(pmt_mq_take(queue, a, elem)) {
+                        return true;
+                }
+        }
+
+        /* an empty queue is not scanned, idle pollers would lock every heap */
+
+        if(!atomic_load_explicit(&queue->size, memory_order_relaxed)) {
+                return false;
+        }
+
+        /* the samples were empty or busy, look at every heap in turn */
+
+        const size_t start = pmt_mq_random(nheaps);
+
+        for(size_t x = 0; x < nheaps; ++x) {
+
+                pmt_mq_heap_t *heap = queue->heaps + (start + x) % nheaps;
+
+                pmt_mq_lock(heap);
+
+                if(pmt_mq_take(queue, heap, elem)) {
+                        return true;
+                }
+        }
+
+        return false;
+}
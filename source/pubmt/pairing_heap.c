@@ -0,0 +1,246 @@
+#include "pubmt/pairing_heap.h"
+#include <assert.h>
+
+bool pmt_ph_iface_validate(pmt_ph_iface_t *iface)
+{
+        return
+                iface &&
+                iface->node_iface.get_child &&
+                iface->node_iface.set_child &&
+                iface->node_iface.get_next &&
+                iface->node_iface.set_next &&
+                iface->node_iface.get_prev &&
+                iface->node_iface.set_prev &&
+                iface->node_iface.get_key &&
+                iface->get_less_than &&
+                iface->get_root &&
+                iface->set_root;
+}
+
+/*
+ * Link two detached trees, the root with the larger key becomes the first
+ * child of the other.
+ *
+ * @returns The root of the linked tree.
+ */
+static void *pmt_ph_link(
+        pmt_ph_node_iface_t *iface,
+        pmt_ph_less_than_t less_than,
+        void *a,
+        void *b)
+{
+        if(less_than(iface->get_key(b), iface->get_key(a))) {
+                void *tmp = a;
+                a = b;
+                b = tmp;
+        }
+
+        void *child = iface->get_child(a);
+
+        iface->set_next(b, child);
+        if(child) {
+                iface->set_prev(child, b);
+        }
+
+        iface->set_prev(b, a);
+        iface->set_child(a, b);
+
+        return a;
+}
+
+/*
+ * Combine a list of siblings into a single tree with the two-pass pairing
+ * strategy.  The first pass links pairs from left to right and stacks them
+ * through their 'next' links, the second pass links the stack into one tree.
+ */
+static void *pmt_ph_merge_pairs(
+        pmt_ph_node_iface_t *iface,
+        pmt_ph_less_than_t less_than,
+        void *first)
+{
+        void *stack = NULL;
+
+        while(first) {
+
+                void *a = first, *b = iface->get_next(a);
+
+                if(!b) {
+                        iface->set_next(a, stack);
+                        stack = a;
+                        break;
+                }
+
+                first = iface->get_next(b);
+
+                void *pair = pmt_ph_link(iface, less_than, a, b);
+
+                iface->set_next(pair, stack);
+                stack = pair;
+        }
+
+        if(!stack) {
+                return NULL;
+        }
+
+        void *root = stack;
+
+        stack = iface->get_next(stack);
+
+        while(stack) {
+                void *next = iface->get_next(stack);
+                root = pmt_ph_link(iface, less_than, root, stack);
+                stack = next;
+        }
+
+        iface->set_next(root, NULL);
+        iface->set_prev(root, NULL);
+
+        return root;
+}
+
+/* Detach a non-root node, along with its subtree, from its parent. */
+static void pmt_ph_cut(pmt_ph_node_iface_t *iface, void *node)
+{
+        void
+                *prev = iface->get_prev(node),
+                *next = iface->get_next(node);
+
+        assert(prev);
+
+        if(iface->get_child(prev) == node) {
+                iface->set_child(prev, next);
+        } else {
+                iface->set_next(prev, next);
+        }
+
+        if(next) {
+                iface->set_prev(next, prev);
+        }
+
+        iface->set_next(node, NULL);
+        iface->set_prev(node, NULL);
+}
+
+/* Link a detached tree with the root of the heap. */
+static void pmt_ph_add(pmt_ph_iface_t *iface, void *heap, void *tree)
+{
+        void *root = iface->get_root(heap);
+
+        if(root) {
+                root = pmt_ph_link(
+                        &iface->node_iface,
+                        iface->get_less_than(heap),
+                        root,
+                        tree);
+        } else {
+                root = tree;
+        }
+
+        iface->set_root(heap, root);
+}
+
+void *pmt_ph_init(pmt_ph_iface_t *iface, void *heap)
+{
+        assert(heap && pmt_ph_iface_validate(iface));
+        iface->set_root(heap, NULL);
+        return heap;
+}
+
+bool pmt_ph_is_empty(pmt_ph_iface_t *iface, void *heap)
+{
+        assert(heap && pmt_ph_iface_validate(iface));
+        return iface->get_root(heap) == NULL;
+}
+
+void *pmt_ph_peek(pmt_ph_iface_t *iface, void *heap)
+{
+        assert(heap && pmt_ph_iface_validate(iface));
+        return iface->get_root(heap);
+}
+
+void pmt_ph_insert(pmt_ph_iface_t *iface, void *heap, void *node)
+{
+        assert(heap && node && pmt_ph_iface_validate(iface));
+
+        pmt_ph_node_iface_t *node_iface = &iface->node_iface;
+
+        node_iface->set_child(node, NULL);
+        node_iface->set_next(node, NULL);
+        node_iface->set_prev(node, NULL);
+
+        pmt_ph_add(iface, heap, node);
+}
+
+void pmt_ph_meld(pmt_ph_iface_t *iface, void *heap, void *other)
+{
+        assert(heap && other && pmt_ph_iface_validate(iface));
+
+        void *tree = iface->get_root(other);
+
+        if(tree) {
+                iface->set_root(other, NULL);
+                pmt_ph_add(iface, heap, tree);
+        }
+}
+
+void *pmt_ph_pop(pmt_ph_iface_t *iface, void *heap)
+{
+        assert(heap && pmt_ph_iface_validate(iface));
+
+        pmt_ph_node_iface_t *node_iface = &iface->node_iface;
+
+        void *root = iface->get_root(heap);
+
+        if(!root) {
+                return NULL;
+        }
+
+        iface->set_root(
+                heap,
+                pmt_ph_merge_pairs(
+                        node_iface,
+                        iface->get_less_than(heap),
+                        node_iface->get_child(root)));
+
+        node_iface->set_child(root, NULL);
+
+        return root;
+}
+
+void pmt_ph_decrease(pmt_ph_iface_t *iface, void *heap, void *node)
+{
+        assert(heap && node && pmt_ph_iface_validate(iface));
+
+        if(node == iface->get_root(heap)) {
+                return;
+        }
+
+        pmt_ph_cut(&iface->node_iface, node);
+
+        pmt_ph_add(iface, heap, node);
+}
+
+void pmt_ph_remove(pmt_ph_iface_t *iface, void *heap, void *node)
+{
+        assert(heap && node && pmt_ph_iface_validate(iface));
+
+        if(node == iface->get_root(heap)) {
+                (void)pmt_ph_pop(iface, heap);
+                return;
+        }
+
+        pmt_ph_node_iface_t *node_iface = &iface->node_iface;
+
+        pmt_ph_cut(node_iface, node);
+
+        void *tree = pmt_ph_merge_pairs(
+                node_iface,
+                iface->get_less_than(heap),
+                node_iface->get_child(node));
+
+        node_iface->set_child(node, NULL);
+
+        if(tree) {
+                pmt_ph_add(iface, heap, tree);
+        }
+}
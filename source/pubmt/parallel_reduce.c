@@ -0,0 +1,283 @@
+#include "pubmt/parallel_reduce.h"
+#include <stdint.h>
+#include <assert.h>
+
+/** Accumulators are a cache line apart so chunks do not share lines. */
+#define PMT_PR_STRIDE PMT_TP_CACHE_LINE
+
+/** Split of a range over chunks, each with an accumulator. */
+typedef struct pmt_pr_shared {
+
+        size_t length, nchunks;
+
+        uint8_t *accumulators;
+        size_t stride;
+
+        void *state;
+
+        /* hash map scans */
+        pmt_hm_iface_t *hm_iface;
+        void **buckets;
+        pmt_hm_visit_t visit;
+
+        /* array reductions */
+        uint8_t *elements;
+        size_t element_size;
+        pmt_da_fold_t fold;
+
+} pmt_pr_shared_t;
+
+static size_t pmt_pr_nchunks(pmt_tp_pool_t *pool, const size_t length)
+{
+        size_t nchunks = pmt_tp_size(pool) * PMT_PR_CHUNKS_PER_WORKER;
+
+        if(nchunks > length / PMT_PR_MIN_CHUNK) {
+                nchunks = length / PMT_PR_MIN_CHUNK;
+        }
+
+        return nchunks ? nchunks : 1;
+}
+
+static void pmt_pr_bounds(
+        pmt_pr_shared_t *shared,
+        const size_t chunk,
+        size_t *begin,
+        size_t *end)
+{
+        const size_t
+                base = shared->length / shared->nchunks,
+                extra = shared->length % shared->nchunks;
+
+        /* the first 'extra' chunks are one longer */
+
+        *begin = chunk * base + (chunk < extra ? chunk : extra);
+        *end = *begin + base + (chunk < extra ? 1 : 0);
+}
+
+static void pmt_pr_visit_buckets(
+        pmt_pr_shared_t *shared,
+        const size_t begin,
+        const size_t end,
+        void *accumulator)
+{
+        pmt_ll_node_iface_t *node_iface = &shared->hm_iface->node_iface;
+
+        for(size_t b = begin; b < end; ++b) {
+                void *node = shared->buckets[b];
+                while(node) {
+                        void *next = node_iface->get_next(node);
+                        shared->visit(node, accumulator, shared->state);
+                        node = next;
+                }
+        }
+}
+
+static void pmt_pr_fold_elements(
+        pmt_pr_shared_t *shared,
+        const size_t begin,
+        const size_t end,
+        void *accumulator)
+{
+        if(begin < end) {
+                shared->fold(
+                        shared->elements + begin * shared->element_size,
+                        end - begin,
+                        accumulator,
+                        shared->state);
+        }
+}
+
+static void *pmt_pr_accumulator(pmt_pr_shared_t *shared, const size_t chunk)
+{
+        return shared->stride ?
+                shared->accumulators + chunk * shared->stride :
+                NULL;
+}
+
+static void pmt_pr_hm_body(
+        const size_t begin,
+        const size_t end,
+        void *state)
+{
+        pmt_pr_shared_t *shared = state;
+
+        for(size_t chunk = begin; chunk < end; ++chunk) {
+                size_t first, last;
+                pmt_pr_bounds(shared, chunk, &first, &last);
+                pmt_pr_visit_buckets(
+                        shared,
+                        first,
+                        last,
+                        pmt_pr_accumulator(shared, chunk));
+        }
+}
+
+static void pmt_pr_da_body(
+        const size_t begin,
+        const size_t end,
+        void *state)
+{
+        pmt_pr_shared_t *shared = state;
+
+        for(size_t chunk = begin; chunk < end; ++chunk) {
+                size_t first, last;
+                pmt_pr_bounds(shared, chunk, &first, &last);
+                pmt_pr_fold_elements(
+                        shared,
+                        first,
+                        last,
+                        pmt_pr_accumulator(shared, chunk));
+        }
+}
+
+/*
+ * Set up an accumulator per chunk, run the chunks on the pool and combine
+ * the accumulators in chunk order.
+ */
+static bool pmt_pr_run(
+        pmt_pr_shared_t *shared,
+        pmt_da_iface_t *array_iface,
+        void *array,
+        pmt_tp_pool_t *pool,
+        pmt_tp_body_t body,
+        void *accumulator,
+        const size_t acc_size,
+        pmt_pr_init_t init,
+        pmt_pr_combine_t combine)
+{
+        const size_t nchunks = shared->nchunks;
+
+        shared->accumulators = NULL;
+        shared->stride = 0;
+
+        pmt_da_free_t free = array_iface->get_free(array);
+        void *alloc_state = array_iface->get_alloc_state(array);
+
+        if(acc_size) {
+                const size_t stride =
+                        (acc_size + PMT_PR_STRIDE - 1) / PMT_PR_STRIDE *
+                        PMT_PR_STRIDE;
+
+                if(stride < acc_size || SIZE_MAX / stride < nchunks) {
+                        return false;
+                }
+
+                shared->accumulators = array_iface->get_alloc(array)(
+                        stride * nchunks,
+                        alloc_state);
+
+                if(!shared->accumulators) {
+                        return false;
+                }
+
+                shared->stride = stride;
+
+                for(size_t chunk = 0; chunk < nchunks; ++chunk) {
+                        init(pmt_pr_accumulator(shared, chunk), shared->state);
+                }
+        }
+
+        pmt_tp_parallel_for(pool, 0, nchunks, 1, body, shared);
+
+        if(acc_size) {
+                for(size_t chunk = 0; chunk < nchunks; ++chunk) {
+                        combine(
+                                accumulator,
+                                pmt_pr_accumulator(shared, chunk),
+                                shared->state);
+                }
+                free(shared->accumulators, alloc_state);
+        }
+
+        return true;
+}
+
+bool pmt_hm_parallel_foreach(
+        pmt_hm_iface_t *iface,
+        void *map,
+        pmt_tp_pool_t *pool,
+        pmt_hm_visit_t visit,
+        void *accumulator,
+        const size_t acc_size,
+        pmt_pr_init_t init,
+        pmt_pr_combine_t combine,
+        void *state)
+{
+        assert(map && pool && visit && pmt_hm_iface_validate(iface));
+        assert(!acc_size || (accumulator && init && combine));
+
+        pmt_da_iface_t *array_iface = &iface->array_iface;
+
+        pmt_pr_shared_t shared = {
+                .length = array_iface->get_capacity(map),
+                .state = state,
+                .hm_iface = iface,
+                .buckets = array_iface->get_buffer(map),
+                .visit = visit };
+
+        shared.nchunks = pmt_pr_nchunks(pool, shared.length);
+
+        if(shared.nchunks == 1) {
+                pmt_pr_visit_buckets(
+                        &shared,
+                        0,
+                        shared.length,
+                        acc_size ? accumulator : NULL);
+                return true;
+        }
+
+        return pmt_pr_run(
+                &shared,
+                array_iface,
+                map,
+                pool,
+                pmt_pr_hm_body,
+                accumulator,
+                acc_size,
+                init,
+                combine);
+}
+
+bool pmt_da_parallel_reduce(
+        pmt_da_iface_t *iface,
+        void *array,
+        pmt_tp_pool_t *pool,
+        pmt_da_fold_t fold,
+        void *accumulator,
+        const size_t acc_size,
+        pmt_pr_init_t init,
+        pmt_pr_combine_t combine,
+        void *state)
+{
+        assert(array && pool && fold && pmt_da_iface_validate(iface));
+        assert(!acc_size || (accumulator && init && combine));
+
+        pmt_pr_shared_t shared = {
+                .length = iface->get_size(array),
+                .state = state,
+                .elements = iface->get_buffer(array),
+                .element_size = iface->get_element_size(array),
+                .fold = fold };
+
+        shared.nchunks = pmt_pr_nchunks(pool, shared.length);
+
+        if(shared.nchunks == 1) {
+                pmt_pr_fold_elements(
+                        &shared,
+                        0,
+                        shared.length,
+                        acc_size ? accumulator : NULL);
+                return true;
+        }
+
+        return pmt_pr_run(
+                &shared,
+                iface,
+                array,
+                pool,
+                pmt_pr_da_body,
+                accumulator,
+                acc_size,
+                init,
+                combine);
+}
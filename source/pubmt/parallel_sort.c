@@ -0,0 +1,486 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "pubmt/parallel_sort.h"
+#include <pthread.h>
+#include <stddef.h>
+#include <string.h>
+#include <assert.h>
+
+/** Arrays with fewer elements per thread are sorted with fewer threads. */
+#define PMT_PS_MIN_CHUNK 4096
+
+/** Sampled elements per splitter. */
+#define PMT_PS_OVERSAMPLE 32
+
+/** Round a region length up so the next region is suitably aligned. */
+#define PMT_PS_ALIGN(n) \
+        (((n) + _Alignof(max_align_t) - 1) & ~(_Alignof(max_align_t) - 1))
+
+/** 
+ * View over a region of a dynamic array, so buckets and samples can be 
+ * sorted with pmt_da_sort using the array's own allocator.
+ */
+typedef struct pmt_ps_view {
+
+        pmt_da_iface_t *iface;
+
+        void *array, *buffer;
+
+        size_t size, element_size;
+
+} pmt_ps_view_t;
+
+static pmt_da_alloc_t pmt_ps_get_alloc(void *view)
+{
+        pmt_ps_view_t *v = view;
+        return v->iface->get_alloc(v->array);
+}
+
+static pmt_da_realloc_t pmt_ps_get_realloc(void *view)
+{
+        pmt_ps_view_t *v = view;
+        return v->iface->get_realloc(v->array);
+}
+
+static pmt_da_free_t pmt_ps_get_free(void *view)
+{
+        pmt_ps_view_t *v = view;
+        return v->iface->get_free(v->array);
+}
+
+static void *pmt_ps_get_alloc_state(void *view)
+{
+        pmt_ps_view_t *v = view;
+        return v->iface->get_alloc_state(v->array);
+}
+
+static size_t pmt_ps_get_element_size(void *view)
+{
+        return ((pmt_ps_view_t*)view)->element_size;
+}
+
+static size_t pmt_ps_get_size(void *view)
+{
+        return ((pmt_ps_view_t*)view)->size;
+}
+
+static void pmt_ps_set_size(void *view, const size_t size)
+{
+        ((pmt_ps_view_t*)view)->size = size;
+}
+
+static void *pmt_ps_get_buffer(void *view)
+{
+        return ((pmt_ps_view_t*)view)->buffer;
+}
+
+static void pmt_ps_set_buffer(void *view, void *buffer)
+{
+        ((pmt_ps_view_t*)view)->buffer = buffer;
+}
+
+static pmt_da_iface_t pmt_ps_view_iface = {
+        .get_alloc = pmt_ps_get_alloc,
+        .get_realloc = pmt_ps_get_realloc,
+        .get_free = pmt_ps_get_free,
+        .get_alloc_state = pmt_ps_get_alloc_state,
+        .get_element_size = pmt_ps_get_element_size,
+        .get_capacity = pmt_ps_get_size,
+        .set_capacity = pmt_ps_set_size,
+        .get_size = pmt_ps_get_size,
+        .set_size = pmt_ps_set_size,
+        .get_buffer = pmt_ps_get_buffer,
+        .set_buffer = pmt_ps_set_buffer
+};
+
+/** State shared by every sorting thread. */
+typedef struct pmt_ps_shared {
+
+        pmt_da_iface_t *iface;
+
+        void *array;
+
+        pmt_da_less_than_t less_than;
+
+        uint8_t *buffer, *tmp, *splitters;
+
+        uint32_t *buckets;
+
+        /* per thread bucket counts, [thread * nthreads + bucket] */
+        size_t *counts;
+
+        /* start of each bucket within tmp, nthreads + 1 entries */
+        size_t *offsets;
+
+        size_t size, element_size, nthreads;
+
+        /* runs the phases when non-NULL, instead of new threads */
+        pmt_tp_pool_t *pool;
+
+} pmt_ps_shared_t;
+
+typedef struct pmt_ps_task {
+
+        pmt_ps_shared_t *shared;
+
+        size_t index;
+
+        void *(*phase)(void*);
+
+        pmt_tp_task_t pool_task;
+
+} pmt_ps_task_t;
+
+static void pmt_ps_chunk(
+        pmt_ps_shared_t *shared, 
+        const size_t index,
+        size_t *begin,
+        size_t *end)
+{
+        *begin = shared->size / shared->nthreads * index;
+        *end = index + 1 == shared->nthreads ? 
+                shared->size : 
+                shared->size / shared->nthreads * (index + 1);
+}
+
+/*
+ * Count the splitters that are not greater than the element.  An element
+ * equal to a run of splitters may go to any bucket from the first of the run
+ * to the one after it, since the buckets in between can hold nothing else,
+ * so such elements are spread over them by their position.  This keeps low
+ * cardinality inputs from piling into one bucket.
+ */
+static uint32_t pmt_ps_bucket(
+        pmt_ps_shared_t *shared,
+        void *elem,
+        const size_t position)
+{
+        const size_t elem_size = shared->element_size;
+
+        size_t base = 0, length = shared->nthreads - 1;
+
+        while(length > 0) {
+                const size_t half = length / 2;
+                void *splitter = shared->splitters + (base + half) * elem_size;
+                if(shared->less_than(elem, splitter)) {
+                        length = half;
+                } else {
+                        base += half + 1;
+                        length -= half + 1;
+                }
+        }
+
+        if(!base || shared->less_than(
+                shared->splitters + (base - 1) * elem_size,
+                elem))
+        {
+                return (uint32_t)base;
+        }
+
+        /* The element equals splitter 'base - 1', find the first equal. */
+
+        size_t first = 0;
+
+        length = base - 1;
+
+        while(length > 0) {
+                const size_t half = length / 2;
+                void *splitter = shared->splitters + (first + half) * elem_size;
+                if(shared->less_than(splitter, elem)) {
+                        first += half + 1;
+                        length -= half + 1;
+                } else {
+                        length = half;
+                }
+        }
+
+        return (uint32_t)(first + position % (base - first + 1));
+}
+
+static void *pmt_ps_classify(void *arg)
+{
+        pmt_ps_task_t *task = arg;
+        pmt_ps_shared_t *shared = task->shared;
+
+        size_t begin, end;
+        pmt_ps_chunk(shared, task->index, &begin, &end);
+
+        size_t *counts = shared->counts + task->index * shared->nthreads;
+
+        for(size_t i = begin; i < end; ++i) {
+                const uint32_t bucket = pmt_ps_bucket(
+                        shared,
+                        shared->buffer + i * shared->element_size,
+                        i);
+                shared->buckets[i] = bucket;
+                ++counts[bucket];
+        }
+
+        return NULL;
+}
+
+static void *pmt_ps_scatter(void *arg)
+{
+        pmt_ps_task_t *task = arg;
+        pmt_ps_shared_t *shared = task->shared;
+
+        const size_t elem_size = shared->element_size;
+
+        size_t begin, end;
+        pmt_ps_chunk(shared, task->index, &begin, &end);
+
+        /* After the prefix sum, counts hold this thread's write positions. */
+
+        size_t *positions = shared->counts + task->index * shared->nthreads;
+
+        for(size_t i = begin; i < end; ++i) {
+                const size_t pos = positions[shared->buckets[i]]++;
+                (void)memcpy(
+                        shared->tmp + pos * elem_size,
+                        shared->buffer + i * elem_size,
+                        elem_size);
+        }
+
+        return NULL;
+}
+
+static void *pmt_ps_sort_bucket(void *arg)
+{
+        pmt_ps_task_t *task = arg;
+        pmt_ps_shared_t *shared = task->shared;
+
+        const size_t
+                elem_size = shared->element_size,
+                begin = shared->offsets[task->index],
+                end = shared->offsets[task->index + 1];
+
+        pmt_ps_view_t view = {
+                .iface = shared->iface,
+                .array = shared->array,
+                .buffer = shared->tmp + begin * elem_size,
+                .size = end - begin,
+                .element_size = elem_size };
+
+        pmt_da_sort(&pmt_ps_view_iface, &view, shared->less_than);
+
+        (void)memcpy(
+                shared->buffer + begin * elem_size, 
+                view.buffer, 
+                view.size * elem_size);
+
+        return NULL;
+}
+
+static void pmt_ps_pool_run(void *arg)
+{
+        pmt_ps_task_t *task = arg;
+
+        (void)task->phase(task);
+}
+
+/* Run one phase on every thread, doing the work of any thread that could not
+   be started on the calling thread.  With a pool the phase's tasks are 
+   spawned onto it instead. */
+static void pmt_ps_run(
+        pmt_ps_shared_t *shared,
+        pmt_ps_task_t *tasks,
+        pthread_t *threads,
+        bool *started,
+        void *(*phase)(void*))
+{
+        for(size_t t = 0; t < shared->nthreads; ++t) {
+                tasks[t].shared = shared;
+                tasks[t].index = t;
+                tasks[t].phase = phase;
+        }
+
+        if(shared->pool) {
+                pmt_tp_group_t group;
+                pmt_tp_group_init(&group);
+                for(size_t t = 1; t < shared->nthreads; ++t) {
+                        pmt_tp_spawn(
+                                shared->pool, 
+                                &group, 
+                                &tasks[t].pool_task, 
+                                pmt_ps_pool_run, 
+                                tasks + t);
+                }
+                (void)phase(tasks);
+                pmt_tp_wait(shared->pool, &group);
+                return;
+        }
+
+        for(size_t t = 1; t < shared->nthreads; ++t) {
+                started[t] = !pthread_create(threads + t, NULL, phase, tasks + t);
+        }
+
+        (void)phase(tasks);
+
+        for(size_t t = 1; t < shared->nthreads; ++t) {
+                if(started[t]) {
+                        (void)pthread_join(threads[t], NULL);
+                } else {
+                        (void)phase(tasks + t);
+                }
+        }
+}
+
+static bool pmt_ps_sort(
+        pmt_da_iface_t *iface, 
+        void *array, 
+        pmt_da_less_than_t less_than,
+        const size_t nthreads,
+        pmt_tp_pool_t *pool)
+{
+        assert(array && less_than && pmt_da_iface_validate(iface));
+
+        const size_t 
+                size = iface->get_size(array),
+                elem_size = iface->get_element_size(array);
+
+        size_t threads = nthreads;
+
+        if(threads > size / PMT_PS_MIN_CHUNK) {
+                threads = size / PMT_PS_MIN_CHUNK;
+        }
+        if(threads > UINT32_MAX) {
+                threads = UINT32_MAX;
+        }
+
+        if(threads < 2) {
+                pmt_da_sort(iface, array, less_than);
+                return true;
+        }
+
+        const size_t 
+                nsamples = threads * PMT_PS_OVERSAMPLE,
+                tmp_len = PMT_PS_ALIGN(size * elem_size),
+                buckets_len = PMT_PS_ALIGN(size * sizeof(uint32_t)),
+                samples_len = PMT_PS_ALIGN(nsamples * elem_size),
+                counts_len = PMT_PS_ALIGN(threads * threads * sizeof(size_t)),
+                offsets_len = PMT_PS_ALIGN((threads + 1) * sizeof(size_t)),
+                threads_len = PMT_PS_ALIGN(threads * sizeof(pthread_t)),
+                tasks_len = PMT_PS_ALIGN(threads * sizeof(pmt_ps_task_t)),
+                started_len = threads * sizeof(bool);
+
+        /* One allocation, every region length is rounded up so that element
+           regions are as aligned as the allocation itself. */
+
+        const size_t total = 
+                counts_len + offsets_len + threads_len + tasks_len +
+                buckets_len + tmp_len + samples_len + started_len;
+
+        pmt_da_alloc_t alloc = iface->get_alloc(array);
+        pmt_da_free_t free = iface->get_free(array);
+        void *alloc_state = iface->get_alloc_state(array);
+
+        uint8_t *memory = alloc(total, alloc_state);
+        if(!memory) {
+                return false;
+        }
+
+        pmt_ps_shared_t shared = {
+                .iface = iface,
+                .array = array,
+                .less_than = less_than,
+                .buffer = iface->get_buffer(array),
+                .size = size,
+                .element_size = elem_size,
+                .nthreads = threads,
+                .pool = pool };
+
+        uint8_t *region = memory;
+
+        shared.counts = (size_t*)region;
+        region += counts_len;
+        shared.offsets = (size_t*)region;
+        region += offsets_len;
+        pthread_t *thread_ids = (pthread_t*)region;
+        region += threads_len;
+        pmt_ps_task_t *tasks = (pmt_ps_task_t*)region;
+        region += tasks_len;
+        shared.buckets = (uint32_t*)region;
+        region += buckets_len;
+        shared.tmp = region;
+        region += tmp_len;
+        uint8_t *samples = region;
+        region += samples_len;
+        bool *started = (bool*)region;
+
+        /* Pick evenly spaced samples, sort them and keep every 
+           PMT_PS_OVERSAMPLE'th as a splitter. */
+
+        for(size_t s = 0; s < nsamples; ++s) {
+                (void)memcpy(
+                        samples + s * elem_size, 
+                        shared.buffer + (size / nsamples * s) * elem_size, 
+                        elem_size);
+        }
+
+        pmt_ps_view_t view = {
+                .iface = iface,
+                .array = array,
+                .buffer = samples,
+                .size = nsamples,
+                .element_size = elem_size };
+
+        pmt_da_sort(&pmt_ps_view_iface, &view, less_than);
+
+        for(size_t t = 1; t < threads; ++t) {
+                (void)memmove(
+                        samples + (t - 1) * elem_size, 
+                        samples + (t * PMT_PS_OVERSAMPLE) * elem_size,
+                        elem_size);
+        }
+
+        shared.splitters = samples;
+
+        (void)memset(shared.counts, 0, counts_len);
+
+        pmt_ps_run(&shared, tasks, thread_ids, started, pmt_ps_classify);
+
+        /* Turn the counts into write positions, bucket major. */
+
+        size_t sum = 0;
+
+        for(size_t b = 0; b < threads; ++b) {
+                shared.offsets[b] = sum;
+                for(size_t t = 0; t < threads; ++t) {
+                        size_t *count = shared.counts + t * threads + b;
+                        const size_t n = *count;
+                        *count = sum;
+                        sum += n;
+                }
+        }
+
+        shared.offsets[threads] = sum;
+
+        assert(sum == size);
+
+        pmt_ps_run(&shared, tasks, thread_ids, started, pmt_ps_scatter);
+        pmt_ps_run(&shared, tasks, thread_ids, started, pmt_ps_sort_bucket);
+
+        free(memory, alloc_state);
+
+        return true;
+}
+
+bool pmt_da_parallel_sort(
+        pmt_da_iface_t *iface, 
+        void *array, 
+        pmt_da_less_than_t less_than,
+        const size_t nthreads)
+{
+        return pmt_ps_sort(iface, array, less_than, nthreads, NULL);
+}
+
+bool pmt_da_parallel_sort_pool(
+        pmt_da_iface_t *iface, 
+        void *array, 
+        pmt_da_less_than_t less_than,
+        pmt_tp_pool_t *pool)
+{
+        assert(pool);
+
+        return pmt_ps_sort(iface, array, less_than, pmt_tp_size(pool), pool);
+}
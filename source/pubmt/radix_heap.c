@@ -0,0 +1,335 @@
+#include "pubmt/radix_heap.h"
+#include <string.h>
+#include <assert.h>
+
+static pmt_da_alloc_t pmt_rh_get_alloc(void *bucket)
+{
+        return ((pmt_rh_bucket_t*)bucket)->heap->alloc;
+}
+
+static pmt_da_realloc_t pmt_rh_get_realloc(void *bucket)
+{
+        return ((pmt_rh_bucket_t*)bucket)->heap->realloc;
+}
+
+static pmt_da_free_t pmt_rh_get_free(void *bucket)
+{
+        return ((pmt_rh_bucket_t*)bucket)->heap->free;
+}
+
+static void *pmt_rh_get_alloc_state(void *bucket)
+{
+        return ((pmt_rh_bucket_t*)bucket)->heap->alloc_state;
+}
+
+static size_t pmt_rh_get_entry_size(void *bucket)
+{
+        return ((pmt_rh_bucket_t*)bucket)->heap->entry_size;
+}
+
+static size_t pmt_rh_get_capacity(void *bucket)
+{
+        return ((pmt_rh_bucket_t*)bucket)->capacity;
+}
+
+static void pmt_rh_set_capacity(void *bucket, const size_t capacity)
+{
+        ((pmt_rh_bucket_t*)bucket)->capacity = capacity;
+}
+
+static size_t pmt_rh_get_size(void *bucket)
+{
+        return ((pmt_rh_bucket_t*)bucket)->size;
+}
+
+static void pmt_rh_set_size(void *bucket, const size_t size)
+{
+        ((pmt_rh_bucket_t*)bucket)->size = size;
+}
+
+static void *pmt_rh_get_buffer(void *bucket)
+{
+        return ((pmt_rh_bucket_t*)bucket)->buffer;
+}
+
+static void pmt_rh_set_buffer(void *bucket, void *buffer)
+{
+        ((pmt_rh_bucket_t*)bucket)->buffer = buffer;
+}
+
+static pmt_da_iface_t pmt_rh_bucket_iface = {
+        .get_alloc = pmt_rh_get_alloc,
+        .get_realloc = pmt_rh_get_realloc,
+        .get_free = pmt_rh_get_free,
+        .get_alloc_state = pmt_rh_get_alloc_state,
+        .get_element_size = pmt_rh_get_entry_size,
+        .get_capacity = pmt_rh_get_capacity,
+        .set_capacity = pmt_rh_set_capacity,
+        .get_size = pmt_rh_get_size,
+        .set_size = pmt_rh_set_size,
+        .get_buffer = pmt_rh_get_buffer,
+        .set_buffer = pmt_rh_set_buffer
+};
+
+/* Get the bucket for 'key', one past the highest bit differing from 'last'. */
+static size_t pmt_rh_bucket_index(const uint64_t last, const uint64_t key)
+{
+        uint64_t diff = key ^ last;
+
+        if(!diff) {
+                return 0;
+        }
+
+#if defined(__GNUC__)
+        return (size_t)(64 - __builtin_clzll((unsigned long long)diff));
+#else
+        size_t index = 0;
+        while(diff) {
+                diff >>= 1;
+                ++index;
+        }
+        return index;
+#endif
+}
+
+/* Entries are a key followed by the element, keeping keys aligned. */
+static void pmt_rh_store(
+        pmt_rh_heap_t *heap,
+        uint8_t *entry,
+        const uint64_t key,
+        void *elem)
+{
+        (void)memcpy(entry, &key, sizeof(uint64_t));
+
+        if(elem && heap->element_size) {
+                (void)memcpy(
+                        entry + sizeof(uint64_t),
+                        elem,
+                        heap->element_size);
+        }
+}
+
+static uint64_t pmt_rh_entry_key(uint8_t *entry)
+{
+        uint64_t key;
+        (void)memcpy(&key, entry, sizeof(uint64_t));
+        return key;
+}
+
+static void pmt_rh_note_key(pmt_rh_bucket_t *bucket, const uint64_t key)
+{
+        if(key < bucket->min) {
+                bucket->min = key;
+        }
+}
+
+/*
+ * Refill the first bucket from the lowest non-empty bucket.  Its smallest key
+ * becomes the last key, which sends every one of its entries to a lower
+ * bucket.  Room is reserved in the target buckets before anything moves, so
+ * an allocation failure leaves the heap unchanged.
+ */
+static bool pmt_rh_refill(pmt_rh_heap_t *heap)
+{
+        pmt_rh_bucket_t *buckets = heap->buckets;
+
+        if(buckets[0].size) {
+                return true;
+        }
+
+        size_t index = 1;
+
+        while(index < PMT_RH_BUCKETS && !buckets[index].size) {
+                ++index;
+        }
+
+        if(index == PMT_RH_BUCKETS) {
+                return false;
+        }
+
+        pmt_rh_bucket_t *source = buckets + index;
+
+        const uint64_t last = source->min;
+        const size_t entry_size = heap->entry_size;
+
+        uint8_t *entries = source->buffer;
+
+        size_t counts[PMT_RH_BUCKETS] = { 0 };
+
+        for(size_t x = 0; x < source->size; ++x) {
+                const uint64_t key = pmt_rh_entry_key(entries + x * entry_size);
+                ++counts[pmt_rh_bucket_index(last, key)];
+        }
+
+        for(size_t b = 0; b < index; ++b) {
+                if(counts[b] && !pmt_da_reserve(
+                        &pmt_rh_bucket_iface,
+                        buckets + b,
+                        buckets[b].size + counts[b]))
+                {
+                        return false;
+                }
+        }
+
+        heap->last = last;
+
+        for(size_t x = 0; x < source->size; ++x) {
+
+                uint8_t *entry = entries + x * entry_size;
+
+                const uint64_t key = pmt_rh_entry_key(entry);
+
+                pmt_rh_bucket_t *target =
+                        buckets + pmt_rh_bucket_index(last, key);
+
+                assert(target < source);
+
+                (void)memcpy(
+                        pmt_da_push_back(&pmt_rh_bucket_iface, target, NULL),
+                        entry,
+                        entry_size);
+
+                pmt_rh_note_key(target, key);
+        }
+
+        source->size = 0;
+        source->min = UINT64_MAX;
+
+        assert(buckets[0].size);
+
+        return true;
+}
+
+pmt_rh_heap_t *pmt_rh_init(
+        pmt_rh_heap_t *heap,
+        const size_t element_size,
+        pmt_da_alloc_t alloc,
+        pmt_da_realloc_t realloc,
+        pmt_da_free_t free,
+        void *alloc_state)
+{
+        assert(heap && alloc && realloc && free);
+
+        const size_t align = sizeof(uint64_t);
+
+        assert(element_size <= SIZE_MAX - 2 * align);
+
+        heap->last = 0;
+        heap->size = 0;
+        heap->element_size = element_size;
+        heap->entry_size = (align + element_size + align - 1) / align * align;
+        heap->alloc = alloc;
+        heap->realloc = realloc;
+        heap->free = free;
+        heap->alloc_state = alloc_state;
+
+        for(size_t b = 0; b < PMT_RH_BUCKETS; ++b) {
+                pmt_rh_bucket_t *bucket = heap->buckets + b;
+                bucket->heap = heap;
+                bucket->min = UINT64_MAX;
+                (void)pmt_da_init(&pmt_rh_bucket_iface, bucket, NULL, 0, 0);
+        }
+
+        return heap;
+}
+
+void pmt_rh_destroy(pmt_rh_heap_t *heap)
+{
+        assert(heap);
+
+        for(size_t b = 0; b < PMT_RH_BUCKETS; ++b) {
+                pmt_rh_bucket_t *bucket = heap->buckets + b;
+                if(bucket->buffer) {
+                        pmt_da_destroy(&pmt_rh_bucket_iface, bucket);
+                }
+        }
+}
+
+void pmt_rh_clear(pmt_rh_heap_t *heap)
+{
+        assert(heap);
+
+        for(size_t b = 0; b < PMT_RH_BUCKETS; ++b) {
+                heap->buckets[b].size = 0;
+                heap->buckets[b].min = UINT64_MAX;
+        }
+
+        heap->last = 0;
+        heap->size = 0;
+}
+
+size_t pmt_rh_size(pmt_rh_heap_t *heap)
+{
+        assert(heap);
+        return heap->size;
+}
+
+bool pmt_rh_is_empty(pmt_rh_heap_t *heap)
+{
+        assert(heap);
+        return heap->size == 0;
+}
+
+uint64_t pmt_rh_last_key(pmt_rh_heap_t *heap)
+{
+        assert(heap);
+        return heap->last;
+}
+
+void *pmt_rh_push(pmt_rh_heap_t *heap, const uint64_t key, void *elem)
+{
+        assert(heap && key >= heap->last);
+
+        pmt_rh_bucket_t *bucket =
+                heap->buckets + pmt_rh_bucket_index(heap->last, key);
+
+        uint8_t *entry = pmt_da_push_back(&pmt_rh_bucket_iface, bucket, NULL);
+        if(!entry) {
+                return NULL;
+        }
+
+        pmt_rh_store(heap, entry, key, elem);
+        pmt_rh_note_key(bucket, key);
+
+        ++heap->size;
+
+        return entry + sizeof(uint64_t);
+}
+
+void *pmt_rh_peek(pmt_rh_heap_t *heap, uint64_t *key)
+{
+        assert(heap);
+
+        if(!heap->size || !pmt_rh_refill(heap)) {
+                return NULL;
+        }
+
+        pmt_rh_bucket_t *first = heap->buckets;
+
+        uint8_t *entry =
+                (uint8_t*)first->buffer + (first->size - 1) * heap->entry_size;
+
+        if(key) {
+                *key = heap->last;
+        }
+
+        return entry + sizeof(uint64_t);
+}
+
+bool pmt_rh_pop(pmt_rh_heap_t *heap, uint64_t *key, void *elem)
+{
+        void *pointer = pmt_rh_peek(heap, key);
+
+        if(!pointer) {
+                return false;
+        }
+
+        if(elem && heap->element_size) {
+                (void)memcpy(elem, pointer, heap->element_size);
+        }
+
+        --heap->buckets[0].size;
+        --heap->size;
+
+        return true;
+}
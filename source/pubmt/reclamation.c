@@ -0,0 +1,626 @@
+#include "pubmt/reclamation.h"
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <assert.h>
+
+/** Initial capacity of a retire list. */
+#define PMT_RC_LIST_CAPACITY 64
+
+static void pmt_rc_list_init(pmt_rc_list_t *list, const size_t scan_at)
+{
+        list->retired = NULL;
+        list->length = 0;
+        list->capacity = 0;
+        list->scan_at = scan_at;
+}
+
+static bool pmt_rc_list_push(
+        pmt_rc_list_t *list,
+        pmt_da_alloc_t alloc,
+        pmt_da_realloc_t realloc,
+        void *alloc_state,
+        const pmt_rc_retired_t *record)
+{
+        if(list->length == list->capacity) {
+                const size_t new_cap = list->capacity ?
+                        list->capacity * 2 :
+                        PMT_RC_LIST_CAPACITY;
+
+                if(new_cap <= list->capacity ||
+                        SIZE_MAX / sizeof(pmt_rc_retired_t) < new_cap)
+                {
+                        return false;
+                }
+
+                const size_t nbytes = new_cap * sizeof(pmt_rc_retired_t);
+
+                pmt_rc_retired_t *retired = list->retired ?
+                        realloc(list->retired, nbytes, alloc_state) :
+                        alloc(nbytes, alloc_state);
+
+                if(!retired) {
+                        return false;
+                }
+
+                list->retired = retired;
+                list->capacity = new_cap;
+        }
+
+        list->retired[list->length++] = *record;
+
+        return true;
+}
+
+/** Free every node, then the list's buffer. */
+static void pmt_rc_list_release(
+        pmt_rc_list_t *list,
+        pmt_da_free_t free,
+        void *alloc_state)
+{
+        for(size_t x = 0; x < list->length; ++x) {
+                pmt_rc_retired_t *record = list->retired + x;
+                record->free(record->node, record->free_state);
+        }
+
+        if(list->retired) {
+                free(list->retired, alloc_state);
+        }
+
+        pmt_rc_list_init(list, 0);
+}
+
+pmt_ebr_domain_t *pmt_ebr_init(
+        pmt_ebr_domain_t *domain,
+        pmt_da_alloc_t alloc,
+        pmt_da_realloc_t realloc,
+        pmt_da_free_t free,
+        void *alloc_state)
+{
+        assert(domain && alloc && realloc && free);
+
+        atomic_init(&domain->epoch, 0);
+        atomic_init(&domain->threads, NULL);
+
+        domain->alloc = alloc;
+        domain->realloc = realloc;
+        domain->free = free;
+        domain->alloc_state = alloc_state;
+
+        return domain;
+}
+
+void pmt_ebr_destroy(pmt_ebr_domain_t *domain)
+{
+        assert(domain);
+
+        pmt_ebr_thread_t *thread = atomic_load_explicit(
+                &domain->threads,
+                memory_order_acquire);
+
+        while(thread) {
+                pmt_ebr_thread_t *next = thread->next;
+                pmt_rc_list_release(
+                        &thread->list,
+                        domain->free,
+                        domain->alloc_state);
+                domain->free(thread, domain->alloc_state);
+                thread = next;
+        }
+
+        atomic_store_explicit(&domain->threads, NULL, memory_order_relaxed);
+}
+
+pmt_ebr_thread_t *pmt_ebr_register(pmt_ebr_domain_t *domain)
+{
+        assert(domain);
+
+        pmt_ebr_thread_t *thread = atomic_load_explicit(
+                &domain->threads,
+                memory_order_acquire);
+
+        for(; thread; thread = thread->next) {
+                bool in_use = false;
+                if(!atomic_load_explicit(&thread->in_use, memory_order_relaxed) &&
+                        atomic_compare_exchange_strong_explicit(
+                                &thread->in_use,
+                                &in_use,
+                                true,
+                                memory_order_acquire,
+                                memory_order_relaxed))
+                {
+                        return thread;
+                }
+        }
+
+        thread = domain->alloc(sizeof(pmt_ebr_thread_t), domain->alloc_state);
+        if(!thread) {
+                return NULL;
+        }
+
+        atomic_init(&thread->local_epoch, 0);
+        atomic_init(&thread->in_use, true);
+        thread->domain = domain;
+        thread->nesting = 0;
+        pmt_rc_list_init(&thread->list, PMT_EBR_SCAN_INTERVAL);
+
+        thread->next = atomic_load_explicit(
+                &domain->threads,
+                memory_order_relaxed);
+
+        while(!atomic_compare_exchange_weak_explicit(
+                &domain->threads,
+                &thread->next,
+                thread,
+                memory_order_release,
+                memory_order_relaxed));
+
+        return thread;
+}
+
+void pmt_ebr_unregister(pmt_ebr_thread_t *thread)
+{
+        assert(thread && thread->nesting == 0);
+
+        (void)pmt_ebr_reclaim(thread);
+
+        atomic_store_explicit(&thread->in_use, false, memory_order_release);
+}
+
+void pmt_ebr_enter(pmt_ebr_thread_t *thread)
+{
+        assert(thread);
+
+        if(thread->nesting++) {
+                return;
+        }
+
+        const size_t epoch = atomic_load_explicit(
+                &thread->domain->epoch,
+                memory_order_relaxed);
+
+        atomic_store_explicit(
+                &thread->local_epoch,
+                (epoch << 1) | 1,
+                memory_order_relaxed);
+
+        /* The announcement must be visible before any shared node is read. */
+
+        atomic_thread_fence(memory_order_seq_cst);
+}
+
+void pmt_ebr_exit(pmt_ebr_thread_t *thread)
+{
+        assert(thread && thread->nesting > 0);
+
+        if(--thread->nesting) {
+                return;
+        }
+
+        atomic_store_explicit(&thread->local_epoch, 0, memory_order_release);
+}
+
+/** Advance the epoch if every thread in a critical section has seen it. */
+static void pmt_ebr_try_advance(pmt_ebr_domain_t *domain)
+{
+        atomic_thread_fence(memory_order_seq_cst);
+
+        size_t epoch = atomic_load_explicit(
+                &domain->epoch,
+                memory_order_relaxed);
+
+        pmt_ebr_thread_t *thread = atomic_load_explicit(
+                &domain->threads,
+                memory_order_acquire);
+
+        for(; thread; thread = thread->next) {
+                const size_t local = atomic_load_explicit(
+                        &thread->local_epoch,
+                        memory_order_acquire);
+                if((local & 1) && (local >> 1) != epoch) {
+                        return;
+                }
+        }
+
+        (void)atomic_compare_exchange_strong_explicit(
+                &domain->epoch,
+                &epoch,
+                epoch + 1,
+                memory_order_acq_rel,
+                memory_order_relaxed);
+}
+
+size_t pmt_ebr_reclaim(pmt_ebr_thread_t *thread)
+{
+        assert(thread);
+
+        pmt_ebr_domain_t *domain = thread->domain;
+        pmt_rc_list_t *list = &thread->list;
+
+        pmt_ebr_try_advance(domain);
+
+        const size_t epoch = atomic_load_explicit(
+                &domain->epoch,
+                memory_order_acquire);
+
+        size_t kept = 0;
+
+        for(size_t x = 0; x < list->length; ++x) {
+                pmt_rc_retired_t *record = list->retired + x;
+                if(record->epoch + 2 <= epoch) {
+                        record->free(record->node, record->free_state);
+                } else {
+                        list->retired[kept++] = *record;
+                }
+        }
+
+        const size_t nfreed = list->length - kept;
+
+        list->length = kept;
+        list->scan_at = kept + PMT_EBR_SCAN_INTERVAL;
+
+        return nfreed;
+}
+
+bool pmt_ebr_retire(
+        pmt_ebr_thread_t *thread,
+        void *node,
+        pmt_rc_free_t free,
+        void *free_state)
+{
+        assert(thread && node && free);
+
+        pmt_ebr_domain_t *domain = thread->domain;
+
+        /* The node's unlinking must be ordered before the epoch is read. */
+
+        atomic_thread_fence(memory_order_seq_cst);
+
+        const pmt_rc_retired_t record = {
+                .node = node,
+                .free = free,
+                .free_state = free_state,
+                .epoch = atomic_load_explicit(
+                        &domain->epoch,
+                        memory_order_relaxed)
+        };
+
+        if(thread->list.length >= thread->list.scan_at) {
+                (void)pmt_ebr_reclaim(thread);
+        }
+
+        return pmt_rc_list_push(
+                &thread->list,
+                domain->alloc,
+                domain->realloc,
+                domain->alloc_state,
+                &record);
+}
+
+pmt_hp_domain_t *pmt_hp_init(
+        pmt_hp_domain_t *domain,
+        pmt_da_alloc_t alloc,
+        pmt_da_realloc_t realloc,
+        pmt_da_free_t free,
+        void *alloc_state)
+{
+        assert(domain && alloc && realloc && free);
+
+        atomic_init(&domain->threads, NULL);
+        atomic_init(&domain->nthreads, 0);
+
+        domain->alloc = alloc;
+        domain->realloc = realloc;
+        domain->free = free;
+        domain->alloc_state = alloc_state;
+
+        return domain;
+}
+
+void pmt_hp_destroy(pmt_hp_domain_t *domain)
+{
+        assert(domain);
+
+        pmt_hp_thread_t *thread = atomic_load_explicit(
+                &domain->threads,
+                memory_order_acquire);
+
+        while(thread) {
+                pmt_hp_thread_t *next = thread->next;
+                pmt_rc_list_release(
+                        &thread->list,
+                        domain->free,
+                        domain->alloc_state);
+                if(thread->scratch) {
+                        domain->free(thread->scratch, domain->alloc_state);
+                }
+                domain->free(thread, domain->alloc_state);
+                thread = next;
+        }
+
+        atomic_store_explicit(&domain->threads, NULL, memory_order_relaxed);
+        atomic_store_explicit(&domain->nthreads, 0, memory_order_relaxed);
+}
+
+pmt_hp_thread_t *pmt_hp_register(pmt_hp_domain_t *domain)
+{
+        assert(domain);
+
+        pmt_hp_thread_t *thread = atomic_load_explicit(
+                &domain->threads,
+                memory_order_acquire);
+
+        for(; thread; thread = thread->next) {
+                bool in_use = false;
+                if(!atomic_load_explicit(&thread->in_use, memory_order_relaxed) &&
+                        atomic_compare_exchange_strong_explicit(
+                                &thread->in_use,
+                                &in_use,
+                                true,
+                                memory_order_acquire,
+                                memory_order_relaxed))
+                {
+                        return thread;
+                }
+        }
+
+        thread = domain->alloc(sizeof(pmt_hp_thread_t), domain->alloc_state);
+        if(!thread) {
+                return NULL;
+        }
+
+        for(size_t x = 0; x < PMT_HP_SLOTS; ++x) {
+                atomic_init(&thread->hazards[x], NULL);
+        }
+
+        atomic_init(&thread->in_use, true);
+        thread->domain = domain;
+        thread->scratch = NULL;
+        thread->scratch_capacity = 0;
+        pmt_rc_list_init(&thread->list, PMT_HP_SCAN_INTERVAL);
+
+        thread->next = atomic_load_explicit(
+                &domain->threads,
+                memory_order_relaxed);
+
+        while(!atomic_compare_exchange_weak_explicit(
+                &domain->threads,
+                &thread->next,
+                thread,
+                memory_order_release,
+                memory_order_relaxed));
+
+        (void)atomic_fetch_add_explicit(
+                &domain->nthreads,
+                1,
+                memory_order_relaxed);
+
+        return thread;
+}
+
+void pmt_hp_unregister(pmt_hp_thread_t *thread)
+{
+        assert(thread);
+
+        for(size_t x = 0; x < PMT_HP_SLOTS; ++x) {
+                pmt_hp_clear(thread, x);
+        }
+
+        (void)pmt_hp_reclaim(thread);
+
+        atomic_store_explicit(&thread->in_use, false, memory_order_release);
+}
+
+void *pmt_hp_protect(
+        pmt_hp_thread_t *thread,
+        const size_t slot,
+        _Atomic(void*) *source)
+{
+        assert(thread && slot < PMT_HP_SLOTS && source);
+
+        void *pointer = atomic_load_explicit(source, memory_order_relaxed);
+
+        for(;;) {
+                atomic_store_explicit(
+                        &thread->hazards[slot],
+                        pointer,
+                        memory_order_relaxed);
+
+                atomic_thread_fence(memory_order_seq_cst);
+
+                void *again = atomic_load_explicit(
+                        source,
+                        memory_order_acquire);
+
+                if(again == pointer) {
+                        return pointer;
+                }
+
+                pointer = again;
+        }
+}
+
+void *pmt_hp_protect_with(
+        pmt_hp_thread_t *thread,
+        const size_t slot,
+        void *(*get)(void *object),
+        void *object)
+{
+        assert(thread && slot < PMT_HP_SLOTS && get);
+
+        void *pointer = get(object);
+
+        for(;;) {
+                atomic_store_explicit(
+                        &thread->hazards[slot],
+                        pointer,
+                        memory_order_relaxed);
+
+                atomic_thread_fence(memory_order_seq_cst);
+
+                void *again = get(object);
+
+                atomic_thread_fence(memory_order_acquire);
+
+                if(again == pointer) {
+                        return pointer;
+                }
+
+                pointer = again;
+        }
+}
+
+void pmt_hp_set(pmt_hp_thread_t *thread, const size_t slot, void *pointer)
+{
+        assert(thread && slot < PMT_HP_SLOTS);
+
+        atomic_store_explicit(
+                &thread->hazards[slot],
+                pointer,
+                memory_order_relaxed);
+
+        atomic_thread_fence(memory_order_seq_cst);
+}
+
+void pmt_hp_clear(pmt_hp_thread_t *thread, const size_t slot)
+{
+        assert(thread && slot < PMT_HP_SLOTS);
+
+        atomic_store_explicit(
+                &thread->hazards[slot],
+                NULL,
+                memory_order_release);
+}
+
+static int pmt_hp_compare(const void *a, const void *b)
+{
+        const uintptr_t
+                x = (uintptr_t)*(void* const*)a,
+                y = (uintptr_t)*(void* const*)b;
+
+        return (x > y) - (x < y);
+}
+
+/** Gather every published hazard into the thread's scratch buffer. */
+static bool pmt_hp_gather(pmt_hp_thread_t *thread, size_t *nhazards)
+{
+        pmt_hp_domain_t *domain = thread->domain;
+
+        size_t count = 0;
+
+        pmt_hp_thread_t *other = atomic_load_explicit(
+                &domain->threads,
+                memory_order_acquire);
+
+        for(; other; other = other->next) {
+                for(size_t x = 0; x < PMT_HP_SLOTS; ++x) {
+                        void *hazard = atomic_load_explicit(
+                                &other->hazards[x],
+                                memory_order_acquire);
+                        if(!hazard) {
+                                continue;
+                        }
+                        if(count == thread->scratch_capacity) {
+                                const size_t new_cap = count ? count * 2 :
+                                        PMT_HP_SLOTS * 4;
+                                const size_t nbytes = new_cap * sizeof(void*);
+                                void **scratch = thread->scratch ?
+                                        domain->realloc(
+                                                thread->scratch,
+                                                nbytes,
+                                                domain->alloc_state) :
+                                        domain->alloc(
+                                                nbytes,
+                                                domain->alloc_state);
+                                if(!scratch) {
+                                        return false;
+                                }
+                                thread->scratch = scratch;
+                                thread->scratch_capacity = new_cap;
+                        }
+                        thread->scratch[count++] = hazard;
+                }
+        }
+
+        *nhazards = count;
+
+        return true;
+}
+
+size_t pmt_hp_reclaim(pmt_hp_thread_t *thread)
+{
+        assert(thread);
+
+        pmt_rc_list_t *list = &thread->list;
+
+        /* The nodes' unlinking must be ordered before the hazards are read. */
+
+        atomic_thread_fence(memory_order_seq_cst);
+
+        size_t nhazards = 0;
+
+        if(!pmt_hp_gather(thread, &nhazards)) {
+                return 0;
+        }
+
+        if(nhazards > 1) {
+                qsort(thread->scratch, nhazards, sizeof(void*), pmt_hp_compare);
+        }
+
+        size_t kept = 0;
+
+        for(size_t x = 0; x < list->length; ++x) {
+                pmt_rc_retired_t *record = list->retired + x;
+                if(nhazards && bsearch(
+                        &record->node,
+                        thread->scratch,
+                        nhazards,
+                        sizeof(void*),
+                        pmt_hp_compare))
+                {
+                        list->retired[kept++] = *record;
+                } else {
+                        record->free(record->node, record->free_state);
+                }
+        }
+
+        const size_t
+                nfreed = list->length - kept,
+                nslots = PMT_HP_SLOTS * atomic_load_explicit(
+                        &thread->domain->nthreads,
+                        memory_order_relaxed);
+
+        list->length = kept;
+        list->scan_at = kept + nslots + PMT_HP_SCAN_INTERVAL;
+
+        return nfreed;
+}
+
+bool pmt_hp_retire(
+        pmt_hp_thread_t *thread,
+        void *node,
+        pmt_rc_free_t free,
+        void *free_state)
+{
+        assert(thread && node && free);
+
+        pmt_hp_domain_t *domain = thread->domain;
+
+        const pmt_rc_retired_t record = {
+                .node = node,
+                .free = free,
+                .free_state = free_state,
+                .epoch = 0
+        };
+
+        if(thread->list.length >= thread->list.scan_at) {
+                (void)pmt_hp_reclaim(thread);
+        }
+
+        return pmt_rc_list_push(
+                &thread->list,
+                domain->alloc,
+                domain->realloc,
+                domain->alloc_state,
+                &record);
+}
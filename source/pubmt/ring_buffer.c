@@ -0,0 +1,329 @@
+#include "pubmt/ring_buffer.h"
+#include <string.h>
+#include <stdint.h>
+#include <assert.h>
+
+bool pmt_rb_iface_validate(pmt_rb_iface_t *iface)
+{
+        return
+                iface &&
+                iface->get_head &&
+                iface->set_head &&
+                pmt_da_iface_validate(&iface->array_iface);
+}
+
+static bool pmt_rb_is_pow2(const size_t n)
+{
+        return n && !(n & (n - 1));
+}
+
+static bool pmt_rb_round_pow2(const size_t n, size_t *result)
+{
+        size_t cap = 1;
+
+        while(cap < n) {
+                const size_t next = cap * 2;
+                if(next <= cap) {
+                        return false;
+                }
+                cap = next;
+        }
+
+        *result = cap;
+
+        return true;
+}
+
+void *pmt_rb_create(
+        pmt_rb_iface_t *iface,
+        void *ring,
+        const size_t init_cap)
+{
+        assert(ring && pmt_rb_iface_validate(iface));
+
+        pmt_da_iface_t *a_iface = &iface->array_iface;
+
+        /* the inline region becomes the capacity whenever requests fit it */
+
+        if(pmt_da_has_inline(a_iface, ring) &&
+                !pmt_rb_is_pow2(a_iface->get_inline_capacity(ring)))
+        {
+                return NULL;
+        }
+
+        size_t cap = 0;
+
+        if(!pmt_rb_round_pow2(init_cap, &cap)) {
+                return NULL;
+        }
+
+        if(!pmt_da_create(a_iface, ring, cap)) {
+                return NULL;
+        }
+
+        assert(pmt_rb_is_pow2(a_iface->get_capacity(ring)));
+
+        iface->set_head(ring, 0);
+
+        return ring;
+}
+
+void pmt_rb_destroy(pmt_rb_iface_t *iface, void *ring)
+{
+        assert(ring && pmt_rb_iface_validate(iface));
+
+        pmt_da_destroy(&iface->array_iface, ring);
+}
+
+void pmt_rb_clear(pmt_rb_iface_t *iface, void *ring)
+{
+        assert(ring && pmt_rb_iface_validate(iface));
+
+        iface->array_iface.set_size(ring, 0);
+        iface->set_head(ring, 0);
+}
+
+size_t pmt_rb_size(pmt_rb_iface_t *iface, void *ring)
+{
+        assert(ring && pmt_rb_iface_validate(iface));
+
+        return iface->array_iface.get_size(ring);
+}
+
+bool pmt_rb_is_empty(pmt_rb_iface_t *iface, void *ring)
+{
+        assert(ring && pmt_rb_iface_validate(iface));
+
+        return iface->array_iface.get_size(ring) == 0;
+}
+
+static uint8_t *pmt_rb_slot(
+        pmt_rb_iface_t *iface,
+        void *ring,
+        const size_t pos)
+{
+        pmt_da_iface_t *a_iface = &iface->array_iface;
+
+        const size_t mask = a_iface->get_capacity(ring) - 1;
+
+        return (uint8_t*)a_iface->get_buffer(ring) +
+                (pos & mask) * a_iface->get_element_size(ring);
+}
+
+void *pmt_rb_at(pmt_rb_iface_t *iface, void *ring, const size_t index)
+{
+        assert(ring && pmt_rb_iface_validate(iface));
+
+        if(index >= iface->array_iface.get_size(ring)) {
+                return NULL;
+        }
+
+        return pmt_rb_slot(iface, ring, iface->get_head(ring) + index);
+}
+
+bool pmt_rb_reserve(pmt_rb_iface_t *iface, void *ring, const size_t nelems)
+{
+        assert(ring && pmt_rb_iface_validate(iface));
+
+        pmt_da_iface_t *a_iface = &iface->array_iface;
+
+        const size_t
+                size = a_iface->get_size(ring),
+                capacity = a_iface->get_capacity(ring),
+                head = iface->get_head(ring),
+                want_cap = size + nelems;
+
+        if(want_cap < size) {
+                return false;
+        } else if(want_cap <= capacity) {
+                return true;
+        }
+
+        size_t new_cap = 0;
+
+        if(!pmt_rb_round_pow2(want_cap, &new_cap)) {
+                return false;
+        }
+
+        if(!pmt_da_resize(a_iface, ring, new_cap)) {
+                return false;
+        }
+
+        assert(pmt_rb_is_pow2(a_iface->get_capacity(ring)));
+
+        /* The elements that wrapped around to the start of the old buffer
+           are moved to follow the rest, since the new capacity is at least
+           twice the old one they always fit. */
+
+        if(head + size > capacity) {
+                const size_t elem_size = a_iface->get_element_size(ring);
+                uint8_t *buf = a_iface->get_buffer(ring);
+                (void)memcpy(
+                        buf + capacity * elem_size,
+                        buf,
+                        (head + size - capacity) * elem_size);
+        }
+
+        return true;
+}
+
+void *pmt_rb_push_back(pmt_rb_iface_t *iface, void *ring, void *elem)
+{
+        assert(ring && pmt_rb_iface_validate(iface));
+
+        pmt_da_iface_t *a_iface = &iface->array_iface;
+
+        const size_t size = a_iface->get_size(ring);
+
+        if(size == a_iface->get_capacity(ring)) {
+                if(!pmt_rb_reserve(iface, ring, 1)) {
+                        return NULL;
+                }
+        }
+
+        uint8_t *pointer = pmt_rb_slot(iface, ring, iface->get_head(ring) + size);
+
+        a_iface->set_size(ring, size + 1);
+
+        if(elem) {
+                (void)memcpy(pointer, elem, a_iface->get_element_size(ring));
+        }
+
+        return pointer;
+}
+
+void *pmt_rb_push_front(pmt_rb_iface_t *iface, void *ring, void *elem)
+{
+        assert(ring && pmt_rb_iface_validate(iface));
+
+        pmt_da_iface_t *a_iface = &iface->array_iface;
+
+        const size_t size = a_iface->get_size(ring);
+
+        if(size == a_iface->get_capacity(ring)) {
+                if(!pmt_rb_reserve(iface, ring, 1)) {
+                        return NULL;
+                }
+        }
+
+        const size_t
+                mask = a_iface->get_capacity(ring) - 1,
+                head = (iface->get_head(ring) - 1) & mask;
+
+        uint8_t *pointer = pmt_rb_slot(iface, ring, head);
+
+        iface->set_head(ring, head);
+        a_iface->set_size(ring, size + 1);
+
+        if(elem) {
+                (void)memcpy(pointer, elem, a_iface->get_element_size(ring));
+        }
+
+        return pointer;
+}
+
+bool pmt_rb_pop_back(pmt_rb_iface_t *iface, void *ring, void *elem)
+{
+        assert(ring && pmt_rb_iface_validate(iface));
+
+        pmt_da_iface_t *a_iface = &iface->array_iface;
+
+        const size_t size = a_iface->get_size(ring);
+
+        if(!size) {
+                return false;
+        }
+
+        if(elem) {
+                (void)memcpy(
+                        elem,
+                        pmt_rb_slot(iface, ring, iface->get_head(ring) + size - 1),
+                        a_iface->get_element_size(ring));
+        }
+
+        a_iface->set_size(ring, size - 1);
+
+        return true;
+}
+
+bool pmt_rb_pop_front(pmt_rb_iface_t *iface, void *ring, void *elem)
+{
+        assert(ring && pmt_rb_iface_validate(iface));
+
+        pmt_da_iface_t *a_iface = &iface->array_iface;
+
+        const size_t size = a_iface->get_size(ring);
+
+        if(!size) {
+                return false;
+        }
+
+        const size_t head = iface->get_head(ring);
+
+        if(elem) {
+                (void)memcpy(
+                        elem,
+                        pmt_rb_slot(iface, ring, head),
+                        a_iface->get_element_size(ring));
+        }
+
+        iface->set_head(ring, (head + 1) & (a_iface->get_capacity(ring) - 1));
+        a_iface->set_size(ring, size - 1);
+
+        return true;
+}
+
+bool pmt_rb_drop_front(pmt_rb_iface_t *iface, void *ring, const size_t nelems)
+{
+        assert(ring && pmt_rb_iface_validate(iface));
+
+        pmt_da_iface_t *a_iface = &iface->array_iface;
+
+        const size_t size = a_iface->get_size(ring);
+
+        if(nelems > size) {
+                return false;
+        }
+
+        const size_t mask = a_iface->get_capacity(ring) - 1;
+
+        iface->set_head(ring, (iface->get_head(ring) + nelems) & mask);
+        a_iface->set_size(ring, size - nelems);
+
+        return true;
+}
+
+size_t pmt_rb_peek_spans(
+        pmt_rb_iface_t *iface,
+        void *ring,
+        pmt_rb_span_t spans[2])
+{
+        assert(ring && spans && pmt_rb_iface_validate(iface));
+
+        pmt_da_iface_t *a_iface = &iface->array_iface;
+
+        const size_t
+                size = a_iface->get_size(ring),
+                capacity = a_iface->get_capacity(ring),
+                head = iface->get_head(ring),
+                elem_size = a_iface->get_element_size(ring);
+
+        if(!size) {
+                return 0;
+        }
+
+        uint8_t *buf = a_iface->get_buffer(ring);
+
+        spans[0].base = buf + head * elem_size;
+
+        if(head + size <= capacity) {
+                spans[0].length = size * elem_size;
+                return 1;
+        }
+
+        spans[0].length = (capacity - head) * elem_size;
+        spans[1].base = buf;
+        spans[1].length = (head + size - capacity) * elem_size;
+
+        return 2;
+}
@@ -0,0 +1,395 @@
+#include "pubmt/segmented_deque.h"
+#include <string.h>
+#include <stdint.h>
+#include <assert.h>
+
+bool pmt_sd_iface_validate(pmt_sd_iface_t *iface)
+{
+        return
+                iface &&
+                iface->get_element_size &&
+                iface->get_block_length &&
+                iface->get_offset &&
+                iface->set_offset &&
+                iface->get_length &&
+                iface->set_length &&
+                pmt_da_iface_validate(&iface->array_iface);
+}
+
+void *pmt_sd_create(
+        pmt_sd_iface_t *iface,
+        void *deque,
+        const size_t initial_blocks)
+{
+        assert(deque && pmt_sd_iface_validate(iface));
+
+        pmt_da_iface_t *a_iface = &iface->array_iface;
+
+        assert(a_iface->get_element_size(deque) == sizeof(void*));
+        assert(iface->get_block_length(deque) > 0);
+
+        const size_t init_cap = initial_blocks ? initial_blocks : 1;
+
+        if(!pmt_da_create(a_iface, deque, init_cap)) {
+                return NULL;
+        }
+
+        const size_t capacity = a_iface->get_capacity(deque);
+
+        (void)pmt_da_zero_buffer(a_iface, deque, 0, capacity);
+
+        iface->set_length(deque, 0);
+        iface->set_offset(
+                deque,
+                (capacity / 2) * iface->get_block_length(deque));
+
+        return deque;
+}
+
+static void *pmt_sd_alloc_block(
+        pmt_sd_iface_t *iface,
+        void *deque,
+        void **slot)
+{
+        if(*slot) {
+                return *slot;
+        }
+
+        pmt_da_iface_t *a_iface = &iface->array_iface;
+
+        const size_t nbytes =
+                iface->get_element_size(deque) *
+                iface->get_block_length(deque);
+
+        *slot = a_iface->get_alloc(deque)(
+                nbytes,
+                a_iface->get_alloc_state(deque));
+
+        if(!*slot) {
+                return NULL;
+        }
+
+        a_iface->set_size(deque, a_iface->get_size(deque) + 1);
+
+        return *slot;
+}
+
+static void pmt_sd_free_block(
+        pmt_sd_iface_t *iface,
+        void *deque,
+        void **slot)
+{
+        if(!*slot) {
+                return;
+        }
+
+        pmt_da_iface_t *a_iface = &iface->array_iface;
+
+        a_iface->get_free(deque)(*slot, a_iface->get_alloc_state(deque));
+        a_iface->set_size(deque, a_iface->get_size(deque) - 1);
+
+        *slot = NULL;
+}
+
+static void pmt_sd_free_blocks(pmt_sd_iface_t *iface, void *deque)
+{
+        pmt_da_iface_t *a_iface = &iface->array_iface;
+
+        void **dir = a_iface->get_buffer(deque);
+        const size_t capacity = a_iface->get_capacity(deque);
+
+        for(size_t x = 0; x < capacity; ++x) {
+                pmt_sd_free_block(iface, deque, dir + x);
+        }
+
+        assert(a_iface->get_size(deque) == 0);
+}
+
+/*
+ * Center the allocated blocks within the directory, doubling its capacity
+ * when less than half of it is free, so there is a free slot at both ends.
+ * Only block pointers are moved.
+ */
+static bool pmt_sd_make_room(pmt_sd_iface_t *iface, void *deque)
+{
+        pmt_da_iface_t *a_iface = &iface->array_iface;
+
+        const size_t
+                block_len = iface->get_block_length(deque),
+                offset = iface->get_offset(deque),
+                length = iface->get_length(deque),
+                capacity = a_iface->get_capacity(deque),
+                first = offset / block_len,
+                last = (length ? offset + length - 1 : offset) / block_len;
+
+        void **dir = a_iface->get_buffer(deque);
+
+        size_t
+                lo = first < capacity ? first : capacity,
+                hi = last < capacity ? last + 1 : capacity;
+
+        /* keep the spare blocks at either end */
+
+        if(lo > 0 && dir[lo - 1]) {
+                --lo;
+        }
+        if(hi < capacity && dir[hi]) {
+                ++hi;
+        }
+
+        const size_t used = hi - lo;
+
+        size_t new_cap = capacity;
+
+        while((used + 1) * 2 > new_cap) {
+                const size_t next_cap = new_cap * 2;
+                if(next_cap <= new_cap) {
+                        return false;
+                }
+                new_cap = next_cap;
+        }
+
+        if(new_cap != capacity && !pmt_da_resize(a_iface, deque, new_cap)) {
+                return false;
+        }
+
+        new_cap = a_iface->get_capacity(deque);
+        dir = a_iface->get_buffer(deque);
+
+        const size_t new_lo = (new_cap - used) / 2;
+
+        (void)memmove(dir + new_lo, dir + lo, used * sizeof(void*));
+
+        (void)memset(dir, 0, new_lo * sizeof(void*));
+        (void)memset(
+                dir + new_lo + used,
+                0,
+                (new_cap - new_lo - used) * sizeof(void*));
+
+        iface->set_offset(deque, offset - lo * block_len + new_lo * block_len);
+
+        return true;
+}
+
+void pmt_sd_destroy(pmt_sd_iface_t *iface, void *deque)
+{
+        assert(deque && pmt_sd_iface_validate(iface));
+
+        pmt_sd_free_blocks(iface, deque);
+
+        pmt_da_destroy(&iface->array_iface, deque);
+}
+
+void pmt_sd_clear(pmt_sd_iface_t *iface, void *deque)
+{
+        assert(deque && pmt_sd_iface_validate(iface));
+
+        pmt_sd_free_blocks(iface, deque);
+
+        const size_t capacity = iface->array_iface.get_capacity(deque);
+
+        iface->set_length(deque, 0);
+        iface->set_offset(
+                deque,
+                (capacity / 2) * iface->get_block_length(deque));
+}
+
+size_t pmt_sd_size(pmt_sd_iface_t *iface, void *deque)
+{
+        assert(deque && pmt_sd_iface_validate(iface));
+
+        return iface->get_length(deque);
+}
+
+bool pmt_sd_is_empty(pmt_sd_iface_t *iface, void *deque)
+{
+        assert(deque && pmt_sd_iface_validate(iface));
+
+        return iface->get_length(deque) == 0;
+}
+
+void *pmt_sd_at(pmt_sd_iface_t *iface, void *deque, const size_t index)
+{
+        assert(deque && pmt_sd_iface_validate(iface));
+
+        if(index >= iface->get_length(deque)) {
+                return NULL;
+        }
+
+        const size_t
+                block_len = iface->get_block_length(deque),
+                pos = iface->get_offset(deque) + index;
+
+        void **dir = iface->array_iface.get_buffer(deque);
+
+        return (uint8_t*)dir[pos / block_len] +
+                (pos % block_len) * iface->get_element_size(deque);
+}
+
+void *pmt_sd_first(pmt_sd_iface_t *iface, void *deque)
+{
+        return pmt_sd_at(iface, deque, 0);
+}
+
+void *pmt_sd_last(pmt_sd_iface_t *iface, void *deque)
+{
+        assert(deque && pmt_sd_iface_validate(iface));
+
+        const size_t length = iface->get_length(deque);
+
+        if(!length) {
+                return NULL;
+        }
+
+        return pmt_sd_at(iface, deque, length - 1);
+}
+
+void *pmt_sd_push_back(pmt_sd_iface_t *iface, void *deque, void *elem)
+{
+        assert(deque && pmt_sd_iface_validate(iface));
+
+        pmt_da_iface_t *a_iface = &iface->array_iface;
+
+        const size_t
+                block_len = iface->get_block_length(deque),
+                elem_size = iface->get_element_size(deque),
+                length = iface->get_length(deque);
+
+        if((iface->get_offset(deque) + length) / block_len >=
+                a_iface->get_capacity(deque))
+        {
+                if(!pmt_sd_make_room(iface, deque)) {
+                        return NULL;
+                }
+        }
+
+        const size_t pos = iface->get_offset(deque) + length;
+
+        void **dir = a_iface->get_buffer(deque);
+
+        uint8_t *block = pmt_sd_alloc_block(iface, deque, dir + pos / block_len);
+        if(!block) {
+                return NULL;
+        }
+
+        uint8_t *pointer = block + (pos % block_len) * elem_size;
+
+        iface->set_length(deque, length + 1);
+
+        if(elem) {
+                (void)memcpy(pointer, elem, elem_size);
+        }
+
+        return pointer;
+}
+
+void *pmt_sd_push_front(pmt_sd_iface_t *iface, void *deque, void *elem)
+{
+        assert(deque && pmt_sd_iface_validate(iface));
+
+        const size_t
+                block_len = iface->get_block_length(deque),
+                elem_size = iface->get_element_size(deque),
+                length = iface->get_length(deque);
+
+        if(iface->get_offset(deque) == 0) {
+                if(!pmt_sd_make_room(iface, deque)) {
+                        return NULL;
+                }
+        }
+
+        const size_t pos = iface->get_offset(deque) - 1;
+
+        void **dir = iface->array_iface.get_buffer(deque);
+
+        uint8_t *block = pmt_sd_alloc_block(iface, deque, dir + pos / block_len);
+        if(!block) {
+                return NULL;
+        }
+
+        uint8_t *pointer = block + (pos % block_len) * elem_size;
+
+        iface->set_offset(deque, pos);
+        iface->set_length(deque, length + 1);
+
+        if(elem) {
+                (void)memcpy(pointer, elem, elem_size);
+        }
+
+        return pointer;
+}
+
+bool pmt_sd_pop_back(pmt_sd_iface_t *iface, void *deque, void *elem)
+{
+        assert(deque && pmt_sd_iface_validate(iface));
+
+        const size_t length = iface->get_length(deque);
+
+        if(!length) {
+                return false;
+        }
+
+        const size_t
+                block_len = iface->get_block_length(deque),
+                pos = iface->get_offset(deque) + length - 1,
+                slot = pos / block_len;
+
+        void **dir = iface->array_iface.get_buffer(deque);
+
+        if(elem) {
+                const size_t elem_size = iface->get_element_size(deque);
+                (void)memcpy(
+                        elem,
+                        (uint8_t*)dir[slot] + (pos % block_len) * elem_size,
+                        elem_size);
+        }
+
+        iface->set_length(deque, length - 1);
+
+        /* The emptied block is kept as a spare, free the one beyond it. */
+
+        if(pos % block_len == 0 &&
+                slot + 1 < iface->array_iface.get_capacity(deque))
+        {
+                pmt_sd_free_block(iface, deque, dir + slot + 1);
+        }
+
+        return true;
+}
+
+bool pmt_sd_pop_front(pmt_sd_iface_t *iface, void *deque, void *elem)
+{
+        assert(deque && pmt_sd_iface_validate(iface));
+
+        const size_t length = iface->get_length(deque);
+
+        if(!length) {
+                return false;
+        }
+
+        const size_t
+                block_len = iface->get_block_length(deque),
+                pos = iface->get_offset(deque),
+                slot = pos / block_len;
+
+        void **dir = iface->array_iface.get_buffer(deque);
+
+        if(elem) {
+                const size_t elem_size = iface->get_element_size(deque);
+                (void)memcpy(
+                        elem,
+                        (uint8_t*)dir[slot] + (pos % block_len) * elem_size,
+                        elem_size);
+        }
+
+        iface->set_offset(deque, pos + 1);
+        iface->set_length(deque, length - 1);
+
+        /* The emptied block is kept as a spare, free the one before it. */
+
+        if((pos + 1) % block_len == 0 && slot > 0) {
+                pmt_sd_free_block(iface, deque, dir + slot - 1);
+        }
+
+        return true;
+}
@@ -0,0 +1,533 @@
+#include "pubmt/sort.h"
+#include <string.h>
+#include <assert.h>
+
+/** Partitions of at most this many elements are finished by insertion. */
+#define PMT_DA_SORT_INSERTION 16
+
+/** Elements of at most this many bytes are moved through the stack. */
+#define PMT_DA_SORT_TEMPORARY 256
+
+static void pmt_da_swap(uint8_t *a, uint8_t *b, size_t elem_size)
+{
+        if(a == b) {
+                return;
+        } else if(elem_size == sizeof(uint64_t)) {
+                uint64_t tmp;
+                (void)memcpy(&tmp, a, sizeof(tmp));
+                (void)memcpy(a, b, sizeof(tmp));
+                (void)memcpy(b, &tmp, sizeof(tmp));
+                return;
+        } else if(elem_size == sizeof(uint32_t)) {
+                uint32_t tmp;
+                (void)memcpy(&tmp, a, sizeof(tmp));
+                (void)memcpy(a, b, sizeof(tmp));
+                (void)memcpy(b, &tmp, sizeof(tmp));
+                return;
+        }
+
+        uint8_t tmp[64];
+
+        while(elem_size > 0) {
+                const size_t n = elem_size < sizeof(tmp) ? 
+                        elem_size : sizeof(tmp);
+                (void)memcpy(tmp, a, n);
+                (void)memcpy(a, b, n);
+                (void)memcpy(b, tmp, n);
+                a += n;
+                b += n;
+                elem_size -= n;
+        }
+}
+
+static void pmt_da_insertion_sort(
+        uint8_t *base,
+        const size_t n,
+        const size_t elem_size,
+        pmt_da_less_than_t lt)
+{
+        uint8_t tmp[PMT_DA_SORT_TEMPORARY];
+
+        for(size_t i = 1; i < n; ++i) {
+
+                uint8_t *elem = base + i * elem_size;
+
+                if(!lt(elem, elem - elem_size)) {
+                        continue;
+                }
+
+                if(elem_size > sizeof(tmp)) {
+                        for(size_t j = i; j > 0; --j) {
+                                uint8_t *a = base + j * elem_size;
+                                if(!lt(a, a - elem_size)) {
+                                        break;
+                                }
+                                pmt_da_swap(a, a - elem_size, elem_size);
+                        }
+                        continue;
+                }
+
+                /* Lift the element out and shift its predecessors over with
+                   a single move. */
+
+                (void)memcpy(tmp, elem, elem_size);
+
+                size_t j = i - 1;
+                while(j > 0 && lt(tmp, base + (j - 1) * elem_size)) {
+                        --j;
+                }
+
+                (void)memmove(
+                        base + (j + 1) * elem_size, 
+                        base + j * elem_size, 
+                        (i - j) * elem_size);
+                (void)memcpy(base + j * elem_size, tmp, elem_size);
+        }
+}
+
+static void pmt_da_sift_down(
+        uint8_t *base,
+        size_t root,
+        const size_t n,
+        const size_t elem_size,
+        pmt_da_less_than_t lt)
+{
+        for(;;) {
+                size_t child = 2 * root + 1;
+                if(child >= n) {
+                        return;
+                }
+                uint8_t *child_ptr = base + child * elem_size;
+                if(child + 1 < n && lt(child_ptr, child_ptr + elem_size)) {
+                        child_ptr += elem_size;
+                        ++child;
+                }
+                uint8_t *root_ptr = base + root * elem_size;
+                if(!lt(root_ptr, child_ptr)) {
+                        return;
+                }
+                pmt_da_swap(root_ptr, child_ptr, elem_size);
+                root = child;
+        }
+}
+
+static void pmt_da_heap_sort(
+        uint8_t *base,
+        const size_t n,
+        const size_t elem_size,
+        pmt_da_less_than_t lt)
+{
+        for(size_t i = n / 2; i > 0; --i) {
+                pmt_da_sift_down(base, i - 1, n, elem_size, lt);
+        }
+
+        for(size_t end = n - 1; end > 0; --end) {
+                pmt_da_swap(base, base + end * elem_size, elem_size);
+                pmt_da_sift_down(base, 0, end, elem_size, lt);
+        }
+}
+
+static uint8_t *pmt_da_median(
+        uint8_t *a,
+        uint8_t *b,
+        uint8_t *c,
+        pmt_da_less_than_t lt)
+{
+        if(lt(a, b)) {
+                if(lt(b, c)) {
+                        return b;
+                } 
+                return lt(a, c) ? c : a;
+        } else if(lt(a, c)) {
+                return a;
+        } 
+        
+        return lt(b, c) ? c : b;
+}
+
+static void pmt_da_introsort(
+        uint8_t *base,
+        size_t n,
+        const size_t elem_size,
+        pmt_da_less_than_t lt,
+        size_t depth)
+{
+        while(n > PMT_DA_SORT_INSERTION) {
+
+                if(depth == 0) {
+                        pmt_da_heap_sort(base, n, elem_size, lt);
+                        return;
+                }
+
+                --depth;
+
+                uint8_t *pivot = pmt_da_median(
+                        base + elem_size,
+                        base + (n / 2) * elem_size,
+                        base + (n - 1) * elem_size,
+                        lt);
+
+                pmt_da_swap(base, pivot, elem_size);
+
+                /* Both scans stop on elements equal to the pivot, which 
+                   keeps partitions balanced when there are many duplicates. */
+
+                size_t i = 0, j = n;
+
+                for(;;) {
+                        do {
+                                ++i;
+                        } while(i < n && lt(base + i * elem_size, base));
+
+                        do {
+                                --j;
+                        } while(lt(base, base + j * elem_size));
+
+                        if(i >= j) {
+                                break;
+                        }
+
+                        pmt_da_swap(
+                                base + i * elem_size, 
+                                base + j * elem_size, 
+                                elem_size);
+                }
+
+                pmt_da_swap(base, base + j * elem_size, elem_size);
+
+                /* Recurse into the smaller side and loop on the larger one,
+                   bounding the stack depth to O(log n). */
+
+                const size_t left = j, right = n - j - 1;
+
+                if(left < right) {
+                        pmt_da_introsort(base, left, elem_size, lt, depth);
+                        base += (j + 1) * elem_size;
+                        n = right;
+                } else {
+                        pmt_da_introsort(
+                                base + (j + 1) * elem_size, 
+                                right, 
+                                elem_size, 
+                                lt, 
+                                depth);
+                        n = left;
+                }
+        }
+
+        pmt_da_insertion_sort(base, n, elem_size, lt);
+}
+
+void pmt_da_sort(
+        pmt_da_iface_t *iface, 
+        void *array, 
+        pmt_da_less_than_t less_than)
+{
+        assert(array && less_than && pmt_da_iface_validate(iface));
+
+        const size_t size = iface->get_size(array);
+
+        size_t depth = 0;
+
+        for(size_t n = size; n > 1; n /= 2) {
+                depth += 2;
+        }
+
+        pmt_da_introsort(
+                iface->get_buffer(array),
+                size,
+                iface->get_element_size(array),
+                less_than,
+                depth);
+}
+
+static void pmt_da_merge(
+        uint8_t *a,
+        size_t na,
+        uint8_t *b,
+        size_t nb,
+        uint8_t *out,
+        const size_t elem_size,
+        pmt_da_less_than_t lt)
+{
+        while(na && nb) {
+                if(lt(b, a)) {
+                        (void)memcpy(out, b, elem_size);
+                        b += elem_size;
+                        --nb;
+                } else {
+                        (void)memcpy(out, a, elem_size);
+                        a += elem_size;
+                        --na;
+                }
+                out += elem_size;
+        }
+
+        (void)memcpy(out, a, na * elem_size);
+        (void)memcpy(out + na * elem_size, b, nb * elem_size);
+}
+
+bool pmt_da_stable_sort(
+        pmt_da_iface_t *iface, 
+        void *array, 
+        pmt_da_less_than_t less_than)
+{
+        assert(array && less_than && pmt_da_iface_validate(iface));
+
+        const size_t 
+                size = iface->get_size(array),
+                elem_size = iface->get_element_size(array);
+
+        uint8_t *buf = iface->get_buffer(array);
+
+        if(size <= PMT_DA_SORT_INSERTION) {
+                pmt_da_insertion_sort(buf, size, elem_size, less_than);
+                return true;
+        }
+
+        void *alloc_state = iface->get_alloc_state(array);
+
+        uint8_t *tmp = iface->get_alloc(array)(size * elem_size, alloc_state);
+        if(!tmp) {
+                return false;
+        }
+
+        for(size_t lo = 0; lo < size; lo += PMT_DA_SORT_INSERTION) {
+                const size_t n = size - lo < PMT_DA_SORT_INSERTION ? 
+                        size - lo : PMT_DA_SORT_INSERTION;
+                pmt_da_insertion_sort(
+                        buf + lo * elem_size, 
+                        n, 
+                        elem_size, 
+                        less_than);
+        }
+
+        uint8_t *src = buf, *dst = tmp;
+
+        for(size_t width = PMT_DA_SORT_INSERTION; width < size; width *= 2) {
+
+                for(size_t lo = 0; lo < size; lo += 2 * width) {
+
+                        const size_t 
+                                mid = size - lo < width ? size : lo + width,
+                                hi = size - mid < width ? size : mid + width;
+
+                        pmt_da_merge(
+                                src + lo * elem_size,
+                                mid - lo,
+                                src + mid * elem_size,
+                                hi - mid,
+                                dst + lo * elem_size,
+                                elem_size,
+                                less_than);
+                }
+
+                uint8_t *swap = src;
+                src = dst;
+                dst = swap;
+        }
+
+        if(src != buf) {
+                (void)memcpy(buf, src, size * elem_size);
+        }
+
+        iface->get_free(array)(tmp, alloc_state);
+
+        return true;
+}
+
+bool pmt_da_radix_sort(
+        pmt_da_iface_t *iface, 
+        void *array, 
+        pmt_da_radix_key_t key)
+{
+        assert(array && key && pmt_da_iface_validate(iface));
+
+        const size_t 
+                size = iface->get_size(array),
+                elem_size = iface->get_element_size(array),
+                stride = elem_size + 2 * sizeof(uint64_t);
+
+        if(size < 2) {
+                return true;
+        } else if(size > SIZE_MAX / stride) {
+                return false;
+        }
+
+        void *alloc_state = iface->get_alloc_state(array);
+
+        uint64_t *keys = iface->get_alloc(array)(size * stride, alloc_state);
+        if(!keys) {
+                return false;
+        }
+
+        uint8_t *buf = iface->get_buffer(array);
+
+        /* Extract every key once and count all eight digits in one pass. */
+
+        const unsigned int ndigits = sizeof(uint64_t);
+
+        size_t counts[sizeof(uint64_t)][256];
+        (void)memset(counts, 0, sizeof(counts));
+
+        for(size_t i = 0; i < size; ++i) {
+                const uint64_t k = key(buf + i * elem_size);
+                keys[i] = k;
+                for(unsigned int d = 0; d < ndigits; ++d) {
+                        ++counts[d][(k >> (d * 8)) & 0xff];
+                }
+        }
+
+        uint64_t
+                *key_src = keys,
+                *key_dst = keys + size;
+
+        uint8_t
+                *src = buf,
+                *dst = (uint8_t*)(keys + 2 * size);
+
+        for(unsigned int d = 0; d < ndigits; ++d) {
+
+                const unsigned int shift = d * 8;
+                size_t *count = counts[d];
+
+                if(count[(key_src[0] >> shift) & 0xff] == size) {
+                        continue;
+                }
+
+                size_t sum = 0;
+                for(unsigned int x = 0; x < 256; ++x) {
+                        const size_t n = count[x];
+                        count[x] = sum;
+                        sum += n;
+                }
+
+                /* Constant sized copies are inlined by the compiler. */
+
+                if(elem_size == sizeof(uint32_t)) {
+                        for(size_t i = 0; i < size; ++i) {
+                                const uint64_t k = key_src[i];
+                                const size_t pos = count[(k >> shift) & 0xff]++;
+                                key_dst[pos] = k;
+                                (void)memcpy(
+                                        dst + pos * sizeof(uint32_t), 
+                                        src + i * sizeof(uint32_t), 
+                                        sizeof(uint32_t));
+                        }
+                } else if(elem_size == sizeof(uint64_t)) {
+                        for(size_t i = 0; i < size; ++i) {
+                                const uint64_t k = key_src[i];
+                                const size_t pos = count[(k >> shift) & 0xff]++;
+                                key_dst[pos] = k;
+                                (void)memcpy(
+                                        dst + pos * sizeof(uint64_t), 
+                                        src + i * sizeof(uint64_t), 
+                                        sizeof(uint64_t));
+                        }
+                } else {
+                        for(size_t i = 0; i < size; ++i) {
+                                const uint64_t k = key_src[i];
+                                const size_t pos = count[(k >> shift) & 0xff]++;
+                                key_dst[pos] = k;
+                                (void)memcpy(
+                                        dst + pos * elem_size, 
+                                        src + i * elem_size, 
+                                        elem_size);
+                        }
+                }
+
+                uint8_t *swap = src;
+                src = dst;
+                dst = swap;
+
+                uint64_t *key_swap = key_src;
+                key_src = key_dst;
+                key_dst = key_swap;
+        }
+
+        if(src != buf) {
+                (void)memcpy(buf, src, size * elem_size);
+        }
+
+        iface->get_free(array)(keys, alloc_state);
+
+        return true;
+}
+
+uint64_t pmt_da_radix_i64(const int64_t value)
+{
+        return (uint64_t)value ^ ((uint64_t)1 << 63);
+}
+
+uint64_t pmt_da_radix_f64(const double value)
+{
+        uint64_t bits;
+
+        (void)memcpy(&bits, &value, sizeof(bits));
+
+        if(bits >> 63) {
+                return ~bits;
+        }
+
+        return bits | ((uint64_t)1 << 63);
+}
+
+size_t pmt_da_lower_bound(
+        pmt_da_iface_t *iface, 
+        void *array, 
+        void *key,
+        pmt_da_less_than_t less_than)
+{
+        assert(array && less_than && pmt_da_iface_validate(iface));
+
+        size_t n = iface->get_size(array);
+
+        if(!n) {
+                return 0;
+        }
+
+        const size_t elem_size = iface->get_element_size(array);
+
+        uint8_t 
+                *buf = iface->get_buffer(array),
+                *base = buf;
+
+        while(n > 1) {
+                const size_t half = n / 2;
+                uint8_t *probe = base + half * elem_size;
+                base = less_than(probe, key) ? probe : base;
+                n -= half;
+        }
+
+        return (size_t)(base - buf) / elem_size + less_than(base, key);
+}
+
+size_t pmt_da_upper_bound(
+        pmt_da_iface_t *iface, 
+        void *array, 
+        void *key,
+        pmt_da_less_than_t less_than)
+{
+        assert(array && less_than && pmt_da_iface_validate(iface));
+
+        size_t n = iface->get_size(array);
+
+        if(!n) {
+                return 0;
+        }
+
+        const size_t elem_size = iface->get_element_size(array);
+
+        uint8_t 
+                *buf = iface->get_buffer(array),
+                *base = buf;
+
+        while(n > 1) {
+                const size_t half = n / 2;
+                uint8_t *probe = base + half * elem_size;
+                base = less_than(key, probe) ? base : probe;
+                n -= half;
+        }
+
+        return (size_t)(base - buf) / elem_size + !less_than(key, base);
+}
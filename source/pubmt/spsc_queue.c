@@ -0,0 +1,193 @@
+#include "pubmt/spsc_queue.h"
+#include <string.h>
+#include <stdint.h>
+#include <assert.h>
+
+pmt_spsc_queue_t *pmt_spsc_init(
+        pmt_spsc_queue_t *queue,
+        void *buffer,
+        const size_t capacity,
+        const size_t element_size)
+{
+        assert(queue && buffer && element_size);
+        assert(capacity && !(capacity & (capacity - 1)));
+
+        queue->buffer = buffer;
+        queue->mask = capacity - 1;
+        queue->element_size = element_size;
+        queue->cached_head = 0;
+        queue->cached_tail = 0;
+
+        atomic_init(&queue->tail, 0);
+        atomic_init(&queue->head, 0);
+
+        return queue;
+}
+
+size_t pmt_spsc_enqueue(
+        pmt_spsc_queue_t *queue,
+        const void *elems,
+        const size_t nelems)
+{
+        assert(queue && (elems || !nelems));
+
+        const size_t
+                capacity = queue->mask + 1,
+                tail = atomic_load_explicit(&queue->tail, memory_order_relaxed);
+
+        size_t space = capacity - (tail - queue->cached_head);
+
+        if(space < nelems) {
+                queue->cached_head = atomic_load_explicit(
+                        &queue->head,
+                        memory_order_acquire);
+                space = capacity - (tail - queue->cached_head);
+        }
+
+        const size_t count = nelems < space ? nelems : space;
+
+        if(!count) {
+                return 0;
+        }
+
+        const size_t
+                elem_size = queue->element_size,
+                pos = tail & queue->mask,
+                first = capacity - pos < count ? capacity - pos : count;
+
+        uint8_t *buf = queue->buffer;
+
+        (void)memcpy(buf + pos * elem_size, elems, first * elem_size);
+        (void)memcpy(
+                buf,
+                (const uint8_t*)elems + first * elem_size,
+                (count - first) * elem_size);
+
+        atomic_store_explicit(&queue->tail, tail + count, memory_order_release);
+
+        return count;
+}
+
+size_t pmt_spsc_dequeue(
+        pmt_spsc_queue_t *queue,
+        void *elems,
+        const size_t nelems)
+{
+        assert(queue && (elems || !nelems));
+
+        const size_t
+                capacity = queue->mask + 1,
+                head = atomic_load_explicit(&queue->head, memory_order_relaxed);
+
+        size_t used = queue->cached_tail - head;
+
+        if(used < nelems) {
+                queue->cached_tail = atomic_load_explicit(
+                        &queue->tail,
+                        memory_order_acquire);
+                used = queue->cached_tail - head;
+        }
+
+        const size_t count = nelems < used ? nelems : used;
+
+        if(!count) {
+                return 0;
+        }
+
+        const size_t
+                elem_size = queue->element_size,
+                pos = head & queue->mask,
+                first = capacity - pos < count ? capacity - pos : count;
+
+        const uint8_t *buf = queue->buffer;
+
+        (void)memcpy(elems, buf + pos * elem_size, first * elem_size);
+        (void)memcpy(
+                (uint8_t*)elems + first * elem_size,
+                buf,
+                (count - first) * elem_size);
+
+        atomic_store_explicit(&queue->head, head + count, memory_order_release);
+
+        return count;
+}
+
+bool pmt_spsc_push(pmt_spsc_queue_t *queue, const void *elem)
+{
+        assert(queue && elem);
+
+        const size_t tail = atomic_load_explicit(
+                &queue->tail,
+                memory_order_relaxed);
+
+        if(tail - queue->cached_head > queue->mask) {
+                queue->cached_head = atomic_load_explicit(
+                        &queue->head,
+                        memory_order_acquire);
+                if(tail - queue->cached_head > queue->mask) {
+                        return false;
+                }
+        }
+
+        (void)memcpy(
+                (uint8_t*)queue->buffer +
+                        (tail & queue->mask) * queue->element_size,
+                elem,
+                queue->element_size);
+
+        atomic_store_explicit(&queue->tail, tail + 1, memory_order_release);
+
+        return true;
+}
+
+bool pmt_spsc_pop(pmt_spsc_queue_t *queue, void *elem)
+{
+        assert(queue);
+
+        const size_t head = atomic_load_explicit(
+                &queue->head,
+                memory_order_relaxed);
+
+        if(queue->cached_tail == head) {
+                queue->cached_tail = atomic_load_explicit(
+                        &queue->tail,
+                        memory_order_acquire);
+                if(queue->cached_tail == head) {
+                        return false;
+                }
+        }
+
+        if(elem) {
+                (void)memcpy(
+                        elem,
+                        (uint8_t*)queue->buffer +
+                                (head & queue->mask) * queue->element_size,
+                        queue->element_size);
+        }
+
+        atomic_store_explicit(&queue->head, head + 1, memory_order_release);
+
+        return true;
+}
+
+size_t pmt_spsc_size(pmt_spsc_queue_t *queue)
+{
+        assert(queue);
+
+        const size_t
+                head = atomic_load_explicit(&queue->head, memory_order_acquire),
+                tail = atomic_load_explicit(&queue->tail, memory_order_acquire);
+
+        /* the tail may have moved on after the head was read */
+
+        const size_t size = tail - head;
+
+        return size > queue->mask ? queue->mask + 1 : size;
+}
+
+size_t pmt_spsc_capacity(pmt_spsc_queue_t *queue)
+{
+        assert(queue);
+
+        return queue->mask + 1;
+}
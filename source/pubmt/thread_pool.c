@@ -0,0 +1,561 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "pubmt/thread_pool.h"
+#include <sched.h>
+#include <stdint.h>
+#include <assert.h>
+
+/** Worker running on the calling thread, if any. */
+static _Thread_local pmt_tp_worker_t *pmt_tp_self = NULL;
+
+static bool pmt_tp_deque_push(pmt_tp_worker_t *worker, pmt_tp_task_t *task)
+{
+        const long long
+                bottom = atomic_load_explicit(
+                        &worker->bottom,
+                        memory_order_relaxed),
+                top = atomic_load_explicit(
+                        &worker->top,
+                        memory_order_acquire);
+
+        if(bottom - top >= PMT_TP_DEQUE_CAPACITY) {
+                return false;
+        }
+
+        atomic_store_explicit(
+                &worker->tasks[(size_t)bottom & (PMT_TP_DEQUE_CAPACITY - 1)],
+                task,
+                memory_order_relaxed);
+
+        atomic_store_explicit(&worker->bottom, bottom + 1, memory_order_release);
+
+        return true;
+}
+
+static pmt_tp_task_t *pmt_tp_deque_take(pmt_tp_worker_t *worker)
+{
+        const long long bottom = atomic_load_explicit(
+                &worker->bottom,
+                memory_order_relaxed) - 1;
+
+        atomic_store_explicit(&worker->bottom, bottom, memory_order_relaxed);
+
+        atomic_thread_fence(memory_order_seq_cst);
+
+        long long top = atomic_load_explicit(&worker->top, memory_order_relaxed);
+
+        if(top > bottom) {
+                atomic_store_explicit(
+                        &worker->bottom,
+                        bottom + 1,
+                        memory_order_relaxed);
+                return NULL;
+        }
+
+        pmt_tp_task_t *task = atomic_load_explicit(
+                &worker->tasks[(size_t)bottom & (PMT_TP_DEQUE_CAPACITY - 1)],
+                memory_order_relaxed);
+
+        if(top == bottom) {
+                /* the last task, race the thieves for it */
+                if(!atomic_compare_exchange_strong_explicit(
+                        &worker->top,
+                        &top,
+                        top + 1,
+                        memory_order_seq_cst,
+                        memory_order_relaxed))
+                {
+                        task = NULL;
+                }
+                atomic_store_explicit(
+                        &worker->bottom,
+                        bottom + 1,
+                        memory_order_relaxed);
+        }
+
+        return task;
+}
+
+static pmt_tp_task_t *pmt_tp_deque_steal(pmt_tp_worker_t *worker)
+{
+        long long top = atomic_load_explicit(&worker->top, memory_order_acquire);
+
+        atomic_thread_fence(memory_order_seq_cst);
+
+        const long long bottom = atomic_load_explicit(
+                &worker->bottom,
+                memory_order_acquire);
+
+        if(top >= bottom) {
+                return NULL;
+        }
+
+        pmt_tp_task_t *task = atomic_load_explicit(
+                &worker->tasks[(size_t)top & (PMT_TP_DEQUE_CAPACITY - 1)],
+                memory_order_relaxed);
+
+        if(!atomic_compare_exchange_strong_explicit(
+                &worker->top,
+                &top,
+                top + 1,
+                memory_order_seq_cst,
+                memory_order_relaxed))
+        {
+                return NULL;
+        }
+
+        return task;
+}
+
+static size_t pmt_tp_random(pmt_tp_worker_t *worker, const size_t bound)
+{
+        /* xorshift64 */
+
+        unsigned long long x = worker->seed;
+
+        x ^= x << 13;
+        x ^= x >> 7;
+        x ^= x << 17;
+
+        worker->seed = x;
+
+        return (size_t)(x % bound);
+}
+
+static pmt_tp_task_t *pmt_tp_find(pmt_tp_pool_t *pool, pmt_tp_worker_t *self)
+{
+        pmt_tp_task_t *task = NULL;
+
+        if(self) {
+                task = pmt_tp_deque_take(self);
+                if(task) {
+                        return task;
+                }
+        }
+
+        if(pmt_mpmc_try_dequeue(&pool->inject, &task)) {
+                return task;
+        }
+
+        const size_t
+                nworkers = pool->nworkers,
+                start = self ? pmt_tp_random(self, nworkers) : 0;
+
+        for(size_t x = 0; x < nworkers; ++x) {
+                pmt_tp_worker_t *victim = pool->workers + (start + x) % nworkers;
+                if(victim == self) {
+                        continue;
+                }
+                task = pmt_tp_deque_steal(victim);
+                if(task) {
+                        return task;
+                }
+        }
+
+        return NULL;
+}
+
+static void pmt_tp_execute(pmt_tp_pool_t *pool, pmt_tp_task_t *task)
+{
+        /* The task and its group may be released as soon as the group
+           completes, only the pool is touched afterwards. */
+
+        pmt_tp_group_t *group = task->group;
+
+        task->run(task->arg);
+
+        if(atomic_fetch_sub_explicit(
+                &group->pending,
+                1,
+                memory_order_seq_cst) != 1)
+        {
+                return;
+        }
+
+        if(atomic_load_explicit(&pool->waiters, memory_order_seq_cst)) {
+                (void)pthread_mutex_lock(&pool->lock);
+                (void)pthread_cond_broadcast(&pool->done);
+                (void)pthread_mutex_unlock(&pool->lock);
+        }
+}
+
+/*
+ * The fence orders the task's publication before the sleeper count is read,
+ * pairing with the fence after a worker announces itself as a sleeper, so
+ * either the worker finds the task or it is woken.
+ */
+static void pmt_tp_notify(pmt_tp_pool_t *pool)
+{
+        atomic_thread_fence(memory_order_seq_cst);
+
+        if(!atomic_load_explicit(&pool->sleepers, memory_order_relaxed)) {
+                return;
+        }
+
+        (void)pthread_mutex_lock(&pool->lock);
+        (void)atomic_fetch_add_explicit(&pool->epoch, 1, memory_order_relaxed);
+        (void)pthread_cond_signal(&pool->wake);
+        (void)pthread_mutex_unlock(&pool->lock);
+}
+
+static void *pmt_tp_worker_main(void *arg)
+{
+        pmt_tp_worker_t *self = arg;
+        pmt_tp_pool_t *pool = self->pool;
+
+        pmt_tp_self = self;
+
+        size_t idle = 0;
+
+        while(!atomic_load_explicit(&pool->stop, memory_order_acquire)) {
+                pmt_tp_task_t *task = pmt_tp_find(pool, self);
+
+                if(task) {
+                        pmt_tp_execute(pool, task);
+                        idle = 0;
+                        continue;
+                }
+
+                if(++idle < PMT_TP_IDLE_ROUNDS) {
+                        (void)sched_yield();
+                        continue;
+                }
+
+                const unsigned int epoch = atomic_load_explicit(
+                        &pool->epoch,
+                        memory_order_relaxed);
+
+                (void)atomic_fetch_add_explicit(
+                        &pool->sleepers,
+                        1,
+                        memory_order_relaxed);
+
+                atomic_thread_fence(memory_order_seq_cst);
+
+                task = pmt_tp_find(pool, self);
+
+                if(!task) {
+                        (void)pthread_mutex_lock(&pool->lock);
+                        while(atomic_load_explicit(
+                                        &pool->epoch,
+                                        memory_order_relaxed) == epoch &&
+                                !atomic_load_explicit(
+                                        &pool->stop,
+                                        memory_order_relaxed))
+                        {
+                                (void)pthread_cond_wait(&pool->wake, &pool->lock);
+                        }
+                        (void)pthread_mutex_unlock(&pool->lock);
+                }
+
+                (void)atomic_fetch_sub_explicit(
+                        &pool->sleepers,
+                        1,
+                        memory_order_relaxed);
+
+                if(task) {
+                        pmt_tp_execute(pool, task);
+                }
+
+                idle = 0;
+        }
+
+        pmt_tp_self = NULL;
+
+        return NULL;
+}
+
+static void pmt_tp_stop(pmt_tp_pool_t *pool, const size_t nstarted)
+{
+        (void)pthread_mutex_lock(&pool->lock);
+        atomic_store_explicit(&pool->stop, true, memory_order_release);
+        (void)atomic_fetch_add_explicit(&pool->epoch, 1, memory_order_relaxed);
+        (void)pthread_cond_broadcast(&pool->wake);
+        (void)pthread_mutex_unlock(&pool->lock);
+
+        for(size_t x = 0; x < nstarted; ++x) {
+                (void)pthread_join(pool->workers[x].thread, NULL);
+        }
+}
+
+static void pmt_tp_release(pmt_tp_pool_t *pool)
+{
+        for(size_t x = 0; x < pool->nworkers; ++x) {
+                pool->free(pool->workers[x].tasks, pool->alloc_state);
+        }
+
+        pool->free(pool->worker_memory, pool->alloc_state);
+
+        pmt_mpmc_destroy(&pool->inject);
+
+        (void)pthread_cond_destroy(&pool->done);
+        (void)pthread_cond_destroy(&pool->wake);
+        (void)pthread_mutex_destroy(&pool->lock);
+}
+
+pmt_tp_pool_t *pmt_tp_create(
+        pmt_tp_pool_t *pool,
+        const size_t nworkers,
+        pmt_da_alloc_t alloc,
+        pmt_da_free_t free,
+        void *alloc_state)
+{
+        assert(pool && nworkers && alloc && free);
+
+        if((SIZE_MAX - PMT_TP_CACHE_LINE) / sizeof(pmt_tp_worker_t) <
+                nworkers)
+        {
+                return NULL;
+        }
+
+        if(!pmt_mpmc_create(
+                &pool->inject,
+                PMT_TP_INJECT_CAPACITY,
+                sizeof(pmt_tp_task_t*),
+                alloc,
+                free,
+                alloc_state))
+        {
+                return NULL;
+        }
+
+        pool->workers = NULL;
+        pool->worker_memory = NULL;
+        pool->nworkers = 0;
+        pool->free = free;
+        pool->alloc_state = alloc_state;
+
+        (void)pthread_mutex_init(&pool->lock, NULL);
+        (void)pthread_cond_init(&pool->wake, NULL);
+        (void)pthread_cond_init(&pool->done, NULL);
+
+        atomic_init(&pool->epoch, 0);
+        atomic_init(&pool->sleepers, 0);
+        atomic_init(&pool->waiters, 0);
+        atomic_init(&pool->stop, false);
+
+        /* over-allocate by a line so the workers can start on a boundary */
+
+        pool->worker_memory = alloc(
+                nworkers * sizeof(pmt_tp_worker_t) + PMT_TP_CACHE_LINE - 1,
+                alloc_state);
+        if(!pool->worker_memory) {
+                pmt_mpmc_destroy(&pool->inject);
+                (void)pthread_cond_destroy(&pool->done);
+                (void)pthread_cond_destroy(&pool->wake);
+                (void)pthread_mutex_destroy(&pool->lock);
+                return NULL;
+        }
+
+        const uintptr_t address = (uintptr_t)pool->worker_memory;
+
+        pool->workers = (pmt_tp_worker_t*)(
+                (address + PMT_TP_CACHE_LINE - 1) &
+                ~(uintptr_t)(PMT_TP_CACHE_LINE - 1));
+
+        for(; pool->nworkers < nworkers; ++pool->nworkers) {
+                pmt_tp_worker_t *worker = pool->workers + pool->nworkers;
+                worker->tasks = alloc(
+                        PMT_TP_DEQUE_CAPACITY * sizeof(worker->tasks[0]),
+                        alloc_state);
+                if(!worker->tasks) {
+                        pmt_tp_release(pool);
+                        return NULL;
+                }
+                atomic_init(&worker->top, 0);
+                atomic_init(&worker->bottom, 0);
+                worker->pool = pool;
+                worker->seed = 0x9e3779b97f4a7c15ull * (pool->nworkers + 1);
+        }
+
+        for(size_t x = 0; x < nworkers; ++x) {
+                pmt_tp_worker_t *worker = pool->workers + x;
+                if(pthread_create(
+                        &worker->thread,
+                        NULL,
+                        pmt_tp_worker_main,
+                        worker))
+                {
+                        pmt_tp_stop(pool, x);
+                        pmt_tp_release(pool);
+                        return NULL;
+                }
+        }
+
+        return pool;
+}
+
+void pmt_tp_destroy(pmt_tp_pool_t *pool)
+{
+        assert(pool);
+
+        pmt_tp_stop(pool, pool->nworkers);
+        pmt_tp_release(pool);
+}
+
+size_t pmt_tp_size(pmt_tp_pool_t *pool)
+{
+        assert(pool);
+
+        return pool->nworkers;
+}
+
+pmt_tp_group_t *pmt_tp_group_init(pmt_tp_group_t *group)
+{
+        assert(group);
+
+        atomic_init(&group->pending, 0);
+
+        return group;
+}
+
+void pmt_tp_spawn(
+        pmt_tp_pool_t *pool,
+        pmt_tp_group_t *group,
+        pmt_tp_task_t *task,
+        pmt_tp_run_t run,
+        void *arg)
+{
+        assert(pool && group && task && run);
+
+        task->run = run;
+        task->arg = arg;
+        task->group = group;
+
+        (void)atomic_fetch_add_explicit(
+                &group->pending,
+                1,
+                memory_order_relaxed);
+
+        pmt_tp_worker_t *self = pmt_tp_self;
+
+        const bool queued = self && self->pool == pool ?
+                pmt_tp_deque_push(self, task) :
+                pmt_mpmc_try_enqueue(&pool->inject, &task);
+
+        if(!queued) {
+                pmt_tp_execute(pool, task);
+                return;
+        }
+
+        pmt_tp_notify(pool);
+}
+
+void pmt_tp_wait(pmt_tp_pool_t *pool, pmt_tp_group_t *group)
+{
+        assert(pool && group);
+
+        pmt_tp_worker_t *self = pmt_tp_self;
+
+        if(self && self->pool == pool) {
+                while(atomic_load_explicit(
+                        &group->pending,
+                        memory_order_acquire))
+                {
+                        pmt_tp_task_t *task = pmt_tp_find(pool, self);
+                        if(task) {
+                                pmt_tp_execute(pool, task);
+                        } else {
+                                (void)sched_yield();
+                        }
+                }
+                return;
+        }
+
+        /* Other threads sleep, running the oldest queued tasks while waiting
+           could nest without bound. */
+
+        (void)atomic_fetch_add_explicit(
+                &pool->waiters,
+                1,
+                memory_order_seq_cst);
+
+        (void)pthread_mutex_lock(&pool->lock);
+        while(atomic_load_explicit(&group->pending, memory_order_seq_cst)) {
+                (void)pthread_cond_wait(&pool->done, &pool->lock);
+        }
+        (void)pthread_mutex_unlock(&pool->lock);
+
+        (void)atomic_fetch_sub_explicit(
+                &pool->waiters,
+                1,
+                memory_order_relaxed);
+}
+
+/** Range of a parallel loop. */
+typedef struct pmt_tp_range {
+
+        pmt_tp_pool_t *pool;
+
+        size_t begin, end, grain;
+
+        pmt_tp_body_t body;
+        void *state;
+
+} pmt_tp_range_t;
+
+/** Maximum halvings of one range, enough for any size_t range. */
+#define PMT_TP_MAX_SPLITS (sizeof(size_t) * 8)
+
+/* Split off the upper half of the range as a task until what is left fits
+   the grain, run that, then wait for the halves. */
+static void pmt_tp_range_run(void *arg)
+{
+        pmt_tp_range_t *range = arg;
+
+        pmt_tp_range_t halves[PMT_TP_MAX_SPLITS];
+        pmt_tp_task_t tasks[PMT_TP_MAX_SPLITS];
+
+        pmt_tp_group_t group;
+        pmt_tp_group_init(&group);
+
+        size_t
+                begin = range->begin,
+                end = range->end,
+                nsplits = 0;
+
+        while(end - begin > range->grain && nsplits < PMT_TP_MAX_SPLITS) {
+                const size_t middle = begin + (end - begin) / 2;
+                pmt_tp_range_t *half = halves + nsplits;
+                *half = *range;
+                half->begin = middle;
+                half->end = end;
+                pmt_tp_spawn(
+                        range->pool,
+                        &group,
+                        tasks + nsplits,
+                        pmt_tp_range_run,
+                        half);
+                end = middle;
+                ++nsplits;
+        }
+
+        range->body(begin, end, range->state);
+
+        pmt_tp_wait(range->pool, &group);
+}
+
+void pmt_tp_parallel_for(
+        pmt_tp_pool_t *pool,
+        const size_t begin,
+        const size_t end,
+        const size_t grain,
+        pmt_tp_body_t body,
+        void *state)
+{
+        assert(pool && body && begin <= end);
+
+        if(begin == end) {
+                return;
+        }
+
+        pmt_tp_range_t range = {
+                .pool = pool,
+                .begin = begin,
+                .end = end,
+                .grain = grain ? grain : 1,
+                .body = body,
+                .state = state };
+
+        pmt_tp_range_run(&range);
+}
@@ -0,0 +1,422 @@
+#include "pubmt/timing_wheel.h"
+#include <assert.h>
+
+/* slot numbers of the due and firing lists, after the wheel's slots */
+#define PMT_TW_DUE (PMT_TW_LEVELS * PMT_TW_SLOTS)
+#define PMT_TW_FIRING (PMT_TW_DUE + 1)
+
+#define PMT_TW_MASK ((uint64_t)PMT_TW_SLOTS - 1)
+
+bool pmt_tw_node_iface_validate(pmt_tw_node_iface_t *iface)
+{
+        return
+                iface &&
+                iface->get_prev &&
+                iface->set_prev &&
+                iface->get_expiry &&
+                iface->set_expiry &&
+                iface->get_slot &&
+                iface->set_slot &&
+                pmt_ll_node_iface_validate(&iface->list_iface);
+}
+
+static unsigned int pmt_tw_high_bit(uint64_t bits)
+{
+        assert(bits);
+
+#if defined(__GNUC__)
+        return 63u - (unsigned int)__builtin_clzll((unsigned long long)bits);
+#else
+        unsigned int index = 0;
+        while(bits >>= 1) {
+                ++index;
+        }
+        return index;
+#endif
+}
+
+static unsigned int pmt_tw_low_bit(uint64_t bits)
+{
+        assert(bits);
+
+#if defined(__GNUC__)
+        return (unsigned int)__builtin_ctzll((unsigned long long)bits);
+#else
+        unsigned int index = 0;
+        while(!(bits & 1)) {
+                bits >>= 1;
+                ++index;
+        }
+        return index;
+#endif
+}
+
+static void **pmt_tw_head(pmt_tw_wheel_t *wheel, const size_t slot)
+{
+        if(slot == PMT_TW_DUE) {
+                return &wheel->due;
+        } else if(slot == PMT_TW_FIRING) {
+                return &wheel->firing;
+        }
+
+        assert(slot < PMT_TW_DUE);
+
+        return wheel->slots + slot;
+}
+
+static void pmt_tw_link(
+        pmt_tw_node_iface_t *iface,
+        pmt_tw_wheel_t *wheel,
+        void *timer,
+        const size_t slot)
+{
+        void **head = pmt_tw_head(wheel, slot);
+
+        if(*head) {
+                iface->set_prev(*head, timer);
+        }
+
+        iface->list_iface.set_next(timer, *head);
+        iface->set_prev(timer, NULL);
+        iface->set_slot(timer, slot);
+
+        *head = timer;
+
+        if(slot < PMT_TW_DUE) {
+                wheel->occupied[slot / PMT_TW_SLOTS] |=
+                        (uint64_t)1 << (slot % PMT_TW_SLOTS);
+        }
+}
+
+static void pmt_tw_unlink(
+        pmt_tw_node_iface_t *iface,
+        pmt_tw_wheel_t *wheel,
+        void *timer)
+{
+        const size_t slot = iface->get_slot(timer);
+
+        void
+                *prev = iface->get_prev(timer),
+                *next = iface->list_iface.get_next(timer);
+
+        if(prev) {
+                iface->list_iface.set_next(prev, next);
+        } else {
+                void **head = pmt_tw_head(wheel, slot);
+                assert(*head == timer);
+                *head = next;
+                if(!next && slot < PMT_TW_DUE) {
+                        wheel->occupied[slot / PMT_TW_SLOTS] &=
+                                ~((uint64_t)1 << (slot % PMT_TW_SLOTS));
+                }
+        }
+
+        if(next) {
+                iface->set_prev(next, prev);
+        }
+
+        iface->set_slot(timer, PMT_TW_NONE);
+}
+
+/* Place a timer relative to the current tick. */
+static void pmt_tw_place(
+        pmt_tw_node_iface_t *iface,
+        pmt_tw_wheel_t *wheel,
+        void *timer)
+{
+        const uint64_t
+                expiry = iface->get_expiry(timer),
+                now = wheel->now;
+
+        if(expiry <= now) {
+                pmt_tw_link(iface, wheel, timer, PMT_TW_DUE);
+                return;
+        }
+
+        const unsigned int
+                level = pmt_tw_high_bit(expiry ^ now) / PMT_TW_BITS,
+                shift = level * PMT_TW_BITS;
+
+        const size_t group = (size_t)((expiry >> shift) & PMT_TW_MASK);
+
+        pmt_tw_link(iface, wheel, timer, level * PMT_TW_SLOTS + group);
+}
+
+/*
+ * Find the next tick at which a slot of the wheel must be processed.  Every
+ * timer on a level agrees with the current tick above that level and is
+ * ahead of it on that level, so the lowest occupied slot past the current
+ * one, with the lower levels zeroed, is that level's next event.
+ */
+static bool pmt_tw_next_event(pmt_tw_wheel_t *wheel, uint64_t *tick)
+{
+        const uint64_t now = wheel->now;
+
+        bool found = false;
+
+        for(unsigned int level = 0; level < PMT_TW_LEVELS; ++level) {
+
+                const unsigned int
+                        shift = level * PMT_TW_BITS,
+                        upper = shift + PMT_TW_BITS;
+
+                const unsigned int current =
+                        (unsigned int)((now >> shift) & PMT_TW_MASK);
+
+                if(current == PMT_TW_MASK) {
+                        continue;
+                }
+
+                const uint64_t ahead =
+                        wheel->occupied[level] &
+                        (~(uint64_t)0 << (current + 1));
+
+                if(!ahead) {
+                        continue;
+                }
+
+                const uint64_t
+                        base = upper >= 64 ? 0 : (now >> upper) << upper,
+                        group = pmt_tw_low_bit(ahead),
+                        event = base | (group << shift);
+
+                if(!found || event < *tick) {
+                        *tick = event;
+                        found = true;
+                }
+        }
+
+        return found;
+}
+
+/* Move every timer of the slot down to a lower level. */
+static void pmt_tw_cascade(
+        pmt_tw_node_iface_t *iface,
+        pmt_tw_wheel_t *wheel,
+        const size_t slot)
+{
+        void *timer = NULL;
+
+        const uint64_t now = wheel->now;
+
+        while((timer = wheel->slots[slot])) {
+
+                pmt_tw_unlink(iface, wheel, timer);
+
+                /* expiring right now, fired from the first level next */
+
+                if(iface->get_expiry(timer) == now) {
+                        pmt_tw_link(
+                                iface,
+                                wheel,
+                                timer,
+                                (size_t)(now & PMT_TW_MASK));
+                } else {
+                        pmt_tw_place(iface, wheel, timer);
+                }
+
+                assert(iface->get_slot(timer) != slot);
+        }
+}
+
+/* Expire the timers of a list one at a time, the callback may change it. */
+static size_t pmt_tw_fire(
+        pmt_tw_node_iface_t *iface,
+        pmt_tw_wheel_t *wheel,
+        const size_t slot,
+        pmt_tw_expire_t expire,
+        void *state)
+{
+        void **head = pmt_tw_head(wheel, slot);
+
+        size_t count = 0;
+
+        void *timer = NULL;
+
+        while((timer = *head)) {
+                pmt_tw_unlink(iface, wheel, timer);
+                --wheel->size;
+                ++count;
+                expire(timer, state);
+        }
+
+        return count;
+}
+
+pmt_tw_wheel_t *pmt_tw_init(
+        pmt_tw_node_iface_t *iface,
+        pmt_tw_wheel_t *wheel,
+        const uint64_t now)
+{
+        assert(wheel && pmt_tw_node_iface_validate(iface));
+
+        for(size_t x = 0; x < PMT_TW_LEVELS * PMT_TW_SLOTS; ++x) {
+                wheel->slots[x] = NULL;
+        }
+
+        for(size_t x = 0; x < PMT_TW_LEVELS; ++x) {
+                wheel->occupied[x] = 0;
+        }
+
+        wheel->due = NULL;
+        wheel->firing = NULL;
+        wheel->now = now;
+        wheel->size = 0;
+
+        return wheel;
+}
+
+void pmt_tw_timer_init(pmt_tw_node_iface_t *iface, void *timer)
+{
+        assert(timer && pmt_tw_node_iface_validate(iface));
+
+        iface->list_iface.set_next(timer, NULL);
+        iface->set_prev(timer, NULL);
+        iface->set_slot(timer, PMT_TW_NONE);
+}
+
+bool pmt_tw_is_scheduled(pmt_tw_node_iface_t *iface, void *timer)
+{
+        assert(timer && pmt_tw_node_iface_validate(iface));
+
+        return iface->get_slot(timer) != PMT_TW_NONE;
+}
+
+size_t pmt_tw_size(pmt_tw_node_iface_t *iface, pmt_tw_wheel_t *wheel)
+{
+        assert(wheel && pmt_tw_node_iface_validate(iface));
+
+        return wheel->size;
+}
+
+uint64_t pmt_tw_now(pmt_tw_node_iface_t *iface, pmt_tw_wheel_t *wheel)
+{
+        assert(wheel && pmt_tw_node_iface_validate(iface));
+
+        return wheel->now;
+}
+
+void pmt_tw_schedule(
+        pmt_tw_node_iface_t *iface,
+        pmt_tw_wheel_t *wheel,
+        void *timer,
+        const uint64_t expiry)
+{
+        assert(wheel && timer && pmt_tw_node_iface_validate(iface));
+
+        if(iface->get_slot(timer) != PMT_TW_NONE) {
+                pmt_tw_unlink(iface, wheel, timer);
+        } else {
+                ++wheel->size;
+        }
+
+        iface->set_expiry(timer, expiry);
+
+        pmt_tw_place(iface, wheel, timer);
+}
+
+bool pmt_tw_cancel(
+        pmt_tw_node_iface_t *iface,
+        pmt_tw_wheel_t *wheel,
+        void *timer)
+{
+        assert(wheel && timer && pmt_tw_node_iface_validate(iface));
+
+        if(iface->get_slot(timer) == PMT_TW_NONE) {
+                return false;
+        }
+
+        pmt_tw_unlink(iface, wheel, timer);
+
+        --wheel->size;
+
+        return true;
+}
+
+bool pmt_tw_next_tick(
+        pmt_tw_node_iface_t *iface,
+        pmt_tw_wheel_t *wheel,
+        uint64_t *tick)
+{
+        assert(wheel && tick && pmt_tw_node_iface_validate(iface));
+
+        if(wheel->due || wheel->firing) {
+                *tick = wheel->now;
+                return true;
+        }
+
+        return pmt_tw_next_event(wheel, tick);
+}
+
+size_t pmt_tw_advance(
+        pmt_tw_node_iface_t *iface,
+        pmt_tw_wheel_t *wheel,
+        const uint64_t now,
+        pmt_tw_expire_t expire,
+        void *state)
+{
+        assert(wheel && expire && pmt_tw_node_iface_validate(iface));
+        assert(!wheel->firing);
+
+        size_t count = 0;
+
+        /* timers scheduled while the due list fires wait for the next call */
+
+        if(wheel->due) {
+
+                void *timer = wheel->due;
+
+                wheel->firing = timer;
+                wheel->due = NULL;
+
+                for(; timer; timer = iface->list_iface.get_next(timer)) {
+                        iface->set_slot(timer, PMT_TW_FIRING);
+                }
+
+                count += pmt_tw_fire(
+                        iface,
+                        wheel,
+                        PMT_TW_FIRING,
+                        expire,
+                        state);
+        }
+
+        uint64_t tick = 0;
+
+        while(pmt_tw_next_event(wheel, &tick) && tick <= now) {
+
+                wheel->now = tick;
+
+                /* cascade from the top, so timers can fall several levels */
+
+                for(unsigned int level = PMT_TW_LEVELS; --level > 0;) {
+
+                        const unsigned int shift = level * PMT_TW_BITS;
+
+                        if(tick & (((uint64_t)1 << shift) - 1)) {
+                                continue;
+                        }
+
+                        const size_t group =
+                                (size_t)((tick >> shift) & PMT_TW_MASK);
+
+                        pmt_tw_cascade(
+                                iface,
+                                wheel,
+                                level * PMT_TW_SLOTS + group);
+                }
+
+                count += pmt_tw_fire(
+                        iface,
+                        wheel,
+                        (size_t)(tick & PMT_TW_MASK),
+                        expire,
+                        state);
+        }
+
+        if(now > wheel->now) {
+                wheel->now = now;
+        }
+
+        return count;
+}
@@ -0,0 +1,109 @@
+#include "pubmt/treiber_stack.h"
+#include <assert.h>
+
+pmt_ts_stack_t *pmt_ts_init(pmt_ts_stack_t *stack)
+{
+        assert(stack);
+
+        const pmt_ts_top_t top = { .node = NULL, .tag = 0 };
+
+        atomic_init(&stack->top, top);
+
+        return stack;
+}
+
+void pmt_ts_push(pmt_ll_node_iface_t *iface, pmt_ts_stack_t *stack, void *node)
+{
+        pmt_ts_push_list(iface, stack, node, node);
+}
+
+void pmt_ts_push_list(
+        pmt_ll_node_iface_t *iface,
+        pmt_ts_stack_t *stack,
+        void *first,
+        void *last)
+{
+        assert(stack && first && last && pmt_ll_node_iface_validate(iface));
+
+        pmt_ts_top_t top = atomic_load_explicit(
+                &stack->top,
+                memory_order_relaxed);
+
+        pmt_ts_top_t next;
+
+        do {
+                iface->set_next(last, top.node);
+                next.node = first;
+                next.tag = top.tag + 1;
+        } while(!atomic_compare_exchange_weak_explicit(
+                &stack->top,
+                &top,
+                next,
+                memory_order_release,
+                memory_order_relaxed));
+}
+
+void *pmt_ts_pop(pmt_ll_node_iface_t *iface, pmt_ts_stack_t *stack)
+{
+        assert(stack && pmt_ll_node_iface_validate(iface));
+
+        pmt_ts_top_t top = atomic_load_explicit(
+                &stack->top,
+                memory_order_acquire);
+
+        pmt_ts_top_t next;
+
+        do {
+                if(!top.node) {
+                        return NULL;
+                }
+
+                /* The node may be popped and reused meanwhile, in which case
+                   the tag has moved on and the exchange fails. */
+
+                next.node = iface->get_next(top.node);
+                next.tag = top.tag + 1;
+        } while(!atomic_compare_exchange_weak_explicit(
+                &stack->top,
+                &top,
+                next,
+                memory_order_acquire,
+                memory_order_acquire));
+
+        iface->set_next(top.node, NULL);
+
+        return top.node;
+}
+
+void *pmt_ts_pop_all(pmt_ts_stack_t *stack)
+{
+        assert(stack);
+
+        pmt_ts_top_t top = atomic_load_explicit(
+                &stack->top,
+                memory_order_relaxed);
+
+        pmt_ts_top_t next;
+
+        do {
+                if(!top.node) {
+                        return NULL;
+                }
+                next.node = NULL;
+                next.tag = top.tag + 1;
+        } while(!atomic_compare_exchange_weak_explicit(
+                &stack->top,
+                &top,
+                next,
+                memory_order_acquire,
+                memory_order_relaxed));
+
+        return top.node;
+}
+
+bool pmt_ts_is_empty(pmt_ts_stack_t *stack)
+{
+        assert(stack);
+
+        return !atomic_load_explicit(&stack->top, memory_order_relaxed).node;
+}
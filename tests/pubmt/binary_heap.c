@@ -1,6 +1,7 @@
 
 #include "pubmt/binary_heap.h"
 #include <stdio.h>
+#include <stdint.h>
 #include <assert.h>
 
 typedef struct my_heap {
@@ -195,10 +196,377 @@ void test_peek_pop()
         pmt_da_destroy(&my_iface.array_iface, &heap);
 }
 
+size_t arity = 2;
+
+size_t get_arity(void *heap)
+{
+        return arity;
+}
+
+void check_order(pmt_bh_iface_t *iface)
+{
+        my_heap heap;
+        pmt_da_create(&iface->array_iface, &heap, 4);
+
+        int *values = make_deck(0, 1000);
+
+        for(int x = 0; x < 1000; ++x) {
+                int *pointer = pmt_bh_insert(iface, &heap, values + x);
+                assert(pointer && *pointer == values[x]);
+        }
+
+        for(int x = 0; x < 500; ++x) {
+                int value = -1;
+                assert(*((int*)pmt_bh_peek(iface, &heap)) == x);
+                assert(pmt_bh_pop(iface, &heap, &value));
+                assert(value == x);
+        }
+
+        /* refill the popped half and drain everything */
+
+        for(int x = 499; x >= 0; --x) {
+                assert(pmt_bh_insert(iface, &heap, &x));
+        }
+
+        for(int x = 0; x < 1000; ++x) {
+                int value = -1;
+                assert(pmt_bh_pop(iface, &heap, &value));
+                assert(value == x);
+        }
+
+        assert(!pmt_bh_pop(iface, &heap, NULL));
+
+        free(values);
+        pmt_da_destroy(&iface->array_iface, &heap);
+}
+
+void test_arity()
+{
+        const size_t arities[] = { 3, 4, 8 };
+
+        pmt_bh_iface_t iface = my_iface;
+        iface.get_arity = get_arity;
+
+        for(size_t a = 0; a < sizeof(arities) / sizeof(arities[0]); ++a) {
+                arity = arities[a];
+                check_order(&iface);
+        }
+}
+
+void test_no_swap()
+{
+        const size_t arities[] = { 2, 4, 8 };
+
+        pmt_bh_iface_t iface = my_iface;
+        iface.get_swap = NULL;
+        iface.get_arity = get_arity;
+
+        assert(pmt_bh_iface_validate(&iface));
+
+        for(size_t a = 0; a < sizeof(arities) / sizeof(arities[0]); ++a) {
+                arity = arities[a];
+                check_order(&iface);
+        }
+}
+
+typedef struct my_item {
+        int key;
+        size_t index;
+} my_item;
+
+void item_swap(void *elem_a, void *elem_b) 
+{
+        my_item **a = elem_a, **b = elem_b, *tmp = *a;
+        *a = *b;
+        *b = tmp;
+}
+
+pmt_bh_swap_t get_item_swap(void *heap)
+{
+        return item_swap;
+}
+
+bool item_less_than(void *elem_a, void *elem_b) 
+{
+        return (*(my_item**)elem_a)->key < (*(my_item**)elem_b)->key;
+}
+
+pmt_bh_less_than_t get_item_less_than(void *heap)
+{
+        return item_less_than;
+}
+
+void item_set_index(void *elem, const size_t index)
+{
+        (*(my_item**)elem)->index = index;
+}
+
+pmt_bh_set_index_t get_item_set_index(void *heap)
+{
+        return item_set_index;
+}
+
+size_t get_item_size(void *array)
+{
+        return sizeof(my_item*);
+}
+
+void check_indexes(my_heap *heap)
+{
+        my_item **items = (my_item**)heap->buffer;
+        for(size_t x = 0; x < heap->size; ++x) {
+                assert(items[x]->index == x);
+        }
+}
+
+void check_indexed(pmt_bh_iface_t *iface)
+{
+        enum { NITEMS = 1000 };
+
+        my_item *items = malloc(sizeof(my_item) * NITEMS);
+        bool removed[NITEMS] = { false };
+
+        my_heap heap;
+        pmt_da_create(&iface->array_iface, &heap, 4);
+
+        for(int x = 0; x < NITEMS; ++x) {
+                my_item *item = items + x;
+                item->key = rand() % 10000;
+                assert(pmt_bh_insert(iface, &heap, &item));
+        }
+
+        check_indexes(&heap);
+
+        /* decrease, increase and cancel random items */
+
+        for(int x = 0; x < 2000; ++x) {
+                const size_t n = (size_t)(rand() % NITEMS);
+                my_item *item = items + n;
+                if(removed[n]) {
+                        continue;
+                }
+                if(x % 5 == 0) {
+                        my_item *out = NULL;
+                        assert(pmt_bh_remove_at(iface, &heap, item->index, &out));
+                        assert(out == item);
+                        removed[n] = true;
+                } else {
+                        item->key += x % 2 ? 5000 : -5000;
+                        my_item **pointer = pmt_bh_update(
+                                iface, 
+                                &heap, 
+                                item->index);
+                        assert(pointer && *pointer == item);
+                }
+                check_indexes(&heap);
+        }
+
+        assert(!pmt_bh_update(iface, &heap, heap.size));
+        assert(!pmt_bh_remove_at(iface, &heap, heap.size, NULL));
+
+        int prev = -1000000;
+        my_item *item = NULL;
+
+        while(pmt_bh_pop(iface, &heap, &item)) {
+                assert(item->key >= prev);
+                prev = item->key;
+                check_indexes(&heap);
+        }
+
+        free(items);
+        pmt_da_destroy(&iface->array_iface, &heap);
+}
+
+void test_indexed()
+{
+        pmt_bh_iface_t iface = my_iface;
+        iface.get_swap = get_item_swap;
+        iface.get_less_than = get_item_less_than;
+        iface.get_set_index = get_item_set_index;
+        iface.get_arity = get_arity;
+        iface.array_iface.get_element_size = get_item_size;
+
+        arity = 2;
+        check_indexed(&iface);
+
+        arity = 4;
+        check_indexed(&iface);
+
+        iface.get_swap = NULL;
+
+        arity = 2;
+        check_indexed(&iface);
+
+        arity = 8;
+        check_indexed(&iface);
+}
+
+void drain_sorted(pmt_bh_iface_t *iface, my_heap *heap, int count)
+{
+        for(int x = 0; x < count; ++x) {
+                int value = -1;
+                assert(pmt_bh_pop(iface, heap, &value));
+                assert(value == x);
+        }
+        assert(!pmt_bh_pop(iface, heap, NULL));
+}
+
+void check_bulk(pmt_bh_iface_t *iface)
+{
+        my_heap heap;
+        pmt_da_create(&iface->array_iface, &heap, 4);
+
+        int *values = make_deck(0, 1000);
+
+        /* build from a copied array */
+
+        assert(pmt_bh_build(iface, &heap, values, 1000));
+        assert(heap.size == 1000);
+        drain_sorted(iface, &heap, 1000);
+
+        assert(pmt_bh_build(iface, &heap, NULL, 0));
+        assert(pmt_bh_build(iface, &heap, values, 1));
+        assert(heap.size == 1);
+
+        /* nothing to add succeeds on a heap without a buffer */
+
+        my_heap empty;
+        pmt_da_init(&iface->array_iface, &empty, NULL, 0, 0);
+        assert(pmt_bh_build(iface, &empty, NULL, 0));
+        assert(pmt_bh_insert_many(iface, &empty, NULL, 0));
+        assert(!empty.buffer && empty.size == 0);
+
+        /* adopt elements placed in the array directly */
+
+        pmt_da_clear(&iface->array_iface, &heap);
+        assert(pmt_da_append_range(&iface->array_iface, &heap, values, 1000));
+        assert(pmt_bh_heapify(iface, &heap));
+        drain_sorted(iface, &heap, 1000);
+
+        /* a large batch rebuilds, small batches are sifted up */
+
+        assert(pmt_bh_insert_many(iface, &heap, values, 900));
+        for(int x = 900; x < 1000; x += 10) {
+                assert(pmt_bh_insert_many(iface, &heap, values + x, 10));
+        }
+        assert(pmt_bh_insert_many(iface, &heap, NULL, 0));
+        drain_sorted(iface, &heap, 1000);
+
+        /* pushpop and replace_top */
+
+        int out = -1, value = 5;
+
+        pmt_bh_pushpop(iface, &heap, &value, &out);
+        assert(out == 5 && heap.size == 0);
+        assert(!pmt_bh_replace_top(iface, &heap, &value, &out));
+
+        for(int x = 10; x < 20; ++x) {
+                assert(pmt_bh_insert(iface, &heap, &x));
+        }
+
+        value = 3;
+        pmt_bh_pushpop(iface, &heap, &value, &out);
+        assert(out == 3 && heap.size == 10);
+
+        value = 15;
+        pmt_bh_pushpop(iface, &heap, &value, &out);
+        assert(out == 10 && heap.size == 10);
+
+        value = 1;
+        assert(pmt_bh_replace_top(iface, &heap, &value, &out));
+        assert(out == 11 && heap.size == 10);
+        assert(*(int*)pmt_bh_peek(iface, &heap) == 1);
+
+        value = 30;
+        assert(pmt_bh_replace_top(iface, &heap, &value, NULL));
+        assert(*(int*)pmt_bh_peek(iface, &heap) == 12);
+
+        const int expect[] = { 12, 13, 14, 15, 15, 16, 17, 18, 19, 30 };
+        for(int x = 0; x < 10; ++x) {
+                assert(pmt_bh_pop(iface, &heap, &out));
+                assert(out == expect[x]);
+        }
+
+        free(values);
+        pmt_da_destroy(&iface->array_iface, &heap);
+}
+
+void test_bulk()
+{
+        pmt_bh_iface_t iface = my_iface;
+        iface.get_arity = get_arity;
+
+        arity = 2;
+        check_bulk(&iface);
+
+        arity = 4;
+        check_bulk(&iface);
+
+        iface.get_swap = NULL;
+
+        arity = 2;
+        check_bulk(&iface);
+
+        arity = 8;
+        check_bulk(&iface);
+}
+
+void test_indexed_build()
+{
+        pmt_bh_iface_t iface = my_iface;
+        iface.get_less_than = get_item_less_than;
+        iface.get_set_index = get_item_set_index;
+        iface.array_iface.get_element_size = get_item_size;
+
+        my_item items[100];
+        my_item *pointers[100];
+
+        for(int x = 0; x < 100; ++x) {
+                items[x].key = rand() % 50;
+                items[x].index = SIZE_MAX;
+                pointers[x] = items + x;
+        }
+
+        for(int swap = 0; swap < 2; ++swap) {
+
+                iface.get_swap = swap ? get_item_swap : NULL;
+
+                my_heap heap;
+                pmt_da_create(&iface.array_iface, &heap, 4);
+
+                assert(pmt_bh_build(&iface, &heap, pointers, 60));
+                check_indexes(&heap);
+
+                assert(pmt_bh_insert_many(&iface, &heap, pointers + 60, 5));
+                check_indexes(&heap);
+
+                assert(pmt_bh_insert_many(&iface, &heap, pointers + 65, 35));
+                check_indexes(&heap);
+
+                my_item extra = { .key = 25 }, *out = NULL, *in = &extra;
+                assert(pmt_bh_replace_top(&iface, &heap, &in, &out));
+                check_indexes(&heap);
+
+                int prev = -1;
+                while(pmt_bh_pop(&iface, &heap, &out)) {
+                        assert(out->key >= prev);
+                        prev = out->key;
+                        check_indexes(&heap);
+                }
+
+                pmt_da_destroy(&iface.array_iface, &heap);
+        }
+}
+
 int main(int argc, char **args)
 {
         puts("testing - binary_heap.c");
 
         test_insert();
         test_peek_pop();
+        test_arity();
+        test_no_swap();
+        test_indexed();
+        test_bulk();
+        test_indexed_build();
 }
\ No newline at end of file
@@ -95,6 +95,38 @@ pmt_da_iface_t my_iface = {
         .get_element_size = get_element_size
 };
 
+typedef struct my_small_t {
+        size_t capacity, size;
+        int *buffer;
+        int inline_buffer[4];
+} my_small_t;
+
+void *get_inline_buffer(void *array)
+{
+        return ((my_small_t*)array)->inline_buffer;
+}
+
+size_t get_inline_capacity(void *array)
+{
+        return 4;
+}
+
+pmt_da_iface_t my_small_iface = {
+        .get_alloc = get_alloc,
+        .get_realloc = get_realloc,
+        .get_alloc_state = get_alloc_state,
+        .get_free = get_free,
+        .get_buffer = get_buffer,
+        .set_buffer = set_buffer,
+        .get_capacity = get_capacity,
+        .set_capacity = set_capacity,
+        .get_size = get_size,
+        .set_size = set_size,
+        .get_element_size = get_element_size,
+        .get_inline_buffer = get_inline_buffer,
+        .get_inline_capacity = get_inline_capacity
+};
+
 void test_init()
 {
         int buffer[8];
@@ -405,6 +437,132 @@ void test_remove_range()
         pmt_da_destroy(&my_iface, &array);
 }
 
+void iota(void *elements, const size_t nelems, void *state)
+{
+        int *elems = elements, *next = state;
+        for(size_t x = 0; x < nelems; ++x) {
+                elems[x] = (*next)++;
+        }
+}
+
+void test_append_range()
+{
+        my_map_t array;
+        pmt_da_init(&my_iface, &array, NULL, 0, 0);
+
+        /* nothing to append succeeds without a buffer */
+
+        int next = 0;
+        assert(pmt_da_append_range(&my_iface, &array, NULL, 0));
+        assert(!pmt_da_push_back_n(&my_iface, &array, 0));
+        assert(!pmt_da_emplace_back_n(&my_iface, &array, 0, iota, &next));
+        assert(!array.buffer && array.size == 0 && next == 0);
+
+        int elems[5] = { 1, 2, 3, 4, 5 };
+        assert(pmt_da_append_range(&my_iface, &array, elems, 5));
+        assert(array.size == 5);
+        assert(array.capacity == 5);
+        assert(pmt_da_append_range(&my_iface, &array, elems, 5));
+        assert(array.size == 10);
+        assert(array.capacity == 10);
+        for(int x = 0; x < 10; ++x) {
+                assert(array.buffer[x] == x % 5 + 1);
+        }
+
+        assert(pmt_da_insert_range(&my_iface, &array, 10, elems, 2));
+        assert(array.size == 12);
+        assert(array.buffer[10] == 1 && array.buffer[11] == 2);
+
+        /* with a buffer, nothing is pushed at its end */
+
+        assert(pmt_da_push_back_n(&my_iface, &array, 0) == array.buffer + 12);
+        assert(pmt_da_append_range(&my_iface, &array, NULL, 0));
+        assert(array.size == 12);
+
+        pmt_da_destroy(&my_iface, &array);
+}
+
+void test_push_back_n()
+{
+        my_map_t array;
+        (void)pmt_da_create(&my_iface, &array, 4);
+
+        int *elems = pmt_da_push_back_n(&my_iface, &array, 3);
+        assert(elems == array.buffer);
+        for(int x = 0; x < 3; ++x) {
+                elems[x] = x;
+        }
+        elems = pmt_da_push_back_n(&my_iface, &array, 6);
+        assert(elems == array.buffer + 3);
+        assert(array.capacity == 16);
+        assert(array.size == 9);
+        for(int x = 0; x < 3; ++x) {
+                assert(array.buffer[x] == x);
+        }
+
+        pmt_da_destroy(&my_iface, &array);
+}
+
+void test_emplace_back_n()
+{
+        my_map_t array;
+        (void)pmt_da_create(&my_iface, &array, 1);
+
+        int next = 0;
+        assert(pmt_da_emplace_back_n(&my_iface, &array, 5, iota, &next));
+        assert(pmt_da_emplace_back_n(&my_iface, &array, 5, iota, &next));
+        assert(array.size == 10);
+        for(int x = 0; x < 10; ++x) {
+                assert(array.buffer[x] == x);
+        }
+
+        pmt_da_destroy(&my_iface, &array);
+}
+
+void test_inline()
+{
+        my_small_t array;
+        assert(pmt_da_create(&my_small_iface, &array, 2));
+        assert(array.buffer == array.inline_buffer);
+        assert(array.capacity == 4);
+        assert(pmt_da_is_inline(&my_small_iface, &array));
+
+        for(int x = 0; x < 4; ++x) {
+                assert(pmt_da_push_back(&my_small_iface, &array, &x));
+        }
+        assert(array.buffer == array.inline_buffer);
+
+        int value = 4;
+        assert(pmt_da_push_back(&my_small_iface, &array, &value));
+        assert(!pmt_da_is_inline(&my_small_iface, &array));
+        assert(array.capacity == 8);
+        for(int x = 0; x < 5; ++x) {
+                assert(array.buffer[x] == x);
+        }
+
+        assert(pmt_da_shrink_to_fit(&my_small_iface, &array));
+        assert(array.capacity == 5);
+        assert(pmt_da_pop_back(&my_small_iface, &array, NULL));
+        assert(pmt_da_shrink_to_fit(&my_small_iface, &array));
+        assert(array.buffer == array.inline_buffer);
+        assert(array.capacity == 4);
+        for(int x = 0; x < 4; ++x) {
+                assert(array.buffer[x] == x);
+        }
+
+        assert(pmt_da_resize(&my_small_iface, &array, 2) == false);
+        assert(pmt_da_resize(&my_small_iface, &array, 16));
+        assert(!pmt_da_is_inline(&my_small_iface, &array));
+        assert(pmt_da_resize(&my_small_iface, &array, 4));
+        assert(pmt_da_is_inline(&my_small_iface, &array));
+
+        pmt_da_destroy(&my_small_iface, &array);
+
+        assert(pmt_da_create(&my_small_iface, &array, 16));
+        assert(!pmt_da_is_inline(&my_small_iface, &array));
+        pmt_da_destroy(&my_small_iface, &array);
+}
+
 int main(int argc, char **args)
 {
         puts("testing - dynamic_array.c");
@@ -422,4 +580,8 @@ int main(int argc, char **args)
         test_first_last();
         test_insert_range();
         test_remove_range();
+        test_append_range();
+        test_push_back_n();
+        test_emplace_back_n();
+        test_inline();
 }
\ No newline at end of file
@@ -0,0 +1,311 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "pubmt/external_sort.h"
+#include <stdio.h>
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+typedef struct my_array {
+        size_t capacity, size;
+        int *buffer;
+} my_array_t;
+
+void *get_buffer(void *array)
+{
+        return ((my_array_t*)array)->buffer;
+}
+
+void set_buffer(void *array, void *buffer)
+{
+        ((my_array_t*)array)->buffer = buffer;
+}
+
+size_t get_size(void *array)
+{
+        return ((my_array_t*)array)->size;
+}
+
+void set_size(void *array, const size_t size)
+{
+        ((my_array_t*)array)->size = size;
+}
+
+size_t get_capacity(void *array)
+{
+        return ((my_array_t*)array)->capacity;
+}
+
+void set_capacity(void *array, const size_t capacity)
+{
+        ((my_array_t*)array)->capacity = capacity;
+}
+
+size_t get_element_size(void *array)
+{
+        return sizeof(int);
+}
+
+void *my_alloc(const size_t nbytes, void *alloc_state)
+{
+        return malloc(nbytes);
+}
+
+void *my_realloc(void *pointer, const size_t nbytes, void *alloc_state)
+{
+        return realloc(pointer, nbytes);
+}
+
+void my_free(void *pointer, void *alloc_state)
+{
+        free(pointer);
+}
+
+pmt_da_alloc_t get_alloc(void *array)
+{
+        return my_alloc;
+}
+
+pmt_da_realloc_t get_realloc(void *array)
+{
+        return my_realloc;
+}
+
+pmt_da_free_t get_free(void *array)
+{
+        return my_free;
+}
+
+void *get_alloc_state(void *array)
+{
+        return NULL;
+}
+
+pmt_da_iface_t my_iface = {
+        .get_alloc = get_alloc,
+        .get_realloc = get_realloc,
+        .get_alloc_state = get_alloc_state,
+        .get_free = get_free,
+        .get_buffer = get_buffer,
+        .set_buffer = set_buffer,
+        .get_capacity = get_capacity,
+        .set_capacity = set_capacity,
+        .get_size = get_size,
+        .set_size = set_size,
+        .get_element_size = get_element_size
+};
+
+typedef struct my_stream {
+        int *ints;
+        size_t length, offset, chunk;
+} my_stream_t;
+
+bool my_read(void *elements, const size_t nelems, size_t *nread, void *state)
+{
+        my_stream_t *stream = state;
+        size_t n = stream->length - stream->offset;
+        if(n > nelems) {
+                n = nelems;
+        }
+        if(n > stream->chunk) {
+                n = stream->chunk;
+        }
+        memcpy(elements, stream->ints + stream->offset, n * sizeof(int));
+        stream->offset += n;
+        *nread = n;
+        return true;
+}
+
+bool my_write(void *elements, const size_t nelems, void *state)
+{
+        my_stream_t *stream = state;
+        assert(stream->offset + nelems <= stream->length);
+        memcpy(stream->ints + stream->offset, elements, nelems * sizeof(int));
+        stream->offset += nelems;
+        return true;
+}
+
+bool fail_read(void *elements, const size_t nelems, size_t *nread, void *state)
+{
+        return false;
+}
+
+bool int_less_than(void *a, void *b)
+{
+        return *(int*)a < *(int*)b;
+}
+
+int int_cmp(const void *a, const void *b)
+{
+        const int x = *(const int*)a, y = *(const int*)b;
+        return (x > y) - (x < y);
+}
+
+void check_sort(
+        const size_t n, 
+        const size_t budget, 
+        const size_t merge_buffer_size)
+{
+        int *input = malloc(n * sizeof(int) + 1);
+        int *output = malloc(n * sizeof(int) + 1);
+
+        for(size_t x = 0; x < n; ++x) {
+                input[x] = rand() % 100000;
+        }
+
+        my_stream_t in = { .ints = input, .length = n, .chunk = 77 };
+        my_stream_t out = { .ints = output, .length = n };
+
+        pmt_es_config_t config = {
+                .less_than = int_less_than,
+                .read = my_read,
+                .read_state = &in,
+                .write = my_write,
+                .write_state = &out,
+                .merge_buffer_size = merge_buffer_size };
+
+        my_array_t array;
+        assert(pmt_da_create(&my_iface, &array, budget));
+        assert(pmt_es_sort(&my_iface, &array, &config) == PMT_ES_SUCCESS);
+        pmt_da_destroy(&my_iface, &array);
+
+        assert(out.offset == n);
+        qsort(input, n, sizeof(int), int_cmp);
+        assert(!memcmp(input, output, n * sizeof(int)));
+
+        free(input);
+        free(output);
+}
+
+void test_in_memory()
+{
+        check_sort(0, 100, 0);
+        check_sort(50, 100, 0);
+        check_sort(100, 100, 0);
+}
+
+/* Sort with an unusable run directory, so spilling a run fails. */
+int sort_without_disk(const size_t n, const size_t budget)
+{
+        int *input = malloc(n * sizeof(int) + 1);
+        int *output = malloc(n * sizeof(int) + 1);
+
+        for(size_t x = 0; x < n; ++x) {
+                input[x] = rand() % 100000;
+        }
+
+        my_stream_t in = { .ints = input, .length = n, .chunk = 77 };
+        my_stream_t out = { .ints = output, .length = n };
+
+        pmt_es_config_t config = {
+                .less_than = int_less_than,
+                .read = my_read,
+                .read_state = &in,
+                .write = my_write,
+                .write_state = &out,
+                .directory = "/nonexistent/pubmt" };
+
+        my_array_t array;
+        assert(pmt_da_create(&my_iface, &array, budget));
+        const int result = pmt_es_sort(&my_iface, &array, &config);
+        pmt_da_destroy(&my_iface, &array);
+
+        if(result == PMT_ES_SUCCESS) {
+                assert(out.offset == n);
+                qsort(input, n, sizeof(int), int_cmp);
+                assert(!memcmp(input, output, n * sizeof(int)));
+        }
+
+        free(input);
+        free(output);
+
+        return result;
+}
+
+void test_exact_fit()
+{
+        /* an input that exactly fills the array never touches the disk */
+
+        assert(sort_without_disk(100, 100) == PMT_ES_SUCCESS);
+        assert(sort_without_disk(77, 77) == PMT_ES_SUCCESS);
+        assert(sort_without_disk(101, 100) == PMT_ES_IO);
+
+        /* the element read past the full array is not lost */
+
+        check_sort(101, 100, 0);
+        check_sort(201, 100, 0);
+}
+
+void test_single_merge()
+{
+        check_sort(1000, 100, 0);
+        check_sort(10000, 1000, 64);
+}
+
+void test_multi_pass()
+{
+        check_sort(10000, 100, 40);
+        check_sort(20000, 3, 1);
+}
+
+void test_fd()
+{
+        char in_path[] = "/tmp/pubmt-test-XXXXXX";
+        char out_path[] = "/tmp/pubmt-test-XXXXXX";
+        int in_fd = mkstemp(in_path), out_fd = mkstemp(out_path);
+        assert(in_fd >= 0 && out_fd >= 0);
+        unlink(in_path);
+        unlink(out_path);
+
+        const size_t n = 5000;
+        int *ints = malloc(n * sizeof(int));
+        for(size_t x = 0; x < n; ++x) {
+                ints[x] = rand();
+        }
+        assert(write(in_fd, ints, n * sizeof(int)) == n * sizeof(int));
+        assert(lseek(in_fd, 0, SEEK_SET) == 0);
+
+        pmt_es_fd_t in = { .fd = in_fd, .element_size = sizeof(int) };
+        pmt_es_fd_t out = { .fd = out_fd, .element_size = sizeof(int) };
+
+        pmt_es_config_t config = {
+                .less_than = int_less_than,
+                .read = pmt_es_fd_read,
+                .read_state = &in,
+                .write = pmt_es_fd_write,
+                .write_state = &out };
+
+        my_array_t array;
+        assert(pmt_da_create(&my_iface, &array, 512));
+        assert(pmt_es_sort(&my_iface, &array, &config) == PMT_ES_SUCCESS);
+
+        config.read = fail_read;
+        assert(pmt_es_sort(&my_iface, &array, &config) == PMT_ES_READ);
+        pmt_da_destroy(&my_iface, &array);
+
+        int *sorted = malloc(n * sizeof(int));
+        assert(lseek(out_fd, 0, SEEK_SET) == 0);
+        assert(read(out_fd, sorted, n * sizeof(int)) == n * sizeof(int));
+
+        qsort(ints, n, sizeof(int), int_cmp);
+        assert(!memcmp(ints, sorted, n * sizeof(int)));
+
+        close(in_fd);
+        close(out_fd);
+        free(ints);
+        free(sorted);
+}
+
+int main(int argc, char **args)
+{
+        puts("testing - external_sort.c");
+
+        srand(1);
+
+        test_in_memory();
+        test_exact_fit();
+        test_single_merge();
+        test_multi_pass();
+        test_fd();
+}
@@ -0,0 +1,241 @@
+#include "pubmt/gap_buffer.h"
+#include <stdio.h>
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef struct my_buffer {
+        size_t capacity, size, gap;
+        int *buffer;
+} my_buffer_t;
+
+void *get_buffer(void *array)
+{
+        return ((my_buffer_t*)array)->buffer;
+}
+
+void set_buffer(void *array, void *buffer)
+{
+        ((my_buffer_t*)array)->buffer = buffer;
+}
+
+size_t get_size(void *array)
+{
+        return ((my_buffer_t*)array)->size;
+}
+
+void set_size(void *array, const size_t size)
+{
+        ((my_buffer_t*)array)->size = size;
+}
+
+size_t get_capacity(void *array)
+{
+        return ((my_buffer_t*)array)->capacity;
+}
+
+void set_capacity(void *array, const size_t capacity)
+{
+        ((my_buffer_t*)array)->capacity = capacity;
+}
+
+size_t get_gap(void *array)
+{
+        return ((my_buffer_t*)array)->gap;
+}
+
+void set_gap(void *array, const size_t gap)
+{
+        ((my_buffer_t*)array)->gap = gap;
+}
+
+size_t get_element_size(void *array)
+{
+        return sizeof(int);
+}
+
+void *my_alloc(const size_t nbytes, void *alloc_state)
+{
+        return malloc(nbytes);
+}
+
+void *my_realloc(void *pointer, const size_t nbytes, void *alloc_state)
+{
+        return realloc(pointer, nbytes);
+}
+
+void my_free(void *pointer, void *alloc_state)
+{
+        free(pointer);
+}
+
+pmt_da_alloc_t get_alloc(void *array)
+{
+        return my_alloc;
+}
+
+pmt_da_realloc_t get_realloc(void *array)
+{
+        return my_realloc;
+}
+
+pmt_da_free_t get_free(void *array)
+{
+        return my_free;
+}
+
+void *get_alloc_state(void *array)
+{
+        return NULL;
+}
+
+pmt_gb_iface_t my_iface = {
+        .get_gap = get_gap,
+        .set_gap = set_gap,
+        .array_iface = {
+                .get_alloc = get_alloc,
+                .get_realloc = get_realloc,
+                .get_alloc_state = get_alloc_state,
+                .get_free = get_free,
+                .get_buffer = get_buffer,
+                .set_buffer = set_buffer,
+                .get_capacity = get_capacity,
+                .set_capacity = set_capacity,
+                .get_size = get_size,
+                .set_size = set_size,
+                .get_element_size = get_element_size
+        }
+};
+
+bool match(my_buffer_t *buffer, int *nums, const size_t nnums)
+{
+        if(pmt_gb_size(&my_iface, buffer) != nnums) {
+                return false;
+        }
+        for(size_t x = 0; x < nnums; ++x) {
+                if(*(int*)pmt_gb_at(&my_iface, buffer, x) != nums[x]) {
+                        return false;
+                }
+        }
+        return true;
+}
+
+void test_create_destroy()
+{
+        my_buffer_t buffer;
+        assert(pmt_gb_create(&my_iface, &buffer, 4));
+        assert(buffer.capacity == 4);
+        assert(buffer.size == 0);
+        assert(buffer.gap == 0);
+        assert(!pmt_gb_at(&my_iface, &buffer, 0));
+        pmt_gb_destroy(&my_iface, &buffer);
+}
+
+void test_insert()
+{
+        my_buffer_t buffer;
+        assert(pmt_gb_create(&my_iface, &buffer, 2));
+
+        assert(pmt_gb_insert(&my_iface, &buffer, 0, (int[]){ 1, 5 }, 2));
+        assert(match(&buffer, (int[]){ 1, 5 }, 2));
+        assert(pmt_gb_insert(&my_iface, &buffer, 1, (int[]){ 2 }, 1));
+        assert(pmt_gb_insert(&my_iface, &buffer, 2, (int[]){ 3, 4 }, 2));
+        assert(match(&buffer, (int[]){ 1, 2, 3, 4, 5 }, 5));
+        assert(buffer.gap == 4);
+        assert(buffer.capacity == 8);
+        assert(pmt_gb_insert(&my_iface, &buffer, 0, (int[]){ 0 }, 1));
+        assert(pmt_gb_insert(&my_iface, &buffer, 6, (int[]){ 6 }, 1));
+        assert(match(&buffer, (int[]){ 0, 1, 2, 3, 4, 5, 6 }, 7));
+        assert(!pmt_gb_insert(&my_iface, &buffer, 8, (int[]){ 8 }, 1));
+
+        pmt_gb_destroy(&my_iface, &buffer);
+}
+
+void test_remove()
+{
+        my_buffer_t buffer;
+        assert(pmt_gb_create(&my_iface, &buffer, 8));
+
+        assert(pmt_gb_insert(
+                &my_iface, &buffer, 0, (int[]){ 0, 1, 2, 3, 4, 5 }, 6));
+        assert(pmt_gb_remove(&my_iface, &buffer, 1, 2));
+        assert(match(&buffer, (int[]){ 0, 3, 4, 5 }, 4));
+        assert(pmt_gb_remove(&my_iface, &buffer, 3, 1));
+        assert(match(&buffer, (int[]){ 0, 3, 4 }, 3));
+        assert(!pmt_gb_remove(&my_iface, &buffer, 2, 2));
+        assert(pmt_gb_remove(&my_iface, &buffer, 0, 1));
+        assert(match(&buffer, (int[]){ 3, 4 }, 2));
+
+        pmt_gb_destroy(&my_iface, &buffer);
+}
+
+void test_span()
+{
+        my_buffer_t buffer;
+        assert(pmt_gb_create(&my_iface, &buffer, 8));
+
+        assert(pmt_gb_insert(
+                &my_iface, &buffer, 0, (int[]){ 0, 1, 2, 3, 4, 5 }, 6));
+        assert(pmt_gb_move_gap(&my_iface, &buffer, 2));
+
+        int *span = pmt_gb_span(&my_iface, &buffer, 1, 4);
+        assert(span);
+        for(int x = 0; x < 4; ++x) {
+                assert(span[x] == x + 1);
+        }
+
+        span = pmt_gb_span(&my_iface, &buffer, 0, 6);
+        for(int x = 0; x < 6; ++x) {
+                assert(span[x] == x);
+        }
+
+        assert(!pmt_gb_span(&my_iface, &buffer, 4, 3));
+
+        pmt_gb_destroy(&my_iface, &buffer);
+}
+
+void test_random()
+{
+        my_buffer_t buffer;
+        assert(pmt_gb_create(&my_iface, &buffer, 1));
+
+        int model[512];
+        size_t size = 0;
+
+        srand(7);
+
+        for(int x = 0; x < 4096; ++x) {
+                const size_t index = (size_t)rand() % (size + 1);
+                if(size < 500 && (rand() % 3 || !size)) {
+                        int value = rand();
+                        assert(pmt_gb_insert(
+                                &my_iface, &buffer, index, &value, 1));
+                        memmove(model + index + 1, model + index, 
+                                (size - index) * sizeof(int));
+                        model[index] = value;
+                        ++size;
+                } else if(index < size) {
+                        assert(pmt_gb_remove(&my_iface, &buffer, index, 1));
+                        memmove(model + index, model + index + 1, 
+                                (size - index - 1) * sizeof(int));
+                        --size;
+                }
+                assert(match(&buffer, model, size));
+        }
+
+        int *span = pmt_gb_span(&my_iface, &buffer, 0, size);
+        assert(memcmp(span, model, size * sizeof(int)) == 0);
+
+        pmt_gb_destroy(&my_iface, &buffer);
+}
+
+int main(int argc, char **args)
+{
+        puts("testing - gap_buffer.c");
+
+        test_create_destroy();
+        test_insert();
+        test_remove();
+        test_span();
+        test_random();
+}
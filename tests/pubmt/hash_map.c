@@ -323,6 +323,67 @@ void test_iterator()
         pmt_hm_destroy(&my_iface, &map);
 }
 
+#define MY_INLINE 16
+
+typedef struct my_small_map {
+
+        size_t capacity, size;
+
+        void **buffer;
+
+        void *inline_buffer[MY_INLINE];
+
+} my_small_map_t;
+
+void *get_inline_buffer(void *map)
+{
+        return ((my_small_map_t*)map)->inline_buffer;
+}
+
+size_t get_inline_capacity(void *map)
+{
+        return MY_INLINE;
+}
+
+void test_inline()
+{
+        pmt_hm_iface_t small_iface = my_iface;
+        small_iface.array_iface.get_inline_buffer = get_inline_buffer;
+        small_iface.array_iface.get_inline_capacity = get_inline_capacity;
+
+        my_small_map_t map;
+
+        /* garbage in the inline buckets past the requested capacity */
+
+        for(int x = 0; x < MY_INLINE; ++x) {
+                map.inline_buffer[x] = (void*)&map;
+        }
+
+        assert(pmt_hm_create(&small_iface, &map, 4));
+        assert(map.capacity == MY_INLINE);
+
+        for(int x = 0; x < MY_INLINE; ++x) {
+                assert(map.buffer[x] == NULL);
+        }
+
+        my_node_t nodes[100];
+
+        for(int x = 0; x < 100; ++x) {
+                nodes[x].key = x;
+                nodes[x].next = NULL;
+                assert(pmt_hm_insert(&small_iface, &map, nodes + x) ==
+                        PMT_HM_SUCCESS);
+        }
+
+        assert(map.capacity > MY_INLINE);
+
+        for(int x = 0; x < 100; ++x) {
+                assert(pmt_hm_lookup(&small_iface, &map, &x) == nodes + x);
+        }
+
+        pmt_hm_destroy(&small_iface, &map);
+}
+
 int main(int argc, char **args) 
 {
         puts("testing - hash_map.c");
@@ -332,4 +393,5 @@ int main(int argc, char **args)
         test_resize();
         test_remove();
         test_iterator();
+        test_inline();
 }
\ No newline at end of file
@@ -0,0 +1,404 @@
+#include "pubmt/merge_cursor.h"
+#include <stdio.h>
+#include <assert.h>
+#include <stdlib.h>
+#include <stdint.h>
+
+typedef struct my_item {
+        int key, run;
+} my_item_t;
+
+typedef struct my_array {
+        size_t capacity, size;
+        my_item_t *buffer;
+} my_array_t;
+
+void *get_buffer(void *array)
+{
+        return ((my_array_t*)array)->buffer;
+}
+
+void set_buffer(void *array, void *buffer)
+{
+        ((my_array_t*)array)->buffer = buffer;
+}
+
+size_t get_size(void *array)
+{
+        return ((my_array_t*)array)->size;
+}
+
+void set_size(void *array, const size_t size)
+{
+        ((my_array_t*)array)->size = size;
+}
+
+size_t get_capacity(void *array)
+{
+        return ((my_array_t*)array)->capacity;
+}
+
+void set_capacity(void *array, const size_t capacity)
+{
+        ((my_array_t*)array)->capacity = capacity;
+}
+
+size_t get_element_size(void *array)
+{
+        return sizeof(my_item_t);
+}
+
+void *my_alloc(const size_t nbytes, void *alloc_state)
+{
+        return malloc(nbytes);
+}
+
+void *my_realloc(void *pointer, const size_t nbytes, void *alloc_state)
+{
+        return realloc(pointer, nbytes);
+}
+
+void my_free(void *pointer, void *alloc_state)
+{
+        free(pointer);
+}
+
+pmt_da_alloc_t get_alloc(void *array)
+{
+        return my_alloc;
+}
+
+pmt_da_realloc_t get_realloc(void *array)
+{
+        return my_realloc;
+}
+
+pmt_da_free_t get_free(void *array)
+{
+        return my_free;
+}
+
+void *get_alloc_state(void *array)
+{
+        return NULL;
+}
+
+pmt_da_iface_t my_iface = {
+        .get_alloc = get_alloc,
+        .get_realloc = get_realloc,
+        .get_alloc_state = get_alloc_state,
+        .get_free = get_free,
+        .get_buffer = get_buffer,
+        .set_buffer = set_buffer,
+        .get_capacity = get_capacity,
+        .set_capacity = set_capacity,
+        .get_size = get_size,
+        .set_size = set_size,
+        .get_element_size = get_element_size
+};
+
+bool my_less_than(void *a, void *b)
+{
+        return ((my_item_t*)a)->key < ((my_item_t*)b)->key;
+}
+
+pmt_mc_cursor_t *my_create(
+        pmt_mc_cursor_t *cursor,
+        const size_t max_runs,
+        const size_t batch)
+{
+        return pmt_mc_create(
+                cursor,
+                max_runs,
+                sizeof(my_item_t),
+                batch,
+                my_less_than,
+                my_alloc,
+                my_realloc,
+                my_free,
+                NULL);
+}
+
+#define MY_RUNS 7
+
+/* Fill sorted runs of random lengths with small keys, so many are equal. */
+size_t my_fill(my_array_t *arrays)
+{
+        size_t total = 0;
+
+        for(int r = 0; r < MY_RUNS; ++r) {
+
+                my_array_t *array = arrays + r;
+                assert(pmt_da_create(&my_iface, array, 1));
+
+                /* one run stays empty */
+
+                const int length = r == 3 ? 0 : rand() % 500;
+
+                int key = 0;
+
+                for(int x = 0; x < length; ++x) {
+                        key += rand() % 3;
+                        my_item_t item = { .key = key, .run = r };
+                        assert(pmt_da_push_back(&my_iface, array, &item));
+                }
+
+                total += (size_t)length;
+        }
+
+        return total;
+}
+
+void my_destroy(my_array_t *arrays)
+{
+        for(int r = 0; r < MY_RUNS; ++r) {
+                pmt_da_destroy(&my_iface, arrays + r);
+        }
+}
+
+/* Drain with pmt_mc_next, checking the order and the stability. */
+size_t my_drain(pmt_mc_cursor_t *cursor)
+{
+        my_item_t item, last = { .key = -1, .run = -1 };
+
+        size_t count = 0;
+
+        while(pmt_mc_peek(cursor)) {
+                const my_item_t peeked = *(my_item_t*)pmt_mc_peek(cursor);
+                assert(pmt_mc_next(cursor, &item));
+                assert(peeked.key == item.key && peeked.run == item.run);
+                assert(last.key < item.key ||
+                        (last.key == item.key && last.run <= item.run));
+                last = item;
+                ++count;
+        }
+
+        assert(!pmt_mc_next(cursor, &item));
+        assert(!pmt_mc_failed(cursor));
+
+        return count;
+}
+
+void test_arrays()
+{
+        my_array_t arrays[MY_RUNS];
+
+        const size_t total = my_fill(arrays);
+
+        pmt_mc_cursor_t cursor;
+        assert(my_create(&cursor, MY_RUNS, 1));
+
+        for(int r = 0; r < MY_RUNS; ++r) {
+                pmt_mc_add_array(&cursor, &my_iface, arrays + r);
+        }
+
+        assert(my_drain(&cursor) == total);
+
+        pmt_mc_destroy(&cursor);
+        my_destroy(arrays);
+
+        /* no runs at all */
+
+        assert(my_create(&cursor, 1, 1));
+        assert(!pmt_mc_peek(&cursor));
+        assert(!pmt_mc_next(&cursor, NULL));
+        pmt_mc_destroy(&cursor);
+}
+
+/* Pull state over an array, optionally failing after some pulls. */
+typedef struct my_source {
+        my_array_t *array;
+        size_t offset;
+        int pulls, fail_at;
+} my_source_t;
+
+bool my_pull(void *elements, const size_t nelems, size_t *nread, void *state)
+{
+        my_source_t *source = state;
+
+        if(++source->pulls == source->fail_at) {
+                return false;
+        }
+
+        size_t n = source->array->size - source->offset;
+
+        if(n > nelems) {
+                n = nelems;
+        }
+
+        for(size_t x = 0; x < n; ++x) {
+                ((my_item_t*)elements)[x] =
+                        source->array->buffer[source->offset + x];
+        }
+
+        source->offset += n;
+        *nread = n;
+
+        return true;
+}
+
+/*
+ * Drain a cursor whose longest run fails on its fifth pull of 4 elements.
+ * Every element taken before the failure must reach the caller: the first 16
+ * elements of the failing run, and a gapless prefix of every other run.
+ */
+void my_check_failure(
+        pmt_mc_cursor_t *cursor,
+        my_array_t *arrays,
+        const int longest)
+{
+        size_t seen[MY_RUNS] = { 0 };
+
+        my_item_t item;
+
+        while(pmt_mc_next(cursor, &item)) {
+                const size_t r = (size_t)item.run;
+                assert(seen[r] < arrays[r].size);
+                assert(arrays[r].buffer[seen[r]].key == item.key);
+                ++seen[r];
+        }
+
+        assert(pmt_mc_failed(cursor));
+        assert(!pmt_mc_next(cursor, &item));
+        assert(seen[longest] == 16);
+}
+
+void test_pull()
+{
+        my_array_t arrays[MY_RUNS];
+        my_source_t sources[MY_RUNS];
+
+        const size_t total = my_fill(arrays);
+
+        pmt_mc_cursor_t cursor;
+        assert(my_create(&cursor, MY_RUNS, 16));
+
+        /* mix array and pulled runs */
+
+        for(int r = 0; r < MY_RUNS; ++r) {
+                if(r % 2) {
+                        pmt_mc_add_array(&cursor, &my_iface, arrays + r);
+                        continue;
+                }
+                sources[r] = (my_source_t){ .array = arrays + r };
+                assert(pmt_mc_add_pull(&cursor, my_pull, sources + r));
+        }
+
+        assert(my_drain(&cursor) == total);
+
+        pmt_mc_destroy(&cursor);
+
+        /* a failing pull of the longest run stops the merge */
+
+        int longest = 0;
+
+        for(int r = 1; r < MY_RUNS; ++r) {
+                if(arrays[r].size > arrays[longest].size) {
+                        longest = r;
+                }
+        }
+
+        assert(arrays[longest].size > 16);
+        assert(my_create(&cursor, MY_RUNS, 4));
+
+        for(int r = 0; r < MY_RUNS; ++r) {
+                sources[r] = (my_source_t){ .array = arrays + r };
+                sources[r].fail_at = r == longest ? 5 : 0;
+                assert(pmt_mc_add_pull(&cursor, my_pull, sources + r));
+        }
+
+        my_check_failure(&cursor, arrays, longest);
+
+        pmt_mc_destroy(&cursor);
+
+        /* the same through a cursor pulling from a cursor */
+
+        pmt_mc_cursor_t inner;
+
+        assert(my_create(&inner, MY_RUNS, 4));
+        assert(my_create(&cursor, 1, 8));
+
+        for(int r = 0; r < MY_RUNS; ++r) {
+                sources[r] = (my_source_t){ .array = arrays + r };
+                sources[r].fail_at = r == longest ? 5 : 0;
+                assert(pmt_mc_add_pull(&inner, my_pull, sources + r));
+        }
+
+        assert(pmt_mc_add_pull(&cursor, pmt_mc_read, &inner));
+
+        my_check_failure(&cursor, arrays, longest);
+
+        pmt_mc_destroy(&cursor);
+        pmt_mc_destroy(&inner);
+
+        /* a run failing its first pull is not added */
+
+        assert(my_create(&cursor, 2, 4));
+
+        sources[0] = (my_source_t){ .array = arrays + longest, .fail_at = 1 };
+        assert(!pmt_mc_add_pull(&cursor, my_pull, sources));
+        assert(!pmt_mc_failed(&cursor));
+
+        sources[0] = (my_source_t){ .array = arrays + longest };
+        assert(pmt_mc_add_pull(&cursor, my_pull, sources));
+        assert(my_drain(&cursor) == arrays[longest].size);
+
+        pmt_mc_destroy(&cursor);
+        my_destroy(arrays);
+}
+
+void test_read()
+{
+        my_array_t arrays[MY_RUNS];
+
+        const size_t total = my_fill(arrays);
+
+        /* two levels: the inner cursors are pulled by the outer cursor */
+
+        pmt_mc_cursor_t inner[2], outer;
+
+        assert(my_create(inner, MY_RUNS, 8));
+        assert(my_create(inner + 1, MY_RUNS, 8));
+        assert(my_create(&outer, 2, 32));
+
+        for(int r = 0; r < MY_RUNS; ++r) {
+                pmt_mc_cursor_t *half = inner + (r < 4 ? 0 : 1);
+                pmt_mc_add_array(half, &my_iface, arrays + r);
+        }
+
+        assert(pmt_mc_add_pull(&outer, pmt_mc_read, inner));
+        assert(pmt_mc_add_pull(&outer, pmt_mc_read, inner + 1));
+
+        my_item_t items[100], last = { .key = -1, .run = -1 };
+
+        size_t count = 0, nread = 0;
+
+        do {
+                const size_t want = (size_t)(1 + rand() % 100);
+                assert(pmt_mc_read(items, want, &nread, &outer));
+                assert(nread <= want);
+                for(size_t x = 0; x < nread; ++x) {
+                        assert(last.key < items[x].key ||
+                                (last.key == items[x].key &&
+                                last.run <= items[x].run));
+                        last = items[x];
+                }
+                count += nread;
+        } while(nread);
+
+        assert(count == total);
+
+        pmt_mc_destroy(&outer);
+        pmt_mc_destroy(inner);
+        pmt_mc_destroy(inner + 1);
+        my_destroy(arrays);
+}
+
+int main(int argc, char **args)
+{
+        puts("testing - merge_cursor.c");
+
+        test_arrays();
+        test_pull();
+        test_read();
+}
@@ -0,0 +1,245 @@
+#include "pubmt/min_max_heap.h"
+#include <stdio.h>
+#include <string.h>
+#include <assert.h>
+
+typedef struct my_heap {
+        
+        size_t size, capacity;
+        int *buffer;
+
+} my_heap;
+
+void swap(void *elem_a, void *elem_b) 
+{
+        int     *a = elem_a,
+                *b = elem_b,
+                tmp = *a;
+        *a = *b;
+        *b = tmp;
+}
+
+pmt_bh_swap_t get_swap(void *heap)
+{
+        return swap;
+}
+
+bool less_than(void *elem_a, void *elem_b) 
+{
+        return *((int*)elem_a) < *((int*)elem_b);
+}
+
+pmt_bh_less_than_t get_less_than(void *heap)
+{
+        return less_than;
+}
+
+void *get_buffer(void *array)
+{
+        return ((my_heap*)array)->buffer;
+}
+
+void set_buffer(void *array, void *buffer)
+{
+        ((my_heap*)array)->buffer = buffer;
+}
+
+size_t get_size(void *array)
+{
+        return ((my_heap*)array)->size;
+}
+
+void set_size(void *array, const size_t size)
+{
+        ((my_heap*)array)->size = size;
+}
+
+size_t get_capacity(void *array)
+{
+        return ((my_heap*)array)->capacity;
+}
+
+void set_capacity(void *array, const size_t capacity)
+{
+        ((my_heap*)array)->capacity = capacity;
+}
+
+size_t get_element_size(void *array)
+{
+        return sizeof(int);
+}
+
+void *my_alloc(const size_t nbytes, void *alloc_state)
+{
+        return malloc(nbytes);
+}
+
+void *my_realloc(void *pointer, const size_t nbytes, void *alloc_state)
+{
+        return realloc(pointer, nbytes);
+}
+
+void my_free(void *pointer, void *alloc_state)
+{
+        free(pointer);
+}
+
+pmt_da_alloc_t get_alloc(void *array)
+{
+        return my_alloc;
+}
+pmt_da_realloc_t get_realloc(void *array)
+{
+        return my_realloc;
+}
+
+pmt_da_free_t get_free(void *array)
+{
+        return my_free;
+}
+
+void *get_alloc_state(void *array)
+{
+        return NULL;
+}
+
+pmt_bh_iface_t my_iface = {
+        .get_swap = get_swap,
+        .get_less_than = get_less_than,
+        .array_iface = {
+                .get_alloc = get_alloc,
+                .get_realloc = get_realloc,
+                .get_alloc_state = get_alloc_state,
+                .get_free = get_free,
+                .get_buffer = get_buffer,
+                .set_buffer = set_buffer,
+                .get_capacity = get_capacity,
+                .set_capacity = set_capacity,
+                .get_size = get_size,
+                .set_size = set_size,
+                .get_element_size = get_element_size
+        }
+};
+
+int int_cmp(const void *a, const void *b)
+{
+        const int x = *(const int*)a, y = *(const int*)b;
+        return (x > y) - (x < y);
+}
+
+/* Check the heap against a sorted copy of its contents. */
+void check_ends(pmt_bh_iface_t *iface, my_heap *heap)
+{
+        if(!heap->size) {
+                assert(!pmt_mmh_peek_min(iface, heap));
+                assert(!pmt_mmh_peek_max(iface, heap));
+                return;
+        }
+
+        int *sorted = malloc(heap->size * sizeof(int));
+        memcpy(sorted, heap->buffer, heap->size * sizeof(int));
+        qsort(sorted, heap->size, sizeof(int), int_cmp);
+
+        assert(*(int*)pmt_mmh_peek_min(iface, heap) == sorted[0]);
+        assert(*(int*)pmt_mmh_peek_max(iface, heap) == sorted[heap->size - 1]);
+
+        free(sorted);
+}
+
+void check_random(pmt_bh_iface_t *iface)
+{
+        my_heap heap;
+        pmt_da_create(&iface->array_iface, &heap, 4);
+
+        assert(!pmt_mmh_pop_min(iface, &heap, NULL));
+        assert(!pmt_mmh_pop_max(iface, &heap, NULL));
+        check_ends(iface, &heap);
+
+        for(int x = 0; x < 5000; ++x) {
+
+                const int op = rand() % 4;
+
+                if(op < 2) {
+                        int value = rand() % 1000;
+                        int *pointer = pmt_mmh_insert(iface, &heap, &value);
+                        assert(pointer && *pointer == value);
+                } else {
+                        int *min = pmt_mmh_peek_min(iface, &heap);
+                        int *max = pmt_mmh_peek_max(iface, &heap);
+                        int expect = op == 2 ? 
+                                (min ? *min : -1) : 
+                                (max ? *max : -1);
+                        int value = -1;
+                        bool popped = op == 2 ?
+                                pmt_mmh_pop_min(iface, &heap, &value) :
+                                pmt_mmh_pop_max(iface, &heap, &value);
+                        assert(popped == (min != NULL));
+                        assert(value == expect);
+                }
+
+                check_ends(iface, &heap);
+        }
+
+        /* drain from both ends */
+
+        int low = -1, high = 1000000;
+
+        while(heap.size) {
+                int value = -1;
+                if(heap.size % 2) {
+                        assert(pmt_mmh_pop_min(iface, &heap, &value));
+                        assert(value >= low);
+                        low = value;
+                } else {
+                        assert(pmt_mmh_pop_max(iface, &heap, &value));
+                        assert(value <= high);
+                        high = value;
+                }
+                assert(low <= high);
+        }
+
+        pmt_da_destroy(&iface->array_iface, &heap);
+}
+
+void test_min_max()
+{
+        pmt_bh_iface_t iface = my_iface;
+
+        check_random(&iface);
+
+        iface.get_swap = NULL;
+
+        check_random(&iface);
+}
+
+void test_sorted_input()
+{
+        my_heap heap;
+        pmt_da_create(&my_iface.array_iface, &heap, 4);
+
+        for(int x = 0; x < 100; ++x) {
+                assert(pmt_mmh_insert(&my_iface, &heap, &x));
+        }
+
+        for(int x = 99; x >= 50; --x) {
+                int value = -1;
+                assert(pmt_mmh_pop_max(&my_iface, &heap, &value));
+                assert(value == x);
+        }
+
+        for(int x = 0; x < 50; ++x) {
+                int value = -1;
+                assert(pmt_mmh_pop_min(&my_iface, &heap, &value));
+                assert(value == x);
+        }
+
+        pmt_da_destroy(&my_iface.array_iface, &heap);
+}
+
+int main(int argc, char **args)
+{
+        puts("testing - min_max_heap.c");
+
+        test_min_max();
+        test_sorted_input();
+}
@@ -0,0 +1,157 @@
+#include "pubmt/mpmc_queue.h"
+#include <stdio.h>
+#include <assert.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <pthread.h>
+
+void *my_alloc(const size_t nbytes, void *alloc_state)
+{
+        return malloc(nbytes);
+}
+
+void my_free(void *pointer, void *alloc_state)
+{
+        free(pointer);
+}
+
+void test_create_destroy()
+{
+        pmt_mpmc_queue_t queue;
+        assert(pmt_mpmc_create(&queue, 8, sizeof(int), my_alloc, my_free, NULL));
+        assert(pmt_mpmc_capacity(&queue) == 8);
+        assert(pmt_mpmc_size(&queue) == 0);
+        assert(!pmt_mpmc_try_dequeue(&queue, NULL));
+        pmt_mpmc_destroy(&queue);
+}
+
+void test_try()
+{
+        pmt_mpmc_queue_t queue;
+        assert(pmt_mpmc_create(&queue, 4, sizeof(int), my_alloc, my_free, NULL));
+
+        int value = 0;
+
+        for(int round = 0; round < 10; ++round) {
+                for(int x = 0; x < 4; ++x) {
+                        assert(pmt_mpmc_try_enqueue(&queue, &x));
+                }
+                assert(!pmt_mpmc_try_enqueue(&queue, &value));
+                assert(pmt_mpmc_size(&queue) == 4);
+                for(int x = 0; x < 3; ++x) {
+                        assert(pmt_mpmc_try_dequeue(&queue, &value));
+                        assert(value == x);
+                }
+                int x = 4;
+                pmt_mpmc_enqueue(&queue, &x);
+                pmt_mpmc_dequeue(&queue, &value);
+                assert(value == 3);
+                pmt_mpmc_dequeue(&queue, &value);
+                assert(value == 4);
+                assert(!pmt_mpmc_try_dequeue(&queue, &value));
+        }
+
+        pmt_mpmc_destroy(&queue);
+}
+
+typedef struct my_wide {
+        uint64_t value;
+        char pad[13];
+} my_wide_t;
+
+void test_element_size()
+{
+        pmt_mpmc_queue_t queue;
+        assert(pmt_mpmc_create(
+                &queue, 4, sizeof(my_wide_t), my_alloc, my_free, NULL));
+
+        my_wide_t wide = { 0 };
+
+        for(uint64_t x = 0; x < 20; ++x) {
+                wide.value = x * 7;
+                assert(pmt_mpmc_try_enqueue(&queue, &wide));
+                assert(pmt_mpmc_try_dequeue(&queue, &wide));
+                assert(wide.value == x * 7);
+        }
+
+        pmt_mpmc_destroy(&queue);
+}
+
+#define MY_THREADS 4
+#define MY_COUNT 100000
+
+pmt_mpmc_queue_t my_queue;
+unsigned char my_seen[MY_THREADS * MY_COUNT];
+
+void *my_producer(void *arg)
+{
+        const uint32_t base = (uint32_t)(uintptr_t)arg * MY_COUNT;
+
+        for(uint32_t x = 0; x < MY_COUNT; ++x) {
+                const uint32_t value = base + x;
+                pmt_mpmc_enqueue(&my_queue, &value);
+        }
+
+        return NULL;
+}
+
+void *my_consumer(void *arg)
+{
+        uint32_t last[MY_THREADS];
+
+        for(int x = 0; x < MY_THREADS; ++x) {
+                last[x] = UINT32_MAX;
+        }
+
+        for(uint32_t x = 0; x < MY_COUNT; ++x) {
+                uint32_t value;
+                pmt_mpmc_dequeue(&my_queue, &value);
+
+                /* each producer's elements arrive in order */
+
+                const uint32_t producer = value / MY_COUNT;
+                assert(last[producer] == UINT32_MAX || last[producer] < value);
+                last[producer] = value;
+                my_seen[value] = 1;
+        }
+
+        return NULL;
+}
+
+void test_threads()
+{
+        assert(pmt_mpmc_create(
+                &my_queue, 64, sizeof(uint32_t), my_alloc, my_free, NULL));
+
+        pthread_t producers[MY_THREADS], consumers[MY_THREADS];
+
+        for(uintptr_t x = 0; x < MY_THREADS; ++x) {
+                assert(!pthread_create(
+                        consumers + x, NULL, my_consumer, NULL));
+                assert(!pthread_create(
+                        producers + x, NULL, my_producer, (void*)x));
+        }
+
+        for(int x = 0; x < MY_THREADS; ++x) {
+                assert(!pthread_join(producers[x], NULL));
+                assert(!pthread_join(consumers[x], NULL));
+        }
+
+        for(size_t x = 0; x < MY_THREADS * MY_COUNT; ++x) {
+                assert(my_seen[x]);
+        }
+
+        assert(pmt_mpmc_size(&my_queue) == 0);
+
+        pmt_mpmc_destroy(&my_queue);
+}
+
+int main(int argc, char **args)
+{
+        puts("testing - mpmc_queue.c");
+
+        test_create_destroy();
+        test_try();
+        test_element_size();
+        test_threads();
+}
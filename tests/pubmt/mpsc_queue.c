@@ -0,0 +1,140 @@
+#include "pubmt/mpsc_queue.h"
+#include <stdio.h>
+#include <assert.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <pthread.h>
+
+typedef struct my_node {
+        uint32_t value;
+        _Atomic(void*) next;
+} my_node_t;
+
+/* ThreadSanitizer does not model fences, so acquire and release here. */
+
+void *get_next(void *node)
+{
+        return atomic_load_explicit(
+                &((my_node_t*)node)->next,
+                memory_order_acquire);
+}
+
+void set_next(void *node, void *next)
+{
+        atomic_store_explicit(
+                &((my_node_t*)node)->next,
+                next,
+                memory_order_release);
+}
+
+pmt_ll_node_iface_t my_node_iface = {
+        .get_next = get_next,
+        .set_next = set_next
+};
+
+void test_empty()
+{
+        pmt_mpsc_queue_t queue;
+        my_node_t stub;
+
+        assert(pmt_mpsc_init(&my_node_iface, &queue, &stub) == &queue);
+        assert(pmt_mpsc_is_empty(&my_node_iface, &queue));
+        assert(!pmt_mpsc_pop(&my_node_iface, &queue));
+}
+
+void test_push_pop()
+{
+        pmt_mpsc_queue_t queue;
+        my_node_t stub, nodes[10];
+
+        pmt_mpsc_init(&my_node_iface, &queue, &stub);
+
+        for(uint32_t round = 0; round < 3; ++round) {
+                for(uint32_t x = 0; x < 10; ++x) {
+                        nodes[x].value = x + round;
+                        pmt_mpsc_push(&my_node_iface, &queue, nodes + x);
+                        assert(!pmt_mpsc_is_empty(&my_node_iface, &queue));
+                }
+                for(uint32_t x = 0; x < 10; ++x) {
+                        my_node_t *node = pmt_mpsc_pop(&my_node_iface, &queue);
+                        assert(node == nodes + x);
+                        assert(node->value == x + round);
+                }
+                assert(pmt_mpsc_is_empty(&my_node_iface, &queue));
+                assert(!pmt_mpsc_pop(&my_node_iface, &queue));
+        }
+
+        /* interleaved, the stub is cycled through the queue */
+
+        for(uint32_t x = 0; x < 10; ++x) {
+                pmt_mpsc_push(&my_node_iface, &queue, nodes + x);
+                assert(pmt_mpsc_pop(&my_node_iface, &queue) == nodes + x);
+                assert(!pmt_mpsc_pop(&my_node_iface, &queue));
+        }
+}
+
+#define MY_THREADS 4
+#define MY_COUNT 100000
+
+pmt_mpsc_queue_t my_queue;
+my_node_t my_stub;
+my_node_t *my_nodes;
+
+void *my_producer(void *arg)
+{
+        const uint32_t base = (uint32_t)(uintptr_t)arg * MY_COUNT;
+
+        for(uint32_t x = 0; x < MY_COUNT; ++x) {
+                my_node_t *node = my_nodes + base + x;
+                node->value = base + x;
+                pmt_mpsc_push(&my_node_iface, &my_queue, node);
+        }
+
+        return NULL;
+}
+
+void test_threads()
+{
+        my_nodes = malloc(MY_THREADS * MY_COUNT * sizeof(my_node_t));
+        assert(my_nodes);
+
+        pmt_mpsc_init(&my_node_iface, &my_queue, &my_stub);
+
+        pthread_t producers[MY_THREADS];
+
+        for(uintptr_t x = 0; x < MY_THREADS; ++x) {
+                assert(!pthread_create(
+                        producers + x, NULL, my_producer, (void*)x));
+        }
+
+        uint32_t next[MY_THREADS] = { 0 };
+
+        for(size_t count = 0; count < MY_THREADS * MY_COUNT;) {
+                my_node_t *node = pmt_mpsc_pop(&my_node_iface, &my_queue);
+                if(!node) {
+                        continue;
+                }
+                const uint32_t producer = node->value / MY_COUNT;
+                assert(node == my_nodes + node->value);
+                assert(node->value % MY_COUNT == next[producer]++);
+                ++count;
+        }
+
+        for(int x = 0; x < MY_THREADS; ++x) {
+                assert(!pthread_join(producers[x], NULL));
+        }
+
+        assert(!pmt_mpsc_pop(&my_node_iface, &my_queue));
+        assert(pmt_mpsc_is_empty(&my_node_iface, &my_queue));
+
+        free(my_nodes);
+}
+
+int main(int argc, char **args)
+{
+        puts("testing - mpsc_queue.c");
+
+        test_empty();
+        test_push_pop();
+        test_threads();
+}
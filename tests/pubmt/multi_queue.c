@@ -0,0 +1,164 @@
+#include "pubmt/multi_queue.h"
+#include <stdio.h>
+#include <assert.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <pthread.h>
+
+void *my_alloc(const size_t nbytes, void *alloc_state)
+{
+        return malloc(nbytes);
+}
+
+void *my_realloc(void *pointer, const size_t nbytes, void *alloc_state)
+{
+        return realloc(pointer, nbytes);
+}
+
+void my_free(void *pointer, void *alloc_state)
+{
+        free(pointer);
+}
+
+bool my_less_than(void *a, void *b)
+{
+        return *(uint32_t*)a < *(uint32_t*)b;
+}
+
+pmt_mq_queue_t *my_create(pmt_mq_queue_t *queue, const size_t nheaps)
+{
+        return pmt_mq_create(
+                queue,
+                nheaps,
+                sizeof(uint32_t),
+                my_less_than,
+                my_alloc,
+                my_realloc,
+                my_free,
+                NULL);
+}
+
+void test_create_destroy()
+{
+        pmt_mq_queue_t queue;
+        assert(my_create(&queue, 4));
+        assert(pmt_mq_size(&queue) == 0);
+        assert(!pmt_mq_pop(&queue, NULL));
+        pmt_mq_destroy(&queue);
+}
+
+#define MY_SIZE 10000
+
+void test_single()
+{
+        pmt_mq_queue_t queue;
+        assert(my_create(&queue, 4));
+
+        unsigned char seen[MY_SIZE] = { 0 };
+
+        for(uint32_t x = 0; x < MY_SIZE; ++x) {
+                const uint32_t value = (x * 7919) % MY_SIZE;
+                assert(pmt_mq_insert(&queue, (void*)&value));
+        }
+
+        assert(pmt_mq_size(&queue) == MY_SIZE);
+
+        /* pops are relaxed, but the early ones come from the small end */
+
+        uint64_t early = 0;
+
+        for(uint32_t x = 0; x < MY_SIZE; ++x) {
+                uint32_t value = UINT32_MAX;
+                assert(pmt_mq_pop(&queue, &value));
+                assert(value < MY_SIZE && !seen[value]);
+                seen[value] = 1;
+                if(x < MY_SIZE / 10) {
+                        early += value;
+                }
+        }
+
+        assert(early / (MY_SIZE / 10) < MY_SIZE / 4);
+
+        assert(pmt_mq_size(&queue) == 0);
+        assert(!pmt_mq_pop(&queue, NULL));
+
+        pmt_mq_destroy(&queue);
+}
+
+#define MY_THREADS 4
+#define MY_COUNT 50000
+
+pmt_mq_queue_t my_queue;
+unsigned char my_seen[MY_THREADS * MY_COUNT];
+atomic_size_t my_popped;
+
+void *my_worker(void *arg)
+{
+        const uint32_t base = (uint32_t)(uintptr_t)arg * MY_COUNT;
+
+        uint32_t value;
+
+        for(uint32_t x = 0; x < MY_COUNT; ++x) {
+
+                value = base + x;
+                assert(pmt_mq_insert(&my_queue, &value));
+
+                /* the size is counted under the heap locks, it never wraps */
+
+                assert(pmt_mq_size(&my_queue) <= MY_THREADS * MY_COUNT);
+
+                /* pop every other element while inserting */
+
+                if(x % 2 && pmt_mq_pop(&my_queue, &value)) {
+                        assert(!my_seen[value]);
+                        my_seen[value] = 1;
+                        atomic_fetch_add(&my_popped, 1);
+                }
+        }
+
+        return NULL;
+}
+
+void test_threads()
+{
+        assert(my_create(&my_queue, 2 * MY_THREADS));
+        atomic_init(&my_popped, 0);
+
+        pthread_t threads[MY_THREADS];
+
+        for(uintptr_t x = 0; x < MY_THREADS; ++x) {
+                assert(!pthread_create(threads + x, NULL, my_worker, (void*)x));
+        }
+
+        for(int x = 0; x < MY_THREADS; ++x) {
+                assert(!pthread_join(threads[x], NULL));
+        }
+
+        const size_t popped = atomic_load(&my_popped);
+
+        assert(pmt_mq_size(&my_queue) == MY_THREADS * MY_COUNT - popped);
+
+        uint32_t value;
+
+        while(pmt_mq_pop(&my_queue, &value)) {
+                assert(!my_seen[value]);
+                my_seen[value] = 1;
+        }
+
+        for(size_t x = 0; x < MY_THREADS * MY_COUNT; ++x) {
+                assert(my_seen[x]);
+        }
+
+        assert(pmt_mq_size(&my_queue) == 0);
+
+        pmt_mq_destroy(&my_queue);
+}
+
+int main(int argc, char **args)
+{
+        puts("testing - multi_queue.c");
+
+        test_create_destroy();
+        test_single();
+        test_threads();
+}
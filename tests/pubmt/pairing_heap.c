@@ -0,0 +1,243 @@
+#include "pubmt/pairing_heap.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+
+typedef struct my_node {
+
+        int key;
+
+        bool queued;
+
+        struct my_node *child, *next, *prev;
+
+} my_node_t;
+
+typedef struct my_heap {
+
+        my_node_t *root;
+
+} my_heap_t;
+
+void *get_child(void *node)
+{
+        return ((my_node_t*)node)->child;
+}
+
+void set_child(void *node, void *child)
+{
+        ((my_node_t*)node)->child = child;
+}
+
+void *get_next(void *node)
+{
+        return ((my_node_t*)node)->next;
+}
+
+void set_next(void *node, void *next)
+{
+        ((my_node_t*)node)->next = next;
+}
+
+void *get_prev(void *node)
+{
+        return ((my_node_t*)node)->prev;
+}
+
+void set_prev(void *node, void *prev)
+{
+        ((my_node_t*)node)->prev = prev;
+}
+
+void *get_key(void *node)
+{
+        return &((my_node_t*)node)->key;
+}
+
+bool less_than(void *key_a, void *key_b)
+{
+        return *(int*)key_a < *(int*)key_b;
+}
+
+pmt_ph_less_than_t get_less_than(void *heap)
+{
+        return less_than;
+}
+
+void *get_root(void *heap)
+{
+        return ((my_heap_t*)heap)->root;
+}
+
+void set_root(void *heap, void *root)
+{
+        ((my_heap_t*)heap)->root = root;
+}
+
+pmt_ph_iface_t my_iface = {
+        .node_iface = {
+                .get_child = get_child,
+                .set_child = set_child,
+                .get_next = get_next,
+                .set_next = set_next,
+                .get_prev = get_prev,
+                .set_prev = set_prev,
+                .get_key = get_key
+        },
+        .get_less_than = get_less_than,
+        .get_root = get_root,
+        .set_root = set_root
+};
+
+#define NNODES 1000
+
+my_node_t *make_nodes(void)
+{
+        my_node_t *nodes = calloc(NNODES, sizeof(my_node_t));
+        for(int x = 0; x < NNODES; ++x) {
+                nodes[x].key = rand() % 5000;
+        }
+        return nodes;
+}
+
+void drain(my_heap_t *heap, size_t expect)
+{
+        int prev = -1000000;
+        size_t count = 0;
+        my_node_t *node = NULL;
+
+        while((node = pmt_ph_pop(&my_iface, heap))) {
+                assert(node->key >= prev);
+                assert(node->queued);
+                node->queued = false;
+                prev = node->key;
+                ++count;
+        }
+
+        assert(count == expect);
+        assert(pmt_ph_is_empty(&my_iface, heap));
+}
+
+void test_insert_pop()
+{
+        my_heap_t heap;
+        pmt_ph_init(&my_iface, &heap);
+
+        assert(pmt_ph_is_empty(&my_iface, &heap));
+        assert(!pmt_ph_peek(&my_iface, &heap));
+        assert(!pmt_ph_pop(&my_iface, &heap));
+
+        my_node_t *nodes = make_nodes();
+
+        int min = 1000000;
+
+        for(int x = 0; x < NNODES; ++x) {
+                pmt_ph_insert(&my_iface, &heap, nodes + x);
+                nodes[x].queued = true;
+                if(nodes[x].key < min) {
+                        min = nodes[x].key;
+                }
+                assert(((my_node_t*)pmt_ph_peek(&my_iface, &heap))->key == min);
+        }
+
+        drain(&heap, NNODES);
+
+        free(nodes);
+}
+
+void test_meld()
+{
+        my_heap_t a, b;
+        pmt_ph_init(&my_iface, &a);
+        pmt_ph_init(&my_iface, &b);
+
+        my_node_t *nodes = make_nodes();
+
+        for(int x = 0; x < NNODES; ++x) {
+                pmt_ph_insert(&my_iface, x % 3 ? &a : &b, nodes + x);
+                nodes[x].queued = true;
+        }
+
+        /* pop a few so both heaps have multi-level trees */
+
+        for(int x = 0; x < 10; ++x) {
+                ((my_node_t*)pmt_ph_pop(&my_iface, &a))->queued = false;
+                ((my_node_t*)pmt_ph_pop(&my_iface, &b))->queued = false;
+        }
+
+        pmt_ph_meld(&my_iface, &a, &b);
+        assert(pmt_ph_is_empty(&my_iface, &b));
+
+        pmt_ph_meld(&my_iface, &a, &b);
+        pmt_ph_meld(&my_iface, &b, &a);
+        assert(pmt_ph_is_empty(&my_iface, &a));
+
+        drain(&b, NNODES - 20);
+
+        free(nodes);
+}
+
+void test_decrease_remove()
+{
+        my_heap_t heap;
+        pmt_ph_init(&my_iface, &heap);
+
+        my_node_t *nodes = make_nodes();
+
+        for(int x = 0; x < NNODES; ++x) {
+                pmt_ph_insert(&my_iface, &heap, nodes + x);
+                nodes[x].queued = true;
+        }
+
+        ((my_node_t*)pmt_ph_pop(&my_iface, &heap))->queued = false;
+
+        size_t count = 0;
+
+        for(int x = 0; x < NNODES; ++x) {
+                if(nodes[x].queued) {
+                        ++count;
+                }
+        }
+
+        for(int x = 0; x < 3000; ++x) {
+
+                my_node_t *node = nodes + rand() % NNODES;
+
+                if(!node->queued) {
+                        continue;
+                }
+
+                if(x % 4 == 0) {
+                        pmt_ph_remove(&my_iface, &heap, node);
+                        node->queued = false;
+                        --count;
+                } else {
+                        node->key -= rand() % 1000;
+                        pmt_ph_decrease(&my_iface, &heap, node);
+                }
+
+                /* a removed node may be inserted again */
+
+                if(x % 7 == 0) {
+                        node = nodes + rand() % NNODES;
+                        if(!node->queued) {
+                                pmt_ph_insert(&my_iface, &heap, node);
+                                node->queued = true;
+                                ++count;
+                        }
+                }
+        }
+
+        drain(&heap, count);
+
+        free(nodes);
+}
+
+int main(int argc, char **args)
+{
+        puts("testing - pairing_heap.c");
+
+        test_insert_pop();
+        test_meld();
+        test_decrease_remove();
+}
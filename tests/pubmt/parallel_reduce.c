@@ -0,0 +1,373 @@
+
+#include "pubmt/parallel_reduce.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+#include <stdint.h>
+
+typedef struct my_node {
+        
+        int key;
+
+        struct my_node_t *next;
+
+} my_node_t;
+
+typedef struct my_map {
+
+        size_t capacity, size;
+
+        void **buffer;
+
+} my_map_t;
+
+void *get_key(void *node)
+{
+      return &((my_node_t*)node)->key;
+}
+
+void set_next(void *node, void *next) 
+{
+        ((my_node_t*)node)->next = next;
+}
+
+void *get_next(void *node)
+{
+        return ((my_node_t*)node)->next;
+}
+
+void *get_buffer(void *map)
+{
+        return ((my_map_t*)map)->buffer;
+}
+
+void set_buffer(void *map, void *buffer)
+{
+        ((my_map_t*)map)->buffer = buffer;
+}
+
+size_t get_size(void *map)
+{
+        return ((my_map_t*)map)->size;
+}
+
+void set_size(void *map, const size_t size)
+{
+        ((my_map_t*)map)->size = size;
+}
+
+size_t get_capacity(void *map)
+{
+        return ((my_map_t*)map)->capacity;
+}
+
+void set_capacity(void *map, const size_t capacity)
+{
+        ((my_map_t*)map)->capacity = capacity;
+}
+
+size_t get_element_size(void *map)
+{
+        return sizeof(void*);
+}
+
+void *my_alloc(const size_t nbytes, void *alloc_state)
+{
+        return malloc(nbytes);
+}
+
+void *my_realloc(void *pointer, const size_t nbytes, void *alloc_state)
+{
+        return realloc(pointer, nbytes);
+}
+
+void my_free(void *pointer, void *alloc_state)
+{
+        free(pointer);
+}
+
+pmt_da_alloc_t get_alloc(void *map)
+{
+        return my_alloc;
+}
+pmt_da_realloc_t get_realloc(void *map)
+{
+        return my_realloc;
+}
+
+pmt_da_free_t get_free(void *map)
+{
+        return my_free;
+}
+
+void *get_alloc_state(void *map)
+{
+        return NULL;
+}
+
+bool equals(void *key_a, void *key_b)
+{
+        return *((int*)key_a) == *((int*)key_b);
+}
+
+size_t hash(void *ptr)
+{
+        return pmt_hm_fnv(ptr, sizeof(int));
+}
+
+pmt_hm_equals_t get_equals(void *map)
+{
+        return equals;
+}
+
+pmt_hm_hash_t get_hash(void *map)
+{
+        return hash;
+}
+
+pmt_hm_iface_t my_iface = {
+        .array_iface = {
+                .get_alloc = get_alloc,
+                .get_realloc = get_realloc,
+                .get_alloc_state = get_alloc_state,
+                .get_free = get_free,
+                .get_buffer = get_buffer,
+                .set_buffer = set_buffer,
+                .get_capacity = get_capacity,
+                .set_capacity = set_capacity,
+                .get_size = get_size,
+                .set_size = set_size,
+                .get_element_size = get_element_size},
+        .node_iface = {
+                .get_next = get_next,
+                .set_next = set_next
+        },
+        .get_key = get_key,
+        .get_equals = get_equals,
+        .get_hash = get_hash
+};
+
+typedef struct my_array {
+        size_t capacity, size;
+        uint32_t *buffer;
+} my_array_t;
+
+void *get_array_buffer(void *array)
+{
+        return ((my_array_t*)array)->buffer;
+}
+
+void set_array_buffer(void *array, void *buffer)
+{
+        ((my_array_t*)array)->buffer = buffer;
+}
+
+size_t get_array_size(void *array)
+{
+        return ((my_array_t*)array)->size;
+}
+
+void set_array_size(void *array, const size_t size)
+{
+        ((my_array_t*)array)->size = size;
+}
+
+size_t get_array_capacity(void *array)
+{
+        return ((my_array_t*)array)->capacity;
+}
+
+void set_array_capacity(void *array, const size_t capacity)
+{
+        ((my_array_t*)array)->capacity = capacity;
+}
+
+size_t get_array_element_size(void *array)
+{
+        return sizeof(uint32_t);
+}
+
+pmt_da_iface_t my_array_iface = {
+        .get_alloc = get_alloc,
+        .get_realloc = get_realloc,
+        .get_alloc_state = get_alloc_state,
+        .get_free = get_free,
+        .get_buffer = get_array_buffer,
+        .set_buffer = set_array_buffer,
+        .get_capacity = get_array_capacity,
+        .set_capacity = set_array_capacity,
+        .get_size = get_array_size,
+        .set_size = set_array_size,
+        .get_element_size = get_array_element_size
+};
+
+typedef struct my_stats {
+        size_t count;
+        long long sum;
+} my_stats_t;
+
+void my_stats_init(void *accumulator, void *state)
+{
+        my_stats_t *stats = accumulator;
+        stats->count = 0;
+        stats->sum = 0;
+}
+
+void my_stats_combine(void *into, void *from, void *state)
+{
+        ((my_stats_t*)into)->count += ((my_stats_t*)from)->count;
+        ((my_stats_t*)into)->sum += ((my_stats_t*)from)->sum;
+}
+
+void my_visit(void *node, void *accumulator, void *state)
+{
+        my_stats_t *stats = accumulator;
+        stats->count += 1;
+        stats->sum += ((my_node_t*)node)->key;
+}
+
+atomic_size_t my_visits;
+
+void my_visit_plain(void *node, void *accumulator, void *state)
+{
+        assert(!accumulator);
+        atomic_fetch_add(&my_visits, 1);
+}
+
+void check_map(pmt_tp_pool_t *pool, const size_t capacity, const int n)
+{
+        my_node_t *nodes = malloc((size_t)n * sizeof(my_node_t) + 1);
+        my_map_t map;
+
+        assert(pmt_hm_create(&my_iface, &map, capacity));
+
+        long long expect = 0;
+        for(int x = 0; x < n; ++x) {
+                nodes[x].key = x * 3;
+                nodes[x].next = NULL;
+                assert(pmt_hm_insert(&my_iface, &map, nodes + x) == 0);
+                expect += x * 3;
+        }
+
+        my_stats_t stats;
+        my_stats_init(&stats, NULL);
+
+        assert(pmt_hm_parallel_foreach(
+                &my_iface, &map, pool, my_visit, &stats, sizeof(stats), 
+                my_stats_init, my_stats_combine, NULL));
+        assert(stats.count == (size_t)n);
+        assert(stats.sum == expect);
+
+        atomic_store(&my_visits, 0);
+        assert(pmt_hm_parallel_foreach(
+                &my_iface, &map, pool, my_visit_plain, NULL, 0, 
+                NULL, NULL, NULL));
+        assert(atomic_load(&my_visits) == (size_t)n);
+
+        pmt_hm_destroy(&my_iface, &map);
+        free(nodes);
+}
+
+void test_hm_parallel_foreach()
+{
+        pmt_tp_pool_t pool;
+        assert(pmt_tp_create(&pool, 4, my_alloc, my_free, NULL));
+
+        check_map(&pool, 16, 0);
+        check_map(&pool, 16, 100);
+        check_map(&pool, 1 << 16, 50000);
+        check_map(&pool, 100003, 20000);
+
+        pmt_tp_destroy(&pool);
+}
+
+/* Spans must be combined in index order. */
+typedef struct my_span {
+        size_t first, last, count;
+        uint64_t sum;
+} my_span_t;
+
+void my_span_init(void *accumulator, void *state)
+{
+        my_span_t *span = accumulator;
+        span->first = SIZE_MAX;
+        span->last = 0;
+        span->count = 0;
+        span->sum = 0;
+}
+
+void my_span_combine(void *into, void *from, void *state)
+{
+        my_span_t *a = into, *b = from;
+        if(!b->count) {
+                return;
+        }
+        if(a->count) {
+                assert(a->last + 1 == b->first);
+        } else {
+                a->first = b->first;
+        }
+        a->last = b->last;
+        a->count += b->count;
+        a->sum += b->sum;
+}
+
+void my_fold(void *elements, const size_t nelems, void *accumulator, void *state)
+{
+        uint32_t *values = elements;
+        my_span_t span;
+        my_span_init(&span, NULL);
+        span.first = values[0];
+        span.last = values[nelems - 1];
+        span.count = nelems;
+        for(size_t x = 0; x < nelems; ++x) {
+                assert(x == 0 || values[x] == values[x - 1] + 1);
+                span.sum += values[x];
+        }
+        my_span_combine(accumulator, &span, state);
+}
+
+void check_array(pmt_tp_pool_t *pool, const size_t n)
+{
+        my_array_t array;
+        assert(pmt_da_create(&my_array_iface, &array, n ? n : 1));
+        array.size = n;
+
+        for(size_t x = 0; x < n; ++x) {
+                array.buffer[x] = (uint32_t)x;
+        }
+
+        my_span_t span;
+        my_span_init(&span, NULL);
+
+        assert(pmt_da_parallel_reduce(
+                &my_array_iface, &array, pool, my_fold, &span, sizeof(span),
+                my_span_init, my_span_combine, NULL));
+
+        assert(span.count == n);
+        assert(span.sum == (uint64_t)n * (n ? n - 1 : 0) / 2);
+        assert(!n || (span.first == 0 && span.last == n - 1));
+
+        pmt_da_destroy(&my_array_iface, &array);
+}
+
+void test_da_parallel_reduce()
+{
+        pmt_tp_pool_t pool;
+        assert(pmt_tp_create(&pool, 3, my_alloc, my_free, NULL));
+
+        check_array(&pool, 0);
+        check_array(&pool, 10);
+        check_array(&pool, PMT_PR_MIN_CHUNK * 2 + 1);
+        check_array(&pool, 1000003);
+
+        pmt_tp_destroy(&pool);
+}
+
+int main(int argc, char **args)
+{
+        puts("testing - parallel_reduce.c");
+
+        test_hm_parallel_foreach();
+        test_da_parallel_reduce();
+}
@@ -0,0 +1,329 @@
+#include "pubmt/parallel_sort.h"
+#include <stdio.h>
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdatomic.h>
+
+typedef struct my_array {
+        size_t capacity, size, element_size;
+        void *buffer;
+} my_array_t;
+
+void *get_buffer(void *array)
+{
+        return ((my_array_t*)array)->buffer;
+}
+
+void set_buffer(void *array, void *buffer)
+{
+        ((my_array_t*)array)->buffer = buffer;
+}
+
+size_t get_size(void *array)
+{
+        return ((my_array_t*)array)->size;
+}
+
+void set_size(void *array, const size_t size)
+{
+        ((my_array_t*)array)->size = size;
+}
+
+size_t get_capacity(void *array)
+{
+        return ((my_array_t*)array)->capacity;
+}
+
+void set_capacity(void *array, const size_t capacity)
+{
+        ((my_array_t*)array)->capacity = capacity;
+}
+
+size_t get_element_size(void *array)
+{
+        return ((my_array_t*)array)->element_size;
+}
+
+void *my_alloc(const size_t nbytes, void *alloc_state)
+{
+        return malloc(nbytes);
+}
+
+void *my_realloc(void *pointer, const size_t nbytes, void *alloc_state)
+{
+        return realloc(pointer, nbytes);
+}
+
+void my_free(void *pointer, void *alloc_state)
+{
+        free(pointer);
+}
+
+pmt_da_alloc_t get_alloc(void *array)
+{
+        return my_alloc;
+}
+
+pmt_da_realloc_t get_realloc(void *array)
+{
+        return my_realloc;
+}
+
+pmt_da_free_t get_free(void *array)
+{
+        return my_free;
+}
+
+void *get_alloc_state(void *array)
+{
+        return NULL;
+}
+
+pmt_da_iface_t my_iface = {
+        .get_alloc = get_alloc,
+        .get_realloc = get_realloc,
+        .get_alloc_state = get_alloc_state,
+        .get_free = get_free,
+        .get_buffer = get_buffer,
+        .set_buffer = set_buffer,
+        .get_capacity = get_capacity,
+        .set_capacity = set_capacity,
+        .get_size = get_size,
+        .set_size = set_size,
+        .get_element_size = get_element_size
+};
+
+typedef struct my_triple {
+        int key, a, b;
+} my_triple_t;
+
+bool int_less_than(void *a, void *b)
+{
+        return *(int*)a < *(int*)b;
+}
+
+int int_cmp(const void *a, const void *b)
+{
+        const int x = *(const int*)a, y = *(const int*)b;
+        return (x > y) - (x < y);
+}
+
+void check_ints(const size_t n, const int modulo, const size_t nthreads)
+{
+        int *ints = malloc(n * sizeof(int) + 1);
+        int *expect = malloc(n * sizeof(int) + 1);
+
+        for(size_t x = 0; x < n; ++x) {
+                ints[x] = rand() % modulo;
+        }
+
+        memcpy(expect, ints, n * sizeof(int));
+        qsort(expect, n, sizeof(int), int_cmp);
+
+        my_array_t array = {
+                .buffer = ints,
+                .size = n,
+                .capacity = n,
+                .element_size = sizeof(int) };
+
+        assert(pmt_da_parallel_sort(
+                &my_iface, &array, int_less_than, nthreads));
+        assert(!memcmp(ints, expect, n * sizeof(int)));
+
+        free(ints);
+        free(expect);
+}
+
+void test_parallel_sort()
+{
+        check_ints(0, 10, 4);
+        check_ints(1, 10, 4);
+        check_ints(1000, 1000, 4);
+        check_ints(100000, 1 << 30, 1);
+        check_ints(100000, 1 << 30, 4);
+        check_ints(100000, 1 << 30, 7);
+        check_ints(100000, 3, 4);
+        check_ints(100000, 1, 8);
+}
+
+void test_parallel_sort_structs()
+{
+        const size_t n = 50000;
+        my_triple_t *triples = malloc(n * sizeof(my_triple_t));
+
+        for(size_t x = 0; x < n; ++x) {
+                triples[x].key = rand();
+                triples[x].a = triples[x].key + 1;
+                triples[x].b = triples[x].key + 2;
+        }
+
+        my_array_t array = {
+                .buffer = triples,
+                .size = n,
+                .capacity = n,
+                .element_size = sizeof(my_triple_t) };
+
+        assert(pmt_da_parallel_sort(&my_iface, &array, int_less_than, 3));
+
+        for(size_t x = 0; x < n; ++x) {
+                assert(x == 0 || triples[x - 1].key <= triples[x].key);
+                assert(triples[x].a == triples[x].key + 1);
+                assert(triples[x].b == triples[x].key + 2);
+        }
+
+        free(triples);
+}
+
+bool u64_less_than(void *a, void *b)
+{
+        return *(uint64_t*)a < *(uint64_t*)b;
+}
+
+void test_parallel_sort_wide()
+{
+        /* an odd count of 8 byte elements keeps the regions misaligned
+           unless they are padded */
+
+        const size_t n = 100001;
+        uint64_t *values = malloc(n * sizeof(uint64_t));
+
+        for(size_t x = 0; x < n; ++x) {
+                values[x] = ((uint64_t)rand() << 32) | (uint64_t)rand();
+        }
+
+        my_array_t array = {
+                .buffer = values,
+                .size = n,
+                .capacity = n,
+                .element_size = sizeof(uint64_t) };
+
+        assert(pmt_da_parallel_sort(&my_iface, &array, u64_less_than, 4));
+
+        for(size_t x = 1; x < n; ++x) {
+                assert(values[x - 1] <= values[x]);
+        }
+
+        free(values);
+}
+
+/* Comparisons per thread, each thread claims a slot on its first call. */
+
+#define MY_SLOTS 64
+
+atomic_size_t my_slot_count;
+atomic_size_t my_compares[MY_SLOTS];
+_Thread_local size_t my_slot = SIZE_MAX;
+
+bool counting_less_than(void *a, void *b)
+{
+        if(my_slot == SIZE_MAX) {
+                my_slot = atomic_fetch_add(&my_slot_count, 1);
+                assert(my_slot < MY_SLOTS);
+        }
+
+        atomic_fetch_add_explicit(
+                my_compares + my_slot,
+                1,
+                memory_order_relaxed);
+
+        return *(int*)a < *(int*)b;
+}
+
+/* Sort and return the largest share of comparisons made by one thread. */
+double check_balance(const size_t n, const int modulo)
+{
+        int *ints = malloc(n * sizeof(int));
+
+        for(size_t x = 0; x < n; ++x) {
+                ints[x] = rand() % modulo;
+        }
+
+        atomic_store(&my_slot_count, 0);
+        for(size_t x = 0; x < MY_SLOTS; ++x) {
+                atomic_store(my_compares + x, 0);
+        }
+        my_slot = SIZE_MAX;
+
+        my_array_t array = {
+                .buffer = ints,
+                .size = n,
+                .capacity = n,
+                .element_size = sizeof(int) };
+
+        assert(pmt_da_parallel_sort(
+                &my_iface, &array, counting_less_than, 4));
+
+        for(size_t x = 1; x < n; ++x) {
+                assert(ints[x - 1] <= ints[x]);
+        }
+
+        size_t total = 0, most = 0;
+
+        for(size_t x = 0; x < atomic_load(&my_slot_count); ++x) {
+                const size_t count = atomic_load(my_compares + x);
+                total += count;
+                most = count > most ? count : most;
+        }
+
+        free(ints);
+
+        return (double)most / (double)total;
+}
+
+void test_parallel_sort_duplicates()
+{
+        /* equal keys are spread over buckets, no thread does most work */
+
+        assert(check_balance(200000, 1) < 0.5);
+        assert(check_balance(200000, 2) < 0.5);
+        assert(check_balance(200000, 5) < 0.5);
+}
+
+void test_parallel_sort_pool()
+{
+        pmt_tp_pool_t pool;
+        assert(pmt_tp_create(&pool, 4, my_alloc, my_free, NULL));
+
+        const size_t n = 100000;
+        int *ints = malloc(n * sizeof(int));
+        int *expect = malloc(n * sizeof(int));
+
+        for(int round = 0; round < 3; ++round) {
+                for(size_t x = 0; x < n; ++x) {
+                        ints[x] = rand() % (round ? 1 << 30 : 5);
+                }
+
+                memcpy(expect, ints, n * sizeof(int));
+                qsort(expect, n, sizeof(int), int_cmp);
+
+                my_array_t array = {
+                        .buffer = ints,
+                        .size = n,
+                        .capacity = n,
+                        .element_size = sizeof(int) };
+
+                assert(pmt_da_parallel_sort_pool(
+                        &my_iface, &array, int_less_than, &pool));
+                assert(!memcmp(ints, expect, n * sizeof(int)));
+        }
+
+        free(ints);
+        free(expect);
+
+        pmt_tp_destroy(&pool);
+}
+
+int main(int argc, char **args)
+{
+        puts("testing - parallel_sort.c");
+
+        srand(1);
+
+        test_parallel_sort();
+        test_parallel_sort_structs();
+        test_parallel_sort_wide();
+        test_parallel_sort_duplicates();
+        test_parallel_sort_pool();
+}
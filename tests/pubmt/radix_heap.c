@@ -0,0 +1,152 @@
+#include "pubmt/radix_heap.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+
+bool fail_alloc = false;
+
+void *my_alloc(const size_t nbytes, void *alloc_state)
+{
+        return fail_alloc ? NULL : malloc(nbytes);
+}
+
+void *my_realloc(void *pointer, const size_t nbytes, void *alloc_state)
+{
+        return fail_alloc ? NULL : realloc(pointer, nbytes);
+}
+
+void my_free(void *pointer, void *alloc_state)
+{
+        free(pointer);
+}
+
+typedef struct my_elem {
+        uint64_t key;
+        int id;
+} my_elem;
+
+void test_push_pop()
+{
+        pmt_rh_heap_t heap;
+        pmt_rh_init(&heap, sizeof(my_elem), my_alloc, my_realloc, my_free, 0);
+
+        assert(pmt_rh_is_empty(&heap));
+        assert(!pmt_rh_peek(&heap, NULL));
+        assert(!pmt_rh_pop(&heap, NULL, NULL));
+
+        const uint64_t keys[] = {
+                5, 3, 3, 900, UINT64_MAX, 0, 1ULL << 40, 77, UINT64_MAX - 1
+        };
+        const size_t nkeys = sizeof(keys) / sizeof(keys[0]);
+
+        for(size_t x = 0; x < nkeys; ++x) {
+                my_elem elem = { .key = keys[x], .id = (int)x };
+                my_elem *pointer = pmt_rh_push(&heap, keys[x], &elem);
+                assert(pointer && pointer->id == (int)x);
+        }
+
+        assert(pmt_rh_size(&heap) == nkeys);
+
+        const uint64_t sorted[] = {
+                0, 3, 3, 5, 77, 900, 1ULL << 40, UINT64_MAX - 1, UINT64_MAX
+        };
+
+        for(size_t x = 0; x < nkeys; ++x) {
+                uint64_t key = 1, peeked = 2;
+                my_elem elem;
+                my_elem *top = pmt_rh_peek(&heap, &peeked);
+                assert(top && top->key == sorted[x] && peeked == sorted[x]);
+                assert(pmt_rh_pop(&heap, &key, &elem));
+                assert(key == sorted[x] && elem.key == key);
+                assert(pmt_rh_last_key(&heap) == key);
+        }
+
+        assert(pmt_rh_is_empty(&heap));
+
+        pmt_rh_clear(&heap);
+        assert(pmt_rh_last_key(&heap) == 0);
+        assert(pmt_rh_push(&heap, 1, NULL));
+        assert(pmt_rh_pop(&heap, NULL, NULL));
+
+        pmt_rh_destroy(&heap);
+}
+
+void test_monotone()
+{
+        pmt_rh_heap_t heap;
+        pmt_rh_init(&heap, sizeof(my_elem), my_alloc, my_realloc, my_free, 0);
+
+        uint64_t last = 0, pushed = 0, popped = 0, sum_in = 0, sum_out = 0;
+
+        for(int round = 0; round < 20000; ++round) {
+
+                /* pushes are bounded below by the last popped key */
+
+                const int npush = rand() % 4;
+
+                for(int x = 0; x < npush; ++x) {
+                        const uint64_t key = last + (uint64_t)(rand() % 100000);
+                        my_elem elem = { .key = key, .id = round };
+                        assert(pmt_rh_push(&heap, key, &elem));
+                        sum_in += key;
+                        ++pushed;
+                }
+
+                my_elem elem;
+                uint64_t key;
+
+                if(rand() % 2 && pmt_rh_pop(&heap, &key, &elem)) {
+                        assert(key >= last && elem.key == key);
+                        last = key;
+                        sum_out += key;
+                        ++popped;
+                }
+        }
+
+        my_elem elem;
+        uint64_t key;
+
+        while(pmt_rh_pop(&heap, &key, &elem)) {
+                assert(key >= last && elem.key == key);
+                last = key;
+                sum_out += key;
+                ++popped;
+        }
+
+        assert(pushed == popped && sum_in == sum_out);
+
+        pmt_rh_destroy(&heap);
+}
+
+void test_alloc_failure()
+{
+        pmt_rh_heap_t heap;
+        pmt_rh_init(&heap, 0, my_alloc, my_realloc, my_free, 0);
+
+        assert(pmt_rh_push(&heap, 1000, NULL));
+        assert(pmt_rh_push(&heap, 1001, NULL));
+
+        /* redistributing the bucket into empty buckets must allocate */
+
+        fail_alloc = true;
+        assert(!pmt_rh_pop(&heap, NULL, NULL));
+        assert(!pmt_rh_push(&heap, 5, NULL));
+        assert(pmt_rh_size(&heap) == 2);
+        fail_alloc = false;
+
+        uint64_t key = 0;
+        assert(pmt_rh_pop(&heap, &key, NULL) && key == 1000);
+        assert(pmt_rh_pop(&heap, &key, NULL) && key == 1001);
+        assert(pmt_rh_is_empty(&heap));
+
+        pmt_rh_destroy(&heap);
+}
+
+int main(int argc, char **args)
+{
+        puts("testing - radix_heap.c");
+
+        test_push_pop();
+        test_monotone();
+        test_alloc_failure();
+}
@@ -0,0 +1,255 @@
+#include "pubmt/reclamation.h"
+#include <stdio.h>
+#include <assert.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <pthread.h>
+
+#define MY_LIVE 0x11111111u
+#define MY_DEAD 0xdeadbeefu
+
+typedef struct my_node {
+        uint32_t magic;
+        uint32_t value;
+        _Atomic(void*) next;
+} my_node_t;
+
+atomic_size_t my_nfreed;
+
+void *my_alloc(const size_t nbytes, void *alloc_state)
+{
+        return malloc(nbytes);
+}
+
+void *my_realloc(void *pointer, const size_t nbytes, void *alloc_state)
+{
+        return realloc(pointer, nbytes);
+}
+
+void my_free(void *pointer, void *alloc_state)
+{
+        free(pointer);
+}
+
+my_node_t *my_node_new(const uint32_t value)
+{
+        my_node_t *node = malloc(sizeof(my_node_t));
+        assert(node);
+        node->magic = MY_LIVE;
+        node->value = value;
+        atomic_init(&node->next, NULL);
+        return node;
+}
+
+void my_node_free(void *node, void *free_state)
+{
+        assert(((my_node_t*)node)->magic == MY_LIVE);
+        ((my_node_t*)node)->magic = MY_DEAD;
+        atomic_fetch_add(&my_nfreed, 1);
+        free(node);
+}
+
+void *get_next(void *node)
+{
+        return atomic_load(&((my_node_t*)node)->next);
+}
+
+void test_ebr()
+{
+        pmt_ebr_domain_t domain;
+        assert(pmt_ebr_init(
+                &domain, my_alloc, my_realloc, my_free, NULL) == &domain);
+
+        pmt_ebr_thread_t
+                *writer = pmt_ebr_register(&domain),
+                *reader = pmt_ebr_register(&domain);
+        assert(writer && reader && writer != reader);
+
+        atomic_store(&my_nfreed, 0);
+
+        /* a reader inside a critical section holds back the node */
+
+        pmt_ebr_enter(reader);
+        pmt_ebr_enter(reader);
+        assert(pmt_ebr_retire(writer, my_node_new(1), my_node_free, NULL));
+        for(int x = 0; x < 5; ++x) {
+                assert(pmt_ebr_reclaim(writer) == 0);
+        }
+        pmt_ebr_exit(reader);
+        assert(pmt_ebr_reclaim(writer) == 0);
+        pmt_ebr_exit(reader);
+
+        size_t nfreed = 0;
+        for(int x = 0; x < 3; ++x) {
+                nfreed += pmt_ebr_reclaim(writer);
+        }
+        assert(nfreed == 1);
+        assert(atomic_load(&my_nfreed) == 1);
+
+        /* amortized scanning frees without explicit reclaims */
+
+        for(uint32_t x = 0; x < 1000; ++x) {
+                assert(pmt_ebr_retire(writer, my_node_new(x), my_node_free, NULL));
+        }
+        assert(atomic_load(&my_nfreed) > 500);
+        assert(writer->list.length <= 3 * PMT_EBR_SCAN_INTERVAL);
+
+        /* released records are reused */
+
+        pmt_ebr_unregister(reader);
+        assert(pmt_ebr_register(&domain) == reader);
+
+        /* leftovers are freed with the domain */
+
+        pmt_ebr_enter(reader);
+        assert(pmt_ebr_retire(writer, my_node_new(2), my_node_free, NULL));
+        pmt_ebr_exit(reader);
+        pmt_ebr_unregister(writer);
+        pmt_ebr_unregister(reader);
+        pmt_ebr_destroy(&domain);
+        assert(atomic_load(&my_nfreed) == 1002);
+}
+
+void test_hp()
+{
+        pmt_hp_domain_t domain;
+        assert(pmt_hp_init(
+                &domain, my_alloc, my_realloc, my_free, NULL) == &domain);
+
+        pmt_hp_thread_t
+                *writer = pmt_hp_register(&domain),
+                *reader = pmt_hp_register(&domain);
+        assert(writer && reader && writer != reader);
+
+        atomic_store(&my_nfreed, 0);
+
+        my_node_t *a = my_node_new(1), *b = my_node_new(2);
+        _Atomic(void*) shared;
+        atomic_init(&shared, a);
+
+        assert(pmt_hp_protect(reader, 0, &shared) == a);
+
+        atomic_store(&a->next, b);
+        assert(pmt_hp_protect_with(reader, 1, get_next, a) == b);
+
+        atomic_store(&shared, NULL);
+        assert(pmt_hp_retire(writer, a, my_node_free, NULL));
+        assert(pmt_hp_retire(writer, b, my_node_free, NULL));
+        assert(pmt_hp_reclaim(writer) == 0);
+
+        pmt_hp_clear(reader, 1);
+        assert(pmt_hp_reclaim(writer) == 1);
+        assert(a->magic == MY_LIVE);
+
+        pmt_hp_set(reader, 2, a);
+        pmt_hp_clear(reader, 0);
+        assert(pmt_hp_reclaim(writer) == 0);
+        pmt_hp_clear(reader, 2);
+        assert(pmt_hp_reclaim(writer) == 1);
+        assert(atomic_load(&my_nfreed) == 2);
+
+        /* garbage stays bounded without explicit reclaims */
+
+        my_node_t *held = my_node_new(3);
+        pmt_hp_set(reader, 0, held);
+        assert(pmt_hp_retire(writer, held, my_node_free, NULL));
+
+        for(uint32_t x = 0; x < 1000; ++x) {
+                assert(pmt_hp_retire(writer, my_node_new(x), my_node_free, NULL));
+                assert(writer->list.length <=
+                        2 * PMT_HP_SLOTS * 2 + PMT_HP_SCAN_INTERVAL + 1);
+        }
+
+        pmt_hp_unregister(writer);
+        assert(writer->list.length == 1);
+        assert(pmt_hp_register(&domain) == writer);
+
+        pmt_hp_unregister(reader);
+        pmt_hp_unregister(writer);
+        pmt_hp_destroy(&domain);
+        assert(atomic_load(&my_nfreed) == 1003);
+}
+
+#define MY_THREADS 4
+#define MY_ROUNDS 20000
+
+_Atomic(void*) my_shared;
+pmt_ebr_domain_t my_ebr;
+pmt_hp_domain_t my_hp;
+
+void *my_ebr_worker(void *arg)
+{
+        pmt_ebr_thread_t *thread = pmt_ebr_register(&my_ebr);
+        assert(thread);
+
+        for(uint32_t x = 0; x < MY_ROUNDS; ++x) {
+                pmt_ebr_enter(thread);
+                my_node_t *node = atomic_load(&my_shared);
+                assert(node->magic == MY_LIVE);
+                if(x % 4 == 0) {
+                        my_node_t *old = atomic_exchange(
+                                &my_shared, my_node_new(x));
+                        assert(pmt_ebr_retire(
+                                thread, old, my_node_free, NULL));
+                }
+                pmt_ebr_exit(thread);
+        }
+
+        pmt_ebr_unregister(thread);
+
+        return NULL;
+}
+
+void *my_hp_worker(void *arg)
+{
+        pmt_hp_thread_t *thread = pmt_hp_register(&my_hp);
+        assert(thread);
+
+        for(uint32_t x = 0; x < MY_ROUNDS; ++x) {
+                my_node_t *node = pmt_hp_protect(thread, 0, &my_shared);
+                assert(node->magic == MY_LIVE);
+                if(x % 4 == 0) {
+                        my_node_t *old = atomic_exchange(
+                                &my_shared, my_node_new(x));
+                        assert(pmt_hp_retire(
+                                thread, old, my_node_free, NULL));
+                }
+                pmt_hp_clear(thread, 0);
+        }
+
+        pmt_hp_unregister(thread);
+
+        return NULL;
+}
+
+void test_threads(void *(*worker)(void*))
+{
+        pthread_t threads[MY_THREADS];
+
+        atomic_store(&my_shared, my_node_new(0));
+
+        for(int x = 0; x < MY_THREADS; ++x) {
+                assert(!pthread_create(threads + x, NULL, worker, NULL));
+        }
+        for(int x = 0; x < MY_THREADS; ++x) {
+                assert(!pthread_join(threads[x], NULL));
+        }
+
+        my_node_free(atomic_load(&my_shared), NULL);
+}
+
+int main(int argc, char **args)
+{
+        puts("testing - reclamation.c");
+
+        test_ebr();
+        test_hp();
+
+        pmt_ebr_init(&my_ebr, my_alloc, my_realloc, my_free, NULL);
+        test_threads(my_ebr_worker);
+        pmt_ebr_destroy(&my_ebr);
+
+        pmt_hp_init(&my_hp, my_alloc, my_realloc, my_free, NULL);
+        test_threads(my_hp_worker);
+        pmt_hp_destroy(&my_hp);
+}
@@ -0,0 +1,377 @@
+#include "pubmt/ring_buffer.h"
+#include <stdio.h>
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef struct my_ring {
+        size_t capacity, size;
+        int *buffer;
+        size_t head;
+} my_ring_t;
+
+void *get_buffer(void *ring)
+{
+        return ((my_ring_t*)ring)->buffer;
+}
+
+void set_buffer(void *ring, void *buffer)
+{
+        ((my_ring_t*)ring)->buffer = buffer;
+}
+
+size_t get_size(void *ring)
+{
+        return ((my_ring_t*)ring)->size;
+}
+
+void set_size(void *ring, const size_t size)
+{
+        ((my_ring_t*)ring)->size = size;
+}
+
+size_t get_capacity(void *ring)
+{
+        return ((my_ring_t*)ring)->capacity;
+}
+
+void set_capacity(void *ring, const size_t capacity)
+{
+        ((my_ring_t*)ring)->capacity = capacity;
+}
+
+size_t get_element_size(void *ring)
+{
+        return sizeof(int);
+}
+
+size_t get_head(void *ring)
+{
+        return ((my_ring_t*)ring)->head;
+}
+
+void set_head(void *ring, const size_t head)
+{
+        ((my_ring_t*)ring)->head = head;
+}
+
+void *my_alloc(const size_t nbytes, void *alloc_state)
+{
+        return malloc(nbytes);
+}
+
+void *my_realloc(void *pointer, const size_t nbytes, void *alloc_state)
+{
+        return realloc(pointer, nbytes);
+}
+
+void my_free(void *pointer, void *alloc_state)
+{
+        free(pointer);
+}
+
+pmt_da_alloc_t get_alloc(void *ring)
+{
+        return my_alloc;
+}
+
+pmt_da_realloc_t get_realloc(void *ring)
+{
+        return my_realloc;
+}
+
+pmt_da_free_t get_free(void *ring)
+{
+        return my_free;
+}
+
+void *get_alloc_state(void *ring)
+{
+        return NULL;
+}
+
+pmt_rb_iface_t my_iface = {
+        .get_head = get_head,
+        .set_head = set_head,
+        .array_iface = {
+                .get_alloc = get_alloc,
+                .get_realloc = get_realloc,
+                .get_alloc_state = get_alloc_state,
+                .get_free = get_free,
+                .get_buffer = get_buffer,
+                .set_buffer = set_buffer,
+                .get_capacity = get_capacity,
+                .set_capacity = set_capacity,
+                .get_size = get_size,
+                .set_size = set_size,
+                .get_element_size = get_element_size
+        }
+};
+
+void test_create_destroy()
+{
+        my_ring_t ring;
+        assert(pmt_rb_create(&my_iface, &ring, 5));
+        assert(ring.capacity == 8);
+        assert(ring.size == 0);
+        assert(ring.head == 0);
+        assert(pmt_rb_is_empty(&my_iface, &ring));
+        assert(!pmt_rb_at(&my_iface, &ring, 0));
+        pmt_rb_destroy(&my_iface, &ring);
+
+        assert(pmt_rb_create(&my_iface, &ring, 0));
+        assert(ring.capacity == 1);
+        pmt_rb_destroy(&my_iface, &ring);
+}
+
+void test_push_back()
+{
+        my_ring_t ring;
+        assert(pmt_rb_create(&my_iface, &ring, 1));
+
+        for(int x = 0; x < 100; ++x) {
+                int *n = pmt_rb_push_back(&my_iface, &ring, &x);
+                assert(n && *n == x);
+        }
+
+        assert(pmt_rb_size(&my_iface, &ring) == 100);
+        assert(ring.capacity == 128);
+
+        for(int x = 0; x < 100; ++x) {
+                assert(*(int*)pmt_rb_at(&my_iface, &ring, (size_t)x) == x);
+        }
+
+        assert(!pmt_rb_at(&my_iface, &ring, 100));
+
+        pmt_rb_destroy(&my_iface, &ring);
+}
+
+void test_push_front()
+{
+        my_ring_t ring;
+        assert(pmt_rb_create(&my_iface, &ring, 1));
+
+        for(int x = 0; x < 100; ++x) {
+                int *n = pmt_rb_push_front(&my_iface, &ring, &x);
+                assert(n && *n == x);
+        }
+
+        for(int x = 0; x < 100; ++x) {
+                assert(*(int*)pmt_rb_at(&my_iface, &ring, (size_t)x) == 99 - x);
+        }
+
+        pmt_rb_destroy(&my_iface, &ring);
+}
+
+void test_pop()
+{
+        my_ring_t ring;
+        assert(pmt_rb_create(&my_iface, &ring, 2));
+
+        for(int x = 0; x < 50; ++x) {
+                assert(pmt_rb_push_back(&my_iface, &ring, &x));
+        }
+        for(int x = -1; x >= -50; --x) {
+                assert(pmt_rb_push_front(&my_iface, &ring, &x));
+        }
+
+        int value = 0;
+        for(int x = -50; x < 0; ++x) {
+                assert(pmt_rb_pop_front(&my_iface, &ring, &value));
+                assert(value == x);
+        }
+        for(int x = 49; x >= 0; --x) {
+                assert(pmt_rb_pop_back(&my_iface, &ring, &value));
+                assert(value == x);
+        }
+
+        assert(pmt_rb_is_empty(&my_iface, &ring));
+        assert(!pmt_rb_pop_back(&my_iface, &ring, &value));
+        assert(!pmt_rb_pop_front(&my_iface, &ring, &value));
+
+        pmt_rb_destroy(&my_iface, &ring);
+}
+
+void test_wrapped_growth()
+{
+        my_ring_t ring;
+        assert(pmt_rb_create(&my_iface, &ring, 8));
+
+        int value = 0;
+
+        /* leave the contents wrapped around the end of the buffer */
+
+        for(int x = 0; x < 6; ++x) {
+                assert(pmt_rb_push_back(&my_iface, &ring, &x));
+        }
+        for(int x = 0; x < 5; ++x) {
+                assert(pmt_rb_pop_front(&my_iface, &ring, &value));
+        }
+        for(int x = 6; x < 13; ++x) {
+                assert(pmt_rb_push_back(&my_iface, &ring, &x));
+        }
+        assert(ring.capacity == 8);
+        assert(ring.head + ring.size > ring.capacity);
+
+        assert(pmt_rb_reserve(&my_iface, &ring, 1));
+        assert(ring.capacity == 16);
+        assert(ring.head + ring.size <= ring.capacity);
+
+        for(int x = 5; x < 13; ++x) {
+                assert(pmt_rb_pop_front(&my_iface, &ring, &value));
+                assert(value == x);
+        }
+
+        pmt_rb_destroy(&my_iface, &ring);
+}
+
+void test_queue()
+{
+        my_ring_t ring;
+        assert(pmt_rb_create(&my_iface, &ring, 2));
+
+        int next = 0, expect = 0, value = 0;
+
+        for(int x = 0; x < 10000; ++x) {
+                assert(pmt_rb_push_back(&my_iface, &ring, &next));
+                ++next;
+                assert(pmt_rb_push_back(&my_iface, &ring, &next));
+                ++next;
+                assert(pmt_rb_pop_front(&my_iface, &ring, &value));
+                assert(value == expect++);
+                if(pmt_rb_size(&my_iface, &ring) > 16) {
+                        while(!pmt_rb_is_empty(&my_iface, &ring)) {
+                                assert(pmt_rb_pop_front(
+                                        &my_iface, &ring, &value));
+                                assert(value == expect++);
+                        }
+                }
+        }
+
+        assert(ring.capacity <= 32);
+
+        pmt_rb_destroy(&my_iface, &ring);
+}
+
+void test_peek_spans()
+{
+        my_ring_t ring;
+        assert(pmt_rb_create(&my_iface, &ring, 8));
+
+        pmt_rb_span_t spans[2];
+
+        assert(pmt_rb_peek_spans(&my_iface, &ring, spans) == 0);
+
+        for(int x = 0; x < 6; ++x) {
+                assert(pmt_rb_push_back(&my_iface, &ring, &x));
+        }
+
+        assert(pmt_rb_peek_spans(&my_iface, &ring, spans) == 1);
+        assert(spans[0].base == ring.buffer);
+        assert(spans[0].length == 6 * sizeof(int));
+
+        assert(pmt_rb_drop_front(&my_iface, &ring, 4));
+        assert(!pmt_rb_drop_front(&my_iface, &ring, 3));
+        assert(pmt_rb_size(&my_iface, &ring) == 2);
+
+        for(int x = 6; x < 10; ++x) {
+                assert(pmt_rb_push_back(&my_iface, &ring, &x));
+        }
+
+        assert(pmt_rb_peek_spans(&my_iface, &ring, spans) == 2);
+        assert(spans[0].base == ring.buffer + 4);
+        assert(spans[0].length == 4 * sizeof(int));
+        assert(spans[1].base == ring.buffer);
+        assert(spans[1].length == 2 * sizeof(int));
+
+        int out[6];
+        memcpy(out, spans[0].base, spans[0].length);
+        memcpy((char*)out + spans[0].length, spans[1].base, spans[1].length);
+        for(int x = 0; x < 6; ++x) {
+                assert(out[x] == x + 4);
+        }
+
+        pmt_rb_clear(&my_iface, &ring);
+        assert(pmt_rb_is_empty(&my_iface, &ring));
+        assert(pmt_rb_peek_spans(&my_iface, &ring, spans) == 0);
+
+        pmt_rb_destroy(&my_iface, &ring);
+}
+
+typedef struct my_small_ring {
+        size_t capacity, size;
+        int *buffer;
+        size_t head;
+        int inline_buffer[8];
+} my_small_ring_t;
+
+void *get_inline_buffer(void *ring)
+{
+        return ((my_small_ring_t*)ring)->inline_buffer;
+}
+
+size_t inline_capacity = 8;
+
+size_t get_inline_capacity(void *ring)
+{
+        return inline_capacity;
+}
+
+void test_inline()
+{
+        pmt_rb_iface_t small_iface = my_iface;
+        small_iface.array_iface.get_inline_buffer = get_inline_buffer;
+        small_iface.array_iface.get_inline_capacity = get_inline_capacity;
+
+        my_small_ring_t ring;
+
+        /* an inline capacity that is not a power of two is rejected */
+
+        inline_capacity = 6;
+        assert(!pmt_rb_create(&small_iface, &ring, 3));
+
+        inline_capacity = 8;
+        assert(pmt_rb_create(&small_iface, &ring, 3));
+        assert(ring.capacity == 8 && ring.buffer == ring.inline_buffer);
+
+        /* wrap within the inline region, then spill while wrapped */
+
+        int value = 0, front = 0;
+
+        for(; value < 6; ++value) {
+                assert(pmt_rb_push_back(&small_iface, &ring, &value));
+        }
+
+        for(; front < 4; ++front) {
+                int popped = -1;
+                assert(pmt_rb_pop_front(&small_iface, &ring, &popped));
+                assert(popped == front);
+        }
+
+        for(; value < 40; ++value) {
+                assert(pmt_rb_push_back(&small_iface, &ring, &value));
+        }
+
+        assert(ring.buffer != ring.inline_buffer);
+
+        for(size_t x = 0; x < pmt_rb_size(&small_iface, &ring); ++x) {
+                assert(*(int*)pmt_rb_at(&small_iface, &ring, x) ==
+                        front + (int)x);
+        }
+
+        pmt_rb_destroy(&small_iface, &ring);
+}
+
+int main(int argc, char **args)
+{
+        puts("testing - ring_buffer.c");
+
+        test_create_destroy();
+        test_push_back();
+        test_push_front();
+        test_pop();
+        test_wrapped_growth();
+        test_queue();
+        test_peek_spans();
+        test_inline();
+}
@@ -0,0 +1,283 @@
+#include "pubmt/segmented_deque.h"
+#include <stdio.h>
+#include <assert.h>
+#include <stdlib.h>
+
+typedef struct my_deque {
+        size_t capacity, size;
+        void **buffer;
+        size_t offset, length;
+} my_deque_t;
+
+void *get_buffer(void *deque)
+{
+        return ((my_deque_t*)deque)->buffer;
+}
+
+void set_buffer(void *deque, void *buffer)
+{
+        ((my_deque_t*)deque)->buffer = buffer;
+}
+
+size_t get_size(void *deque)
+{
+        return ((my_deque_t*)deque)->size;
+}
+
+void set_size(void *deque, const size_t size)
+{
+        ((my_deque_t*)deque)->size = size;
+}
+
+size_t get_capacity(void *deque)
+{
+        return ((my_deque_t*)deque)->capacity;
+}
+
+void set_capacity(void *deque, const size_t capacity)
+{
+        ((my_deque_t*)deque)->capacity = capacity;
+}
+
+size_t get_pointer_size(void *deque)
+{
+        return sizeof(void*);
+}
+
+size_t get_element_size(void *deque)
+{
+        return sizeof(int);
+}
+
+size_t get_block_length(void *deque)
+{
+        return 4;
+}
+
+size_t get_offset(void *deque)
+{
+        return ((my_deque_t*)deque)->offset;
+}
+
+void set_offset(void *deque, const size_t offset)
+{
+        ((my_deque_t*)deque)->offset = offset;
+}
+
+size_t get_length(void *deque)
+{
+        return ((my_deque_t*)deque)->length;
+}
+
+void set_length(void *deque, const size_t length)
+{
+        ((my_deque_t*)deque)->length = length;
+}
+
+void *my_alloc(const size_t nbytes, void *alloc_state)
+{
+        return malloc(nbytes);
+}
+
+void *my_realloc(void *pointer, const size_t nbytes, void *alloc_state)
+{
+        return realloc(pointer, nbytes);
+}
+
+void my_free(void *pointer, void *alloc_state)
+{
+        free(pointer);
+}
+
+pmt_da_alloc_t get_alloc(void *deque)
+{
+        return my_alloc;
+}
+
+pmt_da_realloc_t get_realloc(void *deque)
+{
+        return my_realloc;
+}
+
+pmt_da_free_t get_free(void *deque)
+{
+        return my_free;
+}
+
+void *get_alloc_state(void *deque)
+{
+        return NULL;
+}
+
+pmt_sd_iface_t my_iface = {
+        .get_element_size = get_element_size,
+        .get_block_length = get_block_length,
+        .get_offset = get_offset,
+        .set_offset = set_offset,
+        .get_length = get_length,
+        .set_length = set_length,
+        .array_iface = {
+                .get_alloc = get_alloc,
+                .get_realloc = get_realloc,
+                .get_alloc_state = get_alloc_state,
+                .get_free = get_free,
+                .get_buffer = get_buffer,
+                .set_buffer = set_buffer,
+                .get_capacity = get_capacity,
+                .set_capacity = set_capacity,
+                .get_size = get_size,
+                .set_size = set_size,
+                .get_element_size = get_pointer_size
+        }
+};
+
+void test_create_destroy()
+{
+        my_deque_t deque;
+        assert(pmt_sd_create(&my_iface, &deque, 4));
+        assert(deque.capacity == 4);
+        assert(deque.size == 0);
+        assert(deque.length == 0);
+        assert(pmt_sd_is_empty(&my_iface, &deque));
+        assert(!pmt_sd_first(&my_iface, &deque));
+        assert(!pmt_sd_last(&my_iface, &deque));
+        pmt_sd_destroy(&my_iface, &deque);
+}
+
+void test_push_back()
+{
+        my_deque_t deque;
+        assert(pmt_sd_create(&my_iface, &deque, 1));
+
+        int *pointers[100];
+
+        for(int x = 0; x < 100; ++x) {
+                pointers[x] = pmt_sd_push_back(&my_iface, &deque, &x);
+                assert(pointers[x] && *pointers[x] == x);
+        }
+
+        assert(pmt_sd_size(&my_iface, &deque) == 100);
+        assert(deque.size == 25);
+
+        for(int x = 0; x < 100; ++x) {
+                assert(pmt_sd_at(&my_iface, &deque, (size_t)x) == pointers[x]);
+                assert(*pointers[x] == x);
+        }
+
+        assert(!pmt_sd_at(&my_iface, &deque, 100));
+        assert(*(int*)pmt_sd_first(&my_iface, &deque) == 0);
+        assert(*(int*)pmt_sd_last(&my_iface, &deque) == 99);
+
+        pmt_sd_destroy(&my_iface, &deque);
+}
+
+void test_push_front()
+{
+        my_deque_t deque;
+        assert(pmt_sd_create(&my_iface, &deque, 1));
+
+        int *pointers[100];
+
+        for(int x = 0; x < 100; ++x) {
+                pointers[x] = pmt_sd_push_front(&my_iface, &deque, &x);
+                assert(pointers[x] && *pointers[x] == x);
+        }
+
+        for(int x = 0; x < 100; ++x) {
+                assert(*pointers[x] == x);
+                int *n = pmt_sd_at(&my_iface, &deque, (size_t)x);
+                assert(*n == 99 - x);
+        }
+
+        pmt_sd_destroy(&my_iface, &deque);
+}
+
+void test_pop()
+{
+        my_deque_t deque;
+        assert(pmt_sd_create(&my_iface, &deque, 2));
+
+        for(int x = 0; x < 50; ++x) {
+                assert(pmt_sd_push_back(&my_iface, &deque, &x));
+        }
+        for(int x = -1; x >= -50; --x) {
+                assert(pmt_sd_push_front(&my_iface, &deque, &x));
+        }
+
+        int value = 0;
+        for(int x = -50; x < 0; ++x) {
+                assert(pmt_sd_pop_front(&my_iface, &deque, &value));
+                assert(value == x);
+        }
+        for(int x = 49; x >= 0; --x) {
+                assert(pmt_sd_pop_back(&my_iface, &deque, &value));
+                assert(value == x);
+        }
+
+        assert(pmt_sd_is_empty(&my_iface, &deque));
+        assert(!pmt_sd_pop_back(&my_iface, &deque, &value));
+        assert(!pmt_sd_pop_front(&my_iface, &deque, &value));
+        assert(deque.size <= 2);
+
+        pmt_sd_destroy(&my_iface, &deque);
+}
+
+void test_queue()
+{
+        my_deque_t deque;
+        assert(pmt_sd_create(&my_iface, &deque, 2));
+
+        int next = 0, expect = 0, value = 0;
+
+        for(int x = 0; x < 10000; ++x) {
+                assert(pmt_sd_push_back(&my_iface, &deque, &next));
+                ++next;
+                assert(pmt_sd_push_back(&my_iface, &deque, &next));
+                ++next;
+                assert(pmt_sd_pop_front(&my_iface, &deque, &value));
+                assert(value == expect++);
+                if(pmt_sd_size(&my_iface, &deque) > 16) {
+                        while(!pmt_sd_is_empty(&my_iface, &deque)) {
+                                assert(pmt_sd_pop_front(
+                                        &my_iface, &deque, &value));
+                                assert(value == expect++);
+                        }
+                }
+        }
+
+        assert(deque.capacity <= 32);
+
+        pmt_sd_destroy(&my_iface, &deque);
+}
+
+void test_clear()
+{
+        my_deque_t deque;
+        assert(pmt_sd_create(&my_iface, &deque, 2));
+
+        for(int x = 0; x < 50; ++x) {
+                assert(pmt_sd_push_front(&my_iface, &deque, &x));
+        }
+
+        pmt_sd_clear(&my_iface, &deque);
+        assert(pmt_sd_is_empty(&my_iface, &deque));
+        assert(deque.size == 0);
+
+        int x = 7;
+        assert(pmt_sd_push_back(&my_iface, &deque, &x));
+        assert(*(int*)pmt_sd_first(&my_iface, &deque) == 7);
+
+        pmt_sd_destroy(&my_iface, &deque);
+}
+
+int main(int argc, char **args)
+{
+        puts("testing - segmented_deque.c");
+
+        test_create_destroy();
+        test_push_back();
+        test_push_front();
+        test_pop();
+        test_queue();
+        test_clear();
+}
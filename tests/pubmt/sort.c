@@ -0,0 +1,350 @@
+#include "pubmt/sort.h"
+#include <stdio.h>
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef struct my_array {
+        size_t capacity, size, element_size;
+        void *buffer;
+} my_array_t;
+
+void *get_buffer(void *array)
+{
+        return ((my_array_t*)array)->buffer;
+}
+
+void set_buffer(void *array, void *buffer)
+{
+        ((my_array_t*)array)->buffer = buffer;
+}
+
+size_t get_size(void *array)
+{
+        return ((my_array_t*)array)->size;
+}
+
+void set_size(void *array, const size_t size)
+{
+        ((my_array_t*)array)->size = size;
+}
+
+size_t get_capacity(void *array)
+{
+        return ((my_array_t*)array)->capacity;
+}
+
+void set_capacity(void *array, const size_t capacity)
+{
+        ((my_array_t*)array)->capacity = capacity;
+}
+
+size_t get_element_size(void *array)
+{
+        return ((my_array_t*)array)->element_size;
+}
+
+void *my_alloc(const size_t nbytes, void *alloc_state)
+{
+        return malloc(nbytes);
+}
+
+void *my_realloc(void *pointer, const size_t nbytes, void *alloc_state)
+{
+        return realloc(pointer, nbytes);
+}
+
+void my_free(void *pointer, void *alloc_state)
+{
+        free(pointer);
+}
+
+pmt_da_alloc_t get_alloc(void *array)
+{
+        return my_alloc;
+}
+
+pmt_da_realloc_t get_realloc(void *array)
+{
+        return my_realloc;
+}
+
+pmt_da_free_t get_free(void *array)
+{
+        return my_free;
+}
+
+void *get_alloc_state(void *array)
+{
+        return NULL;
+}
+
+pmt_da_iface_t my_iface = {
+        .get_alloc = get_alloc,
+        .get_realloc = get_realloc,
+        .get_alloc_state = get_alloc_state,
+        .get_free = get_free,
+        .get_buffer = get_buffer,
+        .set_buffer = set_buffer,
+        .get_capacity = get_capacity,
+        .set_capacity = set_capacity,
+        .get_size = get_size,
+        .set_size = set_size,
+        .get_element_size = get_element_size
+};
+
+typedef struct my_pair {
+        int key, seq;
+} my_pair_t;
+
+typedef struct my_wide {
+        int key;
+        char padding[300];
+} my_wide_t;
+
+bool int_less_than(void *a, void *b)
+{
+        return *(int*)a < *(int*)b;
+}
+
+bool double_less_than(void *a, void *b)
+{
+        return *(double*)a < *(double*)b;
+}
+
+int int_cmp(const void *a, const void *b)
+{
+        const int x = *(const int*)a, y = *(const int*)b;
+        return (x > y) - (x < y);
+}
+
+uint64_t int_key(void *element)
+{
+        return pmt_da_radix_i64(*(int*)element);
+}
+
+uint64_t pair_key(void *element)
+{
+        return pmt_da_radix_i64(((my_pair_t*)element)->key);
+}
+
+uint64_t double_key(void *element)
+{
+        return pmt_da_radix_f64(*(double*)element);
+}
+
+void make_ints(my_array_t *array, const size_t n, const int modulo)
+{
+        array->buffer = malloc(n * sizeof(int) + 1);
+        array->size = array->capacity = n;
+        array->element_size = sizeof(int);
+        int *ints = array->buffer;
+        for(size_t x = 0; x < n; ++x) {
+                ints[x] = rand() % modulo - modulo / 2;
+        }
+}
+
+bool is_sorted(int *ints, const size_t n)
+{
+        for(size_t x = 1; x < n; ++x) {
+                if(ints[x - 1] > ints[x]) {
+                        return false;
+                }
+        }
+        return true;
+}
+
+void test_sort()
+{
+        const size_t sizes[] = { 0, 1, 2, 3, 15, 16, 17, 100, 1000, 20000 };
+        const int modulos[] = { 1, 3, 1000, 1 << 30 };
+
+        for(size_t s = 0; s < sizeof(sizes) / sizeof(*sizes); ++s) {
+                for(size_t m = 0; m < sizeof(modulos) / sizeof(*modulos); ++m) {
+                        my_array_t array;
+                        make_ints(&array, sizes[s], modulos[m]);
+                        int *expect = malloc(sizes[s] * sizeof(int) + 1);
+                        memcpy(expect, array.buffer, sizes[s] * sizeof(int));
+                        qsort(expect, sizes[s], sizeof(int), int_cmp);
+
+                        pmt_da_sort(&my_iface, &array, int_less_than);
+                        assert(!memcmp(
+                                expect, array.buffer, sizes[s] * sizeof(int)));
+
+                        /* sorted and reversed inputs */
+                        pmt_da_sort(&my_iface, &array, int_less_than);
+                        assert(is_sorted(array.buffer, sizes[s]));
+                        int *ints = array.buffer;
+                        for(size_t x = 0; x < sizes[s] / 2; ++x) {
+                                int tmp = ints[x];
+                                ints[x] = ints[sizes[s] - x - 1];
+                                ints[sizes[s] - x - 1] = tmp;
+                        }
+                        pmt_da_sort(&my_iface, &array, int_less_than);
+                        assert(!memcmp(
+                                expect, array.buffer, sizes[s] * sizeof(int)));
+
+                        free(expect);
+                        free(array.buffer);
+                }
+        }
+}
+
+void test_sort_wide()
+{
+        my_wide_t *wides = malloc(sizeof(my_wide_t) * 500);
+        my_array_t array = { 
+                .buffer = wides,
+                .size = 500,
+                .capacity = 500,
+                .element_size = sizeof(my_wide_t) };
+
+        for(int x = 0; x < 500; ++x) {
+                wides[x].key = rand() % 100;
+                memset(wides[x].padding, wides[x].key, 300);
+        }
+
+        pmt_da_sort(&my_iface, &array, int_less_than);
+
+        for(int x = 0; x < 500; ++x) {
+                assert(x == 0 || wides[x - 1].key <= wides[x].key);
+                assert(wides[x].padding[299] == (char)wides[x].key);
+        }
+
+        for(int x = 0; x < 500; ++x) {
+                wides[x].key = rand() % 100;
+        }
+
+        assert(pmt_da_stable_sort(&my_iface, &array, int_less_than));
+
+        for(int x = 1; x < 500; ++x) {
+                assert(wides[x - 1].key <= wides[x].key);
+        }
+
+        free(wides);
+}
+
+void test_stable_sort()
+{
+        const size_t sizes[] = { 0, 1, 7, 16, 33, 1000, 5000 };
+
+        for(size_t s = 0; s < sizeof(sizes) / sizeof(*sizes); ++s) {
+                const size_t n = sizes[s];
+                my_pair_t *pairs = malloc(n * sizeof(my_pair_t) + 1);
+                for(size_t x = 0; x < n; ++x) {
+                        pairs[x].key = rand() % 10;
+                        pairs[x].seq = (int)x;
+                }
+                my_array_t array = { 
+                        .buffer = pairs,
+                        .size = n,
+                        .capacity = n,
+                        .element_size = sizeof(my_pair_t) };
+
+                assert(pmt_da_stable_sort(&my_iface, &array, int_less_than));
+
+                for(size_t x = 1; x < n; ++x) {
+                        assert(pairs[x - 1].key <= pairs[x].key);
+                        if(pairs[x - 1].key == pairs[x].key) {
+                                assert(pairs[x - 1].seq < pairs[x].seq);
+                        }
+                }
+
+                free(pairs);
+        }
+}
+
+void test_radix_sort()
+{
+        my_array_t array;
+        make_ints(&array, 10000, 1 << 30);
+        int *expect = malloc(10000 * sizeof(int));
+        memcpy(expect, array.buffer, 10000 * sizeof(int));
+        qsort(expect, 10000, sizeof(int), int_cmp);
+
+        assert(pmt_da_radix_sort(&my_iface, &array, int_key));
+        assert(!memcmp(expect, array.buffer, 10000 * sizeof(int)));
+
+        free(expect);
+        free(array.buffer);
+
+        my_pair_t pairs[1000];
+        for(int x = 0; x < 1000; ++x) {
+                pairs[x].key = rand() % 20 - 10;
+                pairs[x].seq = x;
+        }
+        array = (my_array_t){ 
+                .buffer = pairs,
+                .size = 1000,
+                .capacity = 1000,
+                .element_size = sizeof(my_pair_t) };
+        assert(pmt_da_radix_sort(&my_iface, &array, pair_key));
+        for(int x = 1; x < 1000; ++x) {
+                assert(pairs[x - 1].key <= pairs[x].key);
+                if(pairs[x - 1].key == pairs[x].key) {
+                        assert(pairs[x - 1].seq < pairs[x].seq);
+                }
+        }
+
+        double doubles[1000];
+        for(int x = 0; x < 1000; ++x) {
+                doubles[x] = (rand() % 2 ? -1.0 : 1.0) * rand() / 7.0;
+        }
+        doubles[0] = -1e300;
+        doubles[1] = 1e-300;
+        array = (my_array_t){ 
+                .buffer = doubles,
+                .size = 1000,
+                .capacity = 1000,
+                .element_size = sizeof(double) };
+        assert(pmt_da_radix_sort(&my_iface, &array, double_key));
+        for(int x = 1; x < 1000; ++x) {
+                assert(doubles[x - 1] <= doubles[x]);
+        }
+}
+
+void test_bounds()
+{
+        int ints[] = { 1, 2, 2, 2, 4, 4, 7, 9, 9, 12 };
+        my_array_t array = { 
+                .buffer = ints,
+                .size = 0,
+                .capacity = 10,
+                .element_size = sizeof(int) };
+
+        int key = 3;
+        assert(pmt_da_lower_bound(&my_iface, &array, &key, int_less_than) == 0);
+        assert(pmt_da_upper_bound(&my_iface, &array, &key, int_less_than) == 0);
+
+        for(size_t n = 1; n <= 10; ++n) {
+                array.size = n;
+                for(key = 0; key < 14; ++key) {
+                        size_t lower = 0, upper = 0;
+                        while(lower < n && ints[lower] < key) {
+                                ++lower;
+                        }
+                        while(upper < n && ints[upper] <= key) {
+                                ++upper;
+                        }
+                        assert(pmt_da_lower_bound(
+                                &my_iface, &array, &key, int_less_than) 
+                                        == lower);
+                        assert(pmt_da_upper_bound(
+                                &my_iface, &array, &key, int_less_than) 
+                                        == upper);
+                }
+        }
+}
+
+int main(int argc, char **args)
+{
+        puts("testing - sort.c");
+
+        srand(1);
+
+        test_sort();
+        test_sort_wide();
+        test_stable_sort();
+        test_radix_sort();
+        test_bounds();
+}
@@ -0,0 +1,158 @@
+#include "pubmt/spsc_queue.h"
+#include <stdio.h>
+#include <assert.h>
+#include <stdint.h>
+#include <pthread.h>
+
+void test_push_pop()
+{
+        pmt_spsc_queue_t queue;
+        int buffer[8];
+
+        assert(pmt_spsc_init(&queue, buffer, 8, sizeof(int)) == &queue);
+        assert(pmt_spsc_capacity(&queue) == 8);
+        assert(pmt_spsc_size(&queue) == 0);
+
+        int value = 0;
+        assert(!pmt_spsc_pop(&queue, &value));
+
+        for(int round = 0; round < 5; ++round) {
+                for(int x = 0; x < 8; ++x) {
+                        assert(pmt_spsc_push(&queue, &x));
+                }
+                assert(!pmt_spsc_push(&queue, &value));
+                assert(pmt_spsc_size(&queue) == 8);
+                for(int x = 0; x < 5; ++x) {
+                        assert(pmt_spsc_pop(&queue, &value));
+                        assert(value == x);
+                }
+                for(int x = 8; x < 13; ++x) {
+                        assert(pmt_spsc_push(&queue, &x));
+                }
+                for(int x = 5; x < 13; ++x) {
+                        assert(pmt_spsc_pop(&queue, &value));
+                        assert(value == x);
+                }
+                assert(!pmt_spsc_pop(&queue, NULL));
+        }
+}
+
+void test_batch()
+{
+        pmt_spsc_queue_t queue;
+        int buffer[16], in[40], out[40];
+
+        for(int x = 0; x < 40; ++x) {
+                in[x] = x;
+        }
+
+        pmt_spsc_init(&queue, buffer, 16, sizeof(int));
+
+        assert(pmt_spsc_enqueue(&queue, in, 10) == 10);
+        assert(pmt_spsc_dequeue(&queue, out, 7) == 7);
+        for(int x = 0; x < 7; ++x) {
+                assert(out[x] == x);
+        }
+
+        /* the next batch wraps around the end of the buffer */
+
+        assert(pmt_spsc_enqueue(&queue, in + 10, 30) == 13);
+        assert(pmt_spsc_size(&queue) == 16);
+        assert(pmt_spsc_enqueue(&queue, in, 1) == 0);
+
+        assert(pmt_spsc_dequeue(&queue, out, 40) == 16);
+        for(int x = 0; x < 16; ++x) {
+                assert(out[x] == x + 7);
+        }
+        assert(pmt_spsc_dequeue(&queue, out, 1) == 0);
+}
+
+typedef struct my_wide {
+        uint64_t value;
+        char pad[20];
+} my_wide_t;
+
+void test_element_size()
+{
+        pmt_spsc_queue_t queue;
+        my_wide_t buffer[4], in[6], out[6];
+
+        for(int x = 0; x < 6; ++x) {
+                in[x].value = (uint64_t)x * 3;
+        }
+
+        pmt_spsc_init(&queue, buffer, 4, sizeof(my_wide_t));
+
+        assert(pmt_spsc_enqueue(&queue, in, 3) == 3);
+        assert(pmt_spsc_dequeue(&queue, out, 2) == 2);
+        assert(pmt_spsc_enqueue(&queue, in + 3, 3) == 3);
+        assert(pmt_spsc_dequeue(&queue, out + 2, 4) == 4);
+
+        for(int x = 0; x < 6; ++x) {
+                assert(out[x].value == (uint64_t)x * 3);
+        }
+}
+
+#define MY_COUNT 1000000
+
+pmt_spsc_queue_t my_queue;
+uint32_t my_buffer[1024];
+
+void *my_producer(void *arg)
+{
+        uint32_t batch[37];
+        uint32_t next = 0;
+
+        while(next < MY_COUNT) {
+                size_t n = 0;
+                while(n < 37 && next + n < MY_COUNT) {
+                        batch[n] = next + (uint32_t)n;
+                        ++n;
+                }
+                size_t sent = 0;
+                while(sent < n) {
+                        sent += pmt_spsc_enqueue(
+                                &my_queue, batch + sent, n - sent);
+                }
+                next += (uint32_t)n;
+        }
+
+        return NULL;
+}
+
+void test_threads()
+{
+        pmt_spsc_init(&my_queue, my_buffer, 1024, sizeof(uint32_t));
+
+        pthread_t producer;
+        assert(pthread_create(&producer, NULL, my_producer, NULL) == 0);
+
+        uint32_t expect = 0, batch[64];
+
+        while(expect < MY_COUNT) {
+                uint32_t value;
+                if(expect % 3 == 0) {
+                        if(pmt_spsc_pop(&my_queue, &value)) {
+                                assert(value == expect++);
+                        }
+                        continue;
+                }
+                const size_t n = pmt_spsc_dequeue(&my_queue, batch, 64);
+                for(size_t x = 0; x < n; ++x) {
+                        assert(batch[x] == expect++);
+                }
+        }
+
+        assert(pthread_join(producer, NULL) == 0);
+        assert(pmt_spsc_size(&my_queue) == 0);
+}
+
+int main(int argc, char **args)
+{
+        puts("testing - spsc_queue.c");
+
+        test_push_pop();
+        test_batch();
+        test_element_size();
+        test_threads();
+}
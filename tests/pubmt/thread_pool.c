@@ -0,0 +1,161 @@
+#include "pubmt/thread_pool.h"
+#include <stdio.h>
+#include <assert.h>
+#include <stdlib.h>
+#include <stdint.h>
+
+void *my_alloc(const size_t nbytes, void *alloc_state)
+{
+        return malloc(nbytes);
+}
+
+void my_free(void *pointer, void *alloc_state)
+{
+        free(pointer);
+}
+
+atomic_size_t my_counter;
+
+void my_increment(void *arg)
+{
+        atomic_fetch_add(&my_counter, (size_t)(uintptr_t)arg);
+}
+
+void test_create_destroy()
+{
+        pmt_tp_pool_t pool;
+        assert(pmt_tp_create(&pool, 3, my_alloc, my_free, NULL) == &pool);
+        assert(pmt_tp_size(&pool) == 3);
+
+        /* workers fill whole cache lines and start on a line boundary */
+
+        assert(sizeof(pmt_tp_worker_t) == 2 * PMT_TP_CACHE_LINE);
+
+        for(size_t x = 0; x < 3; ++x) {
+                pmt_tp_worker_t *worker = pool.workers + x;
+                assert((uintptr_t)worker % PMT_TP_CACHE_LINE == 0);
+                assert((uint8_t*)&worker->bottom - (uint8_t*)&worker->top ==
+                        PMT_TP_CACHE_LINE);
+        }
+
+        pmt_tp_destroy(&pool);
+}
+
+void test_spawn()
+{
+        pmt_tp_pool_t pool;
+        assert(pmt_tp_create(&pool, 2, my_alloc, my_free, NULL));
+
+        /* more tasks than the injection queue holds */
+
+        const size_t ntasks = PMT_TP_INJECT_CAPACITY * 3;
+        pmt_tp_task_t *tasks = malloc(ntasks * sizeof(pmt_tp_task_t));
+        assert(tasks);
+
+        pmt_tp_group_t group;
+        assert(pmt_tp_group_init(&group) == &group);
+
+        atomic_store(&my_counter, 0);
+
+        for(size_t x = 0; x < ntasks; ++x) {
+                pmt_tp_spawn(
+                        &pool, &group, tasks + x, my_increment, (void*)2);
+        }
+
+        pmt_tp_wait(&pool, &group);
+        assert(atomic_load(&my_counter) == ntasks * 2);
+
+        /* an empty group does not block */
+
+        pmt_tp_wait(&pool, &group);
+
+        free(tasks);
+        pmt_tp_destroy(&pool);
+}
+
+#define MY_SIZE 100000
+
+unsigned char my_visited[MY_SIZE];
+
+void my_visit(const size_t begin, const size_t end, void *state)
+{
+        assert(begin < end && end <= MY_SIZE);
+        assert(end - begin <= *(size_t*)state);
+        for(size_t x = begin; x < end; ++x) {
+                ++my_visited[x];
+        }
+        atomic_fetch_add(&my_counter, end - begin);
+}
+
+void test_parallel_for()
+{
+        pmt_tp_pool_t pool;
+        assert(pmt_tp_create(&pool, 4, my_alloc, my_free, NULL));
+
+        const size_t grains[] = { 1, 7, 1000, MY_SIZE * 2 };
+
+        for(size_t g = 0; g < 4; ++g) {
+                size_t grain = grains[g];
+                for(size_t x = 0; x < MY_SIZE; ++x) {
+                        my_visited[x] = 0;
+                }
+                atomic_store(&my_counter, 0);
+                pmt_tp_parallel_for(
+                        &pool, 0, MY_SIZE, grain, my_visit, &grain);
+                assert(atomic_load(&my_counter) == MY_SIZE);
+                for(size_t x = 0; x < MY_SIZE; ++x) {
+                        assert(my_visited[x] == 1);
+                }
+        }
+
+        /* an empty range does nothing */
+
+        size_t grain = 1;
+        pmt_tp_parallel_for(&pool, 5, 5, 1, my_visit, &grain);
+
+        pmt_tp_destroy(&pool);
+}
+
+pmt_tp_pool_t my_pool;
+atomic_size_t my_sum;
+
+void my_sum_body(const size_t begin, const size_t end, void *state)
+{
+        size_t sum = 0;
+        for(size_t x = begin; x < end; ++x) {
+                sum += x;
+        }
+        atomic_fetch_add(&my_sum, sum);
+}
+
+void my_nested_body(const size_t begin, const size_t end, void *state)
+{
+        /* loops started from worker threads split over their deques */
+
+        for(size_t x = begin; x < end; ++x) {
+                pmt_tp_parallel_for(&my_pool, 0, 1000, 10, my_sum_body, NULL);
+        }
+}
+
+void test_nested()
+{
+        assert(pmt_tp_create(&my_pool, 3, my_alloc, my_free, NULL));
+
+        atomic_store(&my_sum, 0);
+
+        pmt_tp_parallel_for(&my_pool, 0, 64, 1, my_nested_body, NULL);
+
+        assert(atomic_load(&my_sum) == 64 * (999 * 1000 / 2));
+
+        pmt_tp_destroy(&my_pool);
+}
+
+int main(int argc, char **args)
+{
+        puts("testing - thread_pool.c");
+
+        test_create_destroy();
+        test_spawn();
+        test_parallel_for();
+        test_nested();
+}
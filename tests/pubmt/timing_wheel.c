@@ -0,0 +1,285 @@
+#include "pubmt/timing_wheel.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+
+typedef struct my_timer {
+
+        struct my_timer *next, *prev;
+
+        uint64_t expiry;
+
+        size_t slot;
+
+        /* test bookkeeping */
+        uint64_t fired_at;
+        int fired, period;
+
+} my_timer_t;
+
+void *get_next(void *timer)
+{
+        return ((my_timer_t*)timer)->next;
+}
+
+void set_next(void *timer, void *next)
+{
+        ((my_timer_t*)timer)->next = next;
+}
+
+void *get_prev(void *timer)
+{
+        return ((my_timer_t*)timer)->prev;
+}
+
+void set_prev(void *timer, void *prev)
+{
+        ((my_timer_t*)timer)->prev = prev;
+}
+
+uint64_t get_expiry(void *timer)
+{
+        return ((my_timer_t*)timer)->expiry;
+}
+
+void set_expiry(void *timer, const uint64_t expiry)
+{
+        ((my_timer_t*)timer)->expiry = expiry;
+}
+
+size_t get_slot(void *timer)
+{
+        return ((my_timer_t*)timer)->slot;
+}
+
+void set_slot(void *timer, const size_t slot)
+{
+        ((my_timer_t*)timer)->slot = slot;
+}
+
+pmt_tw_node_iface_t my_iface = {
+        .list_iface = {
+                .get_next = get_next,
+                .set_next = set_next
+        },
+        .get_prev = get_prev,
+        .set_prev = set_prev,
+        .get_expiry = get_expiry,
+        .set_expiry = set_expiry,
+        .get_slot = get_slot,
+        .set_slot = set_slot
+};
+
+typedef struct my_state {
+
+        pmt_tw_wheel_t *wheel;
+
+        /* the tick being advanced to and the last expiry seen */
+        uint64_t now, last;
+
+} my_state_t;
+
+void on_expire(void *timer, void *state)
+{
+        my_timer_t *t = timer;
+        my_state_t *s = state;
+
+        assert(!pmt_tw_is_scheduled(&my_iface, t));
+        assert(t->expiry <= s->now);
+        assert(t->expiry >= s->last);
+
+        s->last = t->expiry;
+        t->fired_at = s->now;
+        ++t->fired;
+
+        if(t->period) {
+                pmt_tw_schedule(
+                        &my_iface,
+                        s->wheel,
+                        t,
+                        t->expiry + (uint64_t)t->period);
+        }
+}
+
+size_t advance(my_state_t *state, uint64_t now)
+{
+        state->now = now;
+        return pmt_tw_advance(&my_iface, state->wheel, now, on_expire, state);
+}
+
+void test_basic()
+{
+        pmt_tw_wheel_t wheel;
+        pmt_tw_init(&my_iface, &wheel, 100);
+
+        my_state_t state = { .wheel = &wheel, .last = 0 };
+
+        uint64_t tick = 0;
+        assert(!pmt_tw_next_tick(&my_iface, &wheel, &tick));
+        assert(advance(&state, 1000) == 0);
+        assert(pmt_tw_now(&my_iface, &wheel) == 1000);
+
+        my_timer_t timers[6] = { 0 };
+        const uint64_t expiries[6] = {
+                1001, 1063, 1064, 5000, 1ULL << 50, UINT64_MAX
+        };
+
+        for(int x = 0; x < 6; ++x) {
+                pmt_tw_timer_init(&my_iface, timers + x);
+                assert(!pmt_tw_is_scheduled(&my_iface, timers + x));
+                pmt_tw_schedule(&my_iface, &wheel, timers + x, expiries[x]);
+                assert(pmt_tw_is_scheduled(&my_iface, timers + x));
+        }
+
+        assert(pmt_tw_size(&my_iface, &wheel) == 6);
+        assert(pmt_tw_next_tick(&my_iface, &wheel, &tick) && tick == 1001);
+
+        assert(advance(&state, 1000) == 0);
+        assert(advance(&state, 1001) == 1 && timers[0].fired_at == 1001);
+        assert(advance(&state, 1063) == 1 && timers[1].fired_at == 1063);
+
+        /* cancel and reschedule */
+
+        assert(pmt_tw_cancel(&my_iface, &wheel, timers + 2));
+        assert(!pmt_tw_cancel(&my_iface, &wheel, timers + 2));
+        pmt_tw_schedule(&my_iface, &wheel, timers + 3, 4000);
+        pmt_tw_schedule(&my_iface, &wheel, timers + 3, 3000);
+        assert(pmt_tw_size(&my_iface, &wheel) == 3);
+
+        assert(advance(&state, 2999) == 0);
+        assert(advance(&state, 1ULL << 49) == 1 && timers[3].fired_at == 1ULL << 49);
+        assert(timers[3].fired == 1);
+
+        /* a timer at or before the current tick is due on the next advance */
+
+        pmt_tw_schedule(&my_iface, &wheel, timers + 2, 10);
+        assert(pmt_tw_next_tick(&my_iface, &wheel, &tick) && tick == 1ULL << 49);
+        state.last = 0;
+        assert(advance(&state, 1ULL << 49) == 1 && timers[2].fired == 1);
+
+        state.last = 0;
+        assert(advance(&state, UINT64_MAX) == 2);
+        assert(timers[4].fired == 1 && timers[5].fired == 1);
+        assert(pmt_tw_size(&my_iface, &wheel) == 0);
+}
+
+#define NTIMERS 2000
+
+void test_random()
+{
+        pmt_tw_wheel_t wheel;
+        pmt_tw_init(&my_iface, &wheel, 0);
+
+        my_state_t state = { .wheel = &wheel, .last = 0 };
+
+        my_timer_t *timers = calloc(NTIMERS, sizeof(my_timer_t));
+
+        for(int x = 0; x < NTIMERS; ++x) {
+                pmt_tw_timer_init(&my_iface, timers + x);
+        }
+
+        uint64_t now = 0;
+        size_t scheduled = 0, expired = 0;
+
+        for(int round = 0; round < 5000; ++round) {
+
+                for(int n = 0; n < 4; ++n) {
+
+                        my_timer_t *timer = timers + rand() % NTIMERS;
+
+                        if(rand() % 5 == 0) {
+                                if(pmt_tw_cancel(&my_iface, &wheel, timer)) {
+                                        --scheduled;
+                                }
+                                continue;
+                        }
+
+                        /* a mix of near, far and very far expiries */
+
+                        const int range = rand() % 3;
+                        uint64_t delta = (uint64_t)(rand() % 200);
+
+                        if(range == 1) {
+                                delta = (uint64_t)rand() * 64;
+                        } else if(range == 2) {
+                                delta = (uint64_t)rand() << 24;
+                        }
+
+                        if(!pmt_tw_is_scheduled(&my_iface, timer)) {
+                                ++scheduled;
+                        }
+
+                        pmt_tw_schedule(&my_iface, &wheel, timer, now + delta);
+                }
+
+                assert(pmt_tw_size(&my_iface, &wheel) == scheduled);
+
+                uint64_t tick = 0;
+
+                if(pmt_tw_next_tick(&my_iface, &wheel, &tick)) {
+                        assert(tick >= now);
+                }
+
+                state.last = 0;
+                now += (uint64_t)(rand() % 100);
+
+                const size_t count = advance(&state, now);
+                expired += count;
+                scheduled -= count;
+
+                /* nothing left is overdue */
+
+                for(int x = 0; x < NTIMERS; ++x) {
+                        if(pmt_tw_is_scheduled(&my_iface, timers + x)) {
+                                assert(timers[x].expiry > now);
+                        }
+                }
+        }
+
+        state.last = 0;
+        expired += advance(&state, UINT64_MAX);
+        assert(pmt_tw_size(&my_iface, &wheel) == 0);
+
+        size_t fired = 0;
+
+        for(int x = 0; x < NTIMERS; ++x) {
+                assert(!pmt_tw_is_scheduled(&my_iface, timers + x));
+                fired += (size_t)timers[x].fired;
+        }
+
+        assert(fired == expired);
+
+        free(timers);
+}
+
+void test_periodic()
+{
+        pmt_tw_wheel_t wheel;
+        pmt_tw_init(&my_iface, &wheel, 0);
+
+        my_state_t state = { .wheel = &wheel, .last = 0 };
+
+        my_timer_t timer = { .period = 10 };
+        pmt_tw_timer_init(&my_iface, &timer);
+        pmt_tw_schedule(&my_iface, &wheel, &timer, 10);
+
+        /* the callback reschedules the timer within the same advance */
+
+        assert(advance(&state, 100000) == 10000);
+        assert(timer.fired == 10000);
+        assert(pmt_tw_is_scheduled(&my_iface, &timer));
+        assert(timer.expiry == 100010);
+
+        timer.period = 0;
+        assert(advance(&state, 100010) == 1);
+        assert(pmt_tw_size(&my_iface, &wheel) == 0);
+}
+
+int main(int argc, char **args)
+{
+        puts("testing - timing_wheel.c");
+
+        test_basic();
+        test_random();
+        test_periodic();
+}
@@ -0,0 +1,182 @@
+#include "pubmt/treiber_stack.h"
+#include <stdio.h>
+#include <assert.h>
+#include <stdlib.h>
+#include <pthread.h>
+
+typedef struct my_node {
+        int value;
+        atomic_int owned;
+        _Atomic(void*) next;
+} my_node_t;
+
+void *get_next(void *node)
+{
+        return atomic_load_explicit(
+                &((my_node_t*)node)->next,
+                memory_order_relaxed);
+}
+
+void set_next(void *node, void *next)
+{
+        atomic_store_explicit(
+                &((my_node_t*)node)->next,
+                next,
+                memory_order_relaxed);
+}
+
+pmt_ll_node_iface_t my_node_iface = {
+        .get_next = get_next,
+        .set_next = set_next
+};
+
+void test_push_pop()
+{
+        pmt_ts_stack_t stack;
+        my_node_t nodes[10];
+
+        assert(pmt_ts_init(&stack) == &stack);
+        assert(pmt_ts_is_empty(&stack));
+        assert(!pmt_ts_pop(&my_node_iface, &stack));
+
+        for(int x = 0; x < 10; ++x) {
+                nodes[x].value = x;
+                pmt_ts_push(&my_node_iface, &stack, nodes + x);
+                assert(!pmt_ts_is_empty(&stack));
+        }
+
+        for(int x = 9; x >= 0; --x) {
+                my_node_t *node = pmt_ts_pop(&my_node_iface, &stack);
+                assert(node == nodes + x);
+                assert(!get_next(node));
+        }
+
+        assert(pmt_ts_is_empty(&stack));
+        assert(!pmt_ts_pop(&my_node_iface, &stack));
+}
+
+void test_push_list()
+{
+        pmt_ts_stack_t stack;
+        my_node_t nodes[5];
+
+        pmt_ts_init(&stack);
+
+        pmt_ts_push(&my_node_iface, &stack, nodes + 4);
+
+        for(int x = 0; x < 3; ++x) {
+                set_next(nodes + x, nodes + x + 1);
+        }
+
+        pmt_ts_push_list(&my_node_iface, &stack, nodes, nodes + 3);
+
+        for(int x = 0; x < 5; ++x) {
+                assert(pmt_ts_pop(&my_node_iface, &stack) == nodes + x);
+        }
+
+        assert(!pmt_ts_pop(&my_node_iface, &stack));
+}
+
+void test_pop_all()
+{
+        pmt_ts_stack_t stack;
+        my_node_t nodes[4];
+
+        pmt_ts_init(&stack);
+
+        assert(!pmt_ts_pop_all(&stack));
+
+        for(int x = 0; x < 4; ++x) {
+                pmt_ts_push(&my_node_iface, &stack, nodes + x);
+        }
+
+        my_node_t *list = pmt_ts_pop_all(&stack);
+        assert(pmt_ts_is_empty(&stack));
+
+        for(int x = 3; x >= 0; --x) {
+                assert(list == nodes + x);
+                list = get_next(list);
+        }
+        assert(!list);
+}
+
+#define MY_THREADS 4
+#define MY_NODES 64
+#define MY_ROUNDS 100000
+
+pmt_ts_stack_t my_stack;
+my_node_t my_nodes[MY_NODES];
+
+void *my_recycler(void *arg)
+{
+        for(int x = 0; x < MY_ROUNDS; ++x) {
+                my_node_t *node = pmt_ts_pop(&my_node_iface, &my_stack);
+                if(!node) {
+                        continue;
+                }
+
+                /* no other thread may hold the node */
+
+                assert(!atomic_exchange(&node->owned, 1));
+                assert(atomic_exchange(&node->owned, 0));
+
+                if(x % 100 == 0) {
+                        my_node_t *list = pmt_ts_pop_all(&my_stack);
+                        pmt_ts_push(&my_node_iface, &my_stack, node);
+                        if(list) {
+                                my_node_t *last = list;
+                                while(get_next(last)) {
+                                        last = get_next(last);
+                                }
+                                pmt_ts_push_list(
+                                        &my_node_iface, &my_stack, list, last);
+                        }
+                } else {
+                        pmt_ts_push(&my_node_iface, &my_stack, node);
+                }
+        }
+
+        return NULL;
+}
+
+void test_threads()
+{
+        pmt_ts_init(&my_stack);
+
+        for(int x = 0; x < MY_NODES; ++x) {
+                my_nodes[x].value = x;
+                atomic_init(&my_nodes[x].owned, 0);
+                pmt_ts_push(&my_node_iface, &my_stack, my_nodes + x);
+        }
+
+        pthread_t threads[MY_THREADS];
+
+        for(int x = 0; x < MY_THREADS; ++x) {
+                assert(!pthread_create(threads + x, NULL, my_recycler, NULL));
+        }
+        for(int x = 0; x < MY_THREADS; ++x) {
+                assert(!pthread_join(threads[x], NULL));
+        }
+
+        int seen[MY_NODES] = { 0 };
+
+        my_node_t *node;
+        while((node = pmt_ts_pop(&my_node_iface, &my_stack))) {
+                assert(!seen[node->value]);
+                seen[node->value] = 1;
+        }
+
+        for(int x = 0; x < MY_NODES; ++x) {
+                assert(seen[x]);
+        }
+}
+
+int main(int argc, char **args)
+{
+        puts("testing - treiber_stack.c");
+
+        test_push_pop();
+        test_push_list();
+        test_pop_all();
+        test_threads();
+}